@@ -0,0 +1,647 @@
+/**
+ *  Broker.h
+ *
+ *  In-process stand-in for a RabbitMQ server, used by the benchmarks. It
+ *  listens on a loopback port, and speaks just enough AMQP 0-9-1 to drive
+ *  the client: the connection handshake, opening and closing channels,
+ *  declarations, confirm mode, and delivering messages to a consumer. It
+ *  is built from the same frame classes as the library itself.
+ *
+ *  Every connection is handled by a background thread with blocking I/O,
+ *  so that the client under test has the event loop to itself.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <amqpcpp.h>
+#include <thread>
+#include <atomic>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "includes.h"
+#include "heartbeatframe.h"
+#include "confirmselectframe.h"
+#include "confirmselectokframe.h"
+#include "connectionstartokframe.h"
+#include "connectionstartframe.h"
+#include "connectionsecureframe.h"
+#include "connectionsecureokframe.h"
+#include "connectionopenokframe.h"
+#include "connectionopenframe.h"
+#include "connectiontuneokframe.h"
+#include "connectiontuneframe.h"
+#include "connectioncloseokframe.h"
+#include "connectioncloseframe.h"
+#include "channelopenframe.h"
+#include "channelopenokframe.h"
+#include "channelflowokframe.h"
+#include "channelflowframe.h"
+#include "channelcloseokframe.h"
+#include "channelcloseframe.h"
+#include "exchangedeclareframe.h"
+#include "exchangedeclareokframe.h"
+#include "exchangedeleteframe.h"
+#include "exchangedeleteokframe.h"
+#include "exchangebindframe.h"
+#include "exchangebindokframe.h"
+#include "exchangeunbindframe.h"
+#include "exchangeunbindokframe.h"
+#include "queuedeclareframe.h"
+#include "queuedeclareokframe.h"
+#include "queuebindframe.h"
+#include "queuebindokframe.h"
+#include "queuepurgeframe.h"
+#include "queuepurgeokframe.h"
+#include "queuedeleteframe.h"
+#include "queuedeleteokframe.h"
+#include "queueunbindframe.h"
+#include "queueunbindokframe.h"
+#include "basicqosframe.h"
+#include "basicqosokframe.h"
+#include "basicconsumeframe.h"
+#include "basicconsumeokframe.h"
+#include "basiccancelframe.h"
+#include "basiccancelokframe.h"
+#include "basicpublishframe.h"
+#include "basicreturnframe.h"
+#include "basicdeliverframe.h"
+#include "basicgetframe.h"
+#include "basicgetokframe.h"
+#include "basicgetemptyframe.h"
+#include "basicackframe.h"
+#include "basicnackframe.h"
+#include "basicrejectframe.h"
+#include "basicrecoverasyncframe.h"
+#include "basicrecoverframe.h"
+#include "basicrecoverokframe.h"
+#include "transactionselectframe.h"
+#include "transactionselectokframe.h"
+#include "transactioncommitframe.h"
+#include "transactioncommitokframe.h"
+#include "transactionrollbackframe.h"
+#include "transactionrollbackokframe.h"
+#include "consumedmessage.h"
+#include "bodyframe.h"
+#include "basicheaderframe.h"
+
+/**
+ *  Class definition
+ */
+class Broker
+{
+private:
+    /**
+     *  A single connection from a client
+     */
+    class Session
+    {
+    private:
+        /**
+         *  Administration per channel
+         */
+        struct Channel
+        {
+            /**
+             *  Is the channel in confirm mode?
+             *  @var bool
+             */
+            bool confirm = false;
+
+            /**
+             *  Number of messages that were published
+             *  @var uint64_t
+             */
+            uint64_t published = 0;
+
+            /**
+             *  Number of body bytes that are still expected for the current message
+             *  @var uint64_t
+             */
+            uint64_t remaining = 0;
+        };
+
+        /**
+         *  The socket
+         *  @var int
+         */
+        int _socket;
+
+        /**
+         *  Number of messages to deliver to a consumer, and their size
+         *  @var size_t
+         */
+        size_t _count;
+        size_t _size;
+
+        /**
+         *  Max frame size
+         *  @var uint32_t
+         */
+        uint32_t _maxframe = 131072;
+
+        /**
+         *  Did we receive the protocol header?
+         *  @var bool
+         */
+        bool _started = false;
+
+        /**
+         *  Was the connection closed?
+         *  @var bool
+         */
+        bool _closed = false;
+
+        /**
+         *  Counter to generate queue names and consumer tags
+         *  @var size_t
+         */
+        size_t _generated = 0;
+
+        /**
+         *  Incoming data that was not yet processed
+         *  @var std::string
+         */
+        std::string _in;
+
+        /**
+         *  Outgoing data that was not yet written
+         *  @var std::string
+         */
+        std::string _out;
+
+        /**
+         *  The channels
+         *  @var std::unordered_map
+         */
+        std::unordered_map<uint16_t,Channel> _channels;
+
+        /**
+         *  Write all pending output to the socket
+         *  @return bool
+         */
+        bool flush()
+        {
+            // the number of bytes that were written
+            size_t written = 0;
+
+            // write until everything is gone
+            while (written < _out.size())
+            {
+                // write to the socket
+                auto result = ::write(_socket, _out.data() + written, _out.size() - written);
+
+                // stop on failure
+                if (result <= 0) return false;
+
+                // update administration
+                written += result;
+            }
+
+            // everything is gone
+            _out.clear();
+
+            // done
+            return true;
+        }
+
+        /**
+         *  Add a frame to the output
+         *  @param  frame
+         */
+        void send(const AMQP::Frame &frame)
+        {
+            // serialize the frame
+            AMQP::CopiedBuffer buffer(frame);
+
+            // append it to the output
+            _out.append(buffer.data(), buffer.size());
+
+            // do not let the output grow too big
+            if (_out.size() > 262144) flush();
+        }
+
+        /**
+         *  Deliver messages to a consumer
+         *  @param  channel
+         *  @param  tag
+         */
+        void deliver(uint16_t channel, const std::string &tag)
+        {
+            // the message body
+            std::string body(_size, 'x');
+
+            // the max size of the payload of a body frame
+            size_t chunk = _maxframe - 8;
+
+            // deliver the messages
+            for (size_t i = 1; i <= _count; ++i)
+            {
+                // the deliver and header frames
+                send(AMQP::BasicDeliverFrame(channel, tag, i, false, "", "bench"));
+                send(AMQP::BasicHeaderFrame(channel, AMQP::Envelope(body.data(), body.size())));
+
+                // and the body frames
+                for (size_t pos = 0; pos < body.size(); pos += chunk)
+                {
+                    // send the next part
+                    send(AMQP::BodyFrame(channel, body.data() + pos, std::min(chunk, body.size() - pos)));
+                }
+            }
+        }
+
+        /**
+         *  A message was completely published
+         *  @param  channel
+         */
+        void published(uint16_t channel)
+        {
+            // update the counter
+            auto &administration = _channels[channel];
+            administration.published += 1;
+
+            // in confirm mode, the message is acked
+            if (administration.confirm) send(AMQP::BasicAckFrame(channel, administration.published));
+        }
+
+        /**
+         *  Handle a method frame
+         *  @param  frame
+         */
+        void method(AMQP::ReceivedFrame &frame)
+        {
+            // the channel over which the frame was received
+            uint16_t channel = frame.channel();
+
+            // the class and method ids
+            uint16_t classID = frame.nextUint16();
+            uint16_t methodID = frame.nextUint16();
+
+            // check the class and method
+            switch ((classID << 16) | methodID)
+            {
+            case (10 << 16) | 11:
+                // start-ok, propose the tuning parameters
+                send(AMQP::ConnectionTuneFrame(2047, _maxframe, 0));
+                break;
+
+            case (10 << 16) | 31:
+                // tune-ok, the client could have picked a smaller frame size
+                _maxframe = std::min(_maxframe, AMQP::ConnectionTuneOKFrame(frame).frameMax());
+                break;
+
+            case (10 << 16) | 40:
+                // open
+                send(AMQP::ConnectionOpenOKFrame());
+                break;
+
+            case (10 << 16) | 50:
+                // close
+                send(AMQP::ConnectionCloseOKFrame());
+                _closed = true;
+                break;
+
+            case (20 << 16) | 10:
+                // channel open
+                _channels[channel] = Channel();
+                send(AMQP::ChannelOpenOKFrame(channel));
+                break;
+
+            case (20 << 16) | 40:
+                // channel close
+                _channels.erase(channel);
+                send(AMQP::ChannelCloseOKFrame(channel));
+                break;
+
+            case (40 << 16) | 10:
+                // exchange declare
+                if (!AMQP::ExchangeDeclareFrame(frame).noWait()) send(AMQP::ExchangeDeclareOKFrame(channel));
+                break;
+
+            case (50 << 16) | 10: {
+                // queue declare
+                AMQP::QueueDeclareFrame declare(frame);
+
+                // server-named queues get a generated name
+                std::string name = declare.name().empty() ? "amq.gen-" + std::to_string(++_generated) : declare.name();
+
+                // send the answer
+                if (!declare.noWait()) send(AMQP::QueueDeclareOKFrame(channel, name, 0, 0));
+                break;
+            }
+
+            case (50 << 16) | 20:
+                // queue bind
+                if (!AMQP::QueueBindFrame(frame).noWait()) send(AMQP::QueueBindOKFrame(channel));
+                break;
+
+            case (60 << 16) | 10:
+                // qos
+                send(AMQP::BasicQosOKFrame(channel));
+                break;
+
+            case (60 << 16) | 20: {
+                // consume
+                AMQP::BasicConsumeFrame consume(frame);
+
+                // consumers without a tag get a generated one
+                std::string tag = consume.consumerTag().empty() ? "amq.ctag-" + std::to_string(++_generated) : consume.consumerTag();
+
+                // send the answer, and start delivering
+                if (!consume.noWait()) send(AMQP::BasicConsumeOKFrame(channel, tag));
+                deliver(channel, tag);
+                break;
+            }
+
+            case (60 << 16) | 30: {
+                // cancel
+                AMQP::BasicCancelFrame cancel(frame);
+
+                // the frame wants a non-const tag
+                std::string tag = cancel.consumerTag();
+
+                // send the answer
+                if (!cancel.noWait()) send(AMQP::BasicCancelOKFrame(channel, tag));
+                break;
+            }
+
+            case (85 << 16) | 10:
+                // confirm select
+                _channels[channel].confirm = true;
+                if (!AMQP::ConfirmSelectFrame(frame).noWait()) send(AMQP::ConfirmSelectOKFrame(channel));
+                break;
+
+            default:
+                // publish, ack, reject and the rest do not need an answer
+                break;
+            }
+        }
+
+        /**
+         *  Handle a header frame
+         *  @param  frame
+         */
+        void header(AMQP::ReceivedFrame &frame)
+        {
+            // skip the class id and weight
+            frame.nextUint16();
+            frame.nextUint16();
+
+            // the size of the body that follows
+            uint64_t size = frame.nextUint64();
+
+            // messages without a body are complete
+            if (size == 0) published(frame.channel());
+
+            // otherwise we wait for the body frames
+            else _channels[frame.channel()].remaining = size;
+        }
+
+        /**
+         *  Handle a body frame
+         *  @param  frame
+         */
+        void body(AMQP::ReceivedFrame &frame)
+        {
+            // update the administration
+            auto &administration = _channels[frame.channel()];
+            administration.remaining -= std::min(administration.remaining, uint64_t(frame.payloadSize()));
+
+            // is the message complete?
+            if (administration.remaining == 0) published(frame.channel());
+        }
+
+        /**
+         *  Process the incoming data
+         *  @return bool        should we go on?
+         */
+        bool process()
+        {
+            // number of bytes processed
+            size_t processed = 0;
+
+            // the connection starts with a protocol header
+            if (!_started)
+            {
+                // wait until the full header is in
+                if (_in.size() < 8) return true;
+
+                // it is the only thing we have to say in this version of the protocol
+                send(AMQP::ConnectionStartFrame(0, 9, AMQP::Table(), "PLAIN", "en_US"));
+
+                // header has been processed
+                processed = 8;
+                _started = true;
+            }
+
+            // process all complete frames
+            while (!_closed && _in.size() - processed >= 8)
+            {
+                // parse the frame
+                AMQP::ReceivedFrame frame(_in.data() + processed, _in.size() - processed, _maxframe);
+
+                // wait for more data if the frame is not yet complete
+                if (!frame.complete()) break;
+
+                // check the frame type
+                switch (_in[processed])
+                {
+                    case 1: method(frame); break;
+                    case 2: header(frame); break;
+                    case 3: body(frame); break;
+                }
+
+                // the frame was processed
+                processed += frame.totalSize();
+            }
+
+            // remove the processed data
+            _in.erase(0, processed);
+
+            // send out the answers
+            return flush() && !_closed;
+        }
+
+    public:
+        /**
+         *  Constructor
+         *  @param  socket      the connected socket
+         *  @param  count       number of messages to deliver to a consumer
+         *  @param  size        size of the delivered messages
+         */
+        Session(int socket, size_t count, size_t size) : _socket(socket), _count(count), _size(size) {}
+
+        /**
+         *  Handle the connection until it is closed
+         */
+        void run()
+        {
+            // buffer to read into
+            char buffer[65536];
+
+            // keep reading
+            while (true)
+            {
+                // read from the socket
+                auto result = ::read(_socket, buffer, sizeof(buffer));
+
+                // stop when the connection is gone
+                if (result <= 0) return;
+
+                // add to the buffer
+                _in.append(buffer, result);
+
+                // process the data
+                if (!process()) return;
+            }
+        }
+    };
+
+    /**
+     *  The listening socket
+     *  @var int
+     */
+    int _socket;
+
+    /**
+     *  The port number
+     *  @var uint16_t
+     */
+    uint16_t _port = 0;
+
+    /**
+     *  Number of messages to deliver to a consumer, and their size
+     *  @var std::atomic<size_t>
+     */
+    std::atomic<size_t> _count;
+    std::atomic<size_t> _size;
+
+    /**
+     *  The thread that accepts and handles the connections
+     *  @var std::thread
+     */
+    std::thread _thread;
+
+    /**
+     *  Accept and handle connections, one after the other
+     */
+    void run()
+    {
+        // keep accepting connections
+        while (true)
+        {
+            // accept the next connection
+            int socket = accept(_socket, nullptr, nullptr);
+
+            // stop when the listening socket is shut down
+            if (socket < 0) return;
+
+            // the answers should be sent right away
+            int optval = 1;
+            setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof(int));
+
+            // handle the connection
+            Session(socket, _count, _size).run();
+
+            // done with the connection
+            ::close(socket);
+        }
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @throws std::runtime_error
+     */
+    Broker() : _count(0), _size(0)
+    {
+        // create the socket
+        _socket = socket(AF_INET, SOCK_STREAM, 0);
+
+        // check for failure
+        if (_socket < 0) throw std::runtime_error(strerror(errno));
+
+        // bind to a free port on the loopback interface
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        // the size of the address
+        socklen_t size = sizeof(address);
+
+        // bind and listen, and find out the port number
+        if (bind(_socket, (struct sockaddr *)&address, size) < 0 || listen(_socket, 16) < 0 || getsockname(_socket, (struct sockaddr *)&address, &size) < 0)
+        {
+            // remember the error
+            std::string error(strerror(errno));
+
+            // clean up
+            ::close(_socket);
+
+            // report the failure
+            throw std::runtime_error(error);
+        }
+
+        // store the port
+        _port = ntohs(address.sin_port);
+
+        // start accepting connections
+        std::thread thread(std::bind(&Broker::run, this));
+        _thread.swap(thread);
+    }
+
+    /**
+     *  No copying
+     *  @param  that
+     */
+    Broker(const Broker &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~Broker()
+    {
+        // wake up the thread that is blocked in accept()
+        shutdown(_socket, SHUT_RDWR);
+
+        // wait for it
+        _thread.join();
+
+        // close the socket
+        ::close(_socket);
+    }
+
+    /**
+     *  The address that clients should connect to
+     *  @return AMQP::Address
+     */
+    AMQP::Address address() const
+    {
+        // construct the address
+        return AMQP::Address("127.0.0.1", _port, AMQP::Login("guest", "guest"), "/");
+    }
+
+    /**
+     *  Set the number of messages that are delivered to the next consumers
+     *  @param  count
+     *  @param  size
+     */
+    void deliver(size_t count, size_t size)
+    {
+        // store the settings
+        _count = count;
+        _size = size;
+    }
+};
@@ -0,0 +1,496 @@
+/**
+ *  Codec.cpp
+ *
+ *  Micro-benchmarks for the frame codec. A corpus of frames that look like
+ *  real-world traffic is fed to Connection::parse() (with a handler that
+ *  discards all output), and messages are published to measure how fast
+ *  frames are encoded. For every case the time and the number of heap
+ *  allocations per frame are reported.
+ *
+ *  Usage: amqpcpp_bench_codec [benchmark ...]
+ *
+ *  Available benchmarks: deliver-0, deliver-10, deliver-50, deliver-nested,
+ *  deliver-properties, deliver-large, deliver-streamed, and the publish-*
+ *  counterparts of most of them (all of them if none are given).
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Dependencies
+ */
+#include <amqpcpp.h>
+#include "includes.h"
+#include "heartbeatframe.h"
+#include "confirmselectframe.h"
+#include "confirmselectokframe.h"
+#include "connectionstartokframe.h"
+#include "connectionstartframe.h"
+#include "connectionsecureframe.h"
+#include "connectionsecureokframe.h"
+#include "connectionopenokframe.h"
+#include "connectionopenframe.h"
+#include "connectiontuneokframe.h"
+#include "connectiontuneframe.h"
+#include "connectioncloseokframe.h"
+#include "connectioncloseframe.h"
+#include "channelopenframe.h"
+#include "channelopenokframe.h"
+#include "channelflowokframe.h"
+#include "channelflowframe.h"
+#include "channelcloseokframe.h"
+#include "channelcloseframe.h"
+#include "exchangedeclareframe.h"
+#include "exchangedeclareokframe.h"
+#include "exchangedeleteframe.h"
+#include "exchangedeleteokframe.h"
+#include "exchangebindframe.h"
+#include "exchangebindokframe.h"
+#include "exchangeunbindframe.h"
+#include "exchangeunbindokframe.h"
+#include "queuedeclareframe.h"
+#include "queuedeclareokframe.h"
+#include "queuebindframe.h"
+#include "queuebindokframe.h"
+#include "queuepurgeframe.h"
+#include "queuepurgeokframe.h"
+#include "queuedeleteframe.h"
+#include "queuedeleteokframe.h"
+#include "queueunbindframe.h"
+#include "queueunbindokframe.h"
+#include "basicqosframe.h"
+#include "basicqosokframe.h"
+#include "basicconsumeframe.h"
+#include "basicconsumeokframe.h"
+#include "basiccancelframe.h"
+#include "basiccancelokframe.h"
+#include "basicpublishframe.h"
+#include "basicreturnframe.h"
+#include "basicdeliverframe.h"
+#include "basicgetframe.h"
+#include "basicgetokframe.h"
+#include "basicgetemptyframe.h"
+#include "basicackframe.h"
+#include "basicnackframe.h"
+#include "basicrejectframe.h"
+#include "basicrecoverasyncframe.h"
+#include "basicrecoverframe.h"
+#include "basicrecoverokframe.h"
+#include "transactionselectframe.h"
+#include "transactionselectokframe.h"
+#include "transactioncommitframe.h"
+#include "transactioncommitokframe.h"
+#include "transactionrollbackframe.h"
+#include "transactionrollbackokframe.h"
+#include "consumedmessage.h"
+#include "bodyframe.h"
+#include "basicheaderframe.h"
+#include "bodyframe.h"
+#include "result.h"
+#include <chrono>
+#include <iostream>
+#include <new>
+#include <algorithm>
+
+/**
+ *  Number of heap allocations so far
+ *  @var size_t
+ */
+static size_t allocations = 0;
+
+/**
+ *  Replacements for the global allocation functions, so that we can count the allocations
+ *  @param  size
+ *  @return void*
+ */
+void *operator new(size_t size)
+{
+    // count the allocation
+    allocations += 1;
+
+    // allocate the memory
+    if (void *result = malloc(size ? size : 1)) return result;
+
+    // out of memory
+    throw std::bad_alloc();
+}
+
+/**
+ *  Release memory
+ *  @param  pointer
+ */
+void operator delete(void *pointer) noexcept
+{
+    free(pointer);
+}
+
+/**
+ *  Release memory (sized variant)
+ *  @param  pointer
+ *  @param  size
+ */
+void operator delete(void *pointer, size_t size) noexcept
+{
+    free(pointer);
+}
+
+/**
+ *  The clock that is used for the measurements
+ */
+using Clock = std::chrono::steady_clock;
+
+/**
+ *  Handler that discards all output
+ */
+class NullHandler : public AMQP::ConnectionHandler
+{
+private:
+    /**
+     *  Method that is called when data needs to be sent over the network
+     *  @param  connection
+     *  @param  buffer
+     *  @param  size
+     */
+    virtual void onData(AMQP::Connection *connection, const char *buffer, size_t size) override {}
+};
+
+/**
+ *  Append a serialized frame to a buffer
+ *  @param  buffer
+ *  @param  frame
+ */
+static void append(std::string &buffer, const AMQP::Frame &frame)
+{
+    // serialize the frame
+    AMQP::CopiedBuffer copy(frame);
+
+    // add to the buffer
+    buffer.append(copy.data(), copy.size());
+}
+
+/**
+ *  Pass a buffer to a connection
+ *  @param  connection
+ *  @param  buffer
+ */
+static void parse(AMQP::Connection &connection, const std::string &buffer)
+{
+    // keep going until everything has been processed
+    for (size_t processed = 0; processed < buffer.size(); )
+    {
+        // parse the data
+        auto result = connection.parse(buffer.data() + processed, buffer.size() - processed);
+
+        // stop if nothing could be processed
+        if (result == 0) throw std::runtime_error("data could not be parsed");
+
+        // update the administration
+        processed += result;
+    }
+}
+
+/**
+ *  Repeat an operation until enough time has passed
+ *  @param  name        name of the benchmark
+ *  @param  frames      number of frames that are handled per call
+ *  @param  operation   the operation to measure
+ *  @return Result
+ */
+static Result measure(const char *name, size_t frames, const std::function<void()> &operation)
+{
+    // warm up
+    operation();
+
+    // the number of calls, and the allocation counter at the start
+    size_t calls = 0;
+    size_t allocated = allocations;
+
+    // the start time
+    auto start = Clock::now();
+    auto stop = start;
+
+    // repeat until enough time has passed
+    while (stop - start < std::chrono::milliseconds(500))
+    {
+        // do the operation a number of times (so that we do not read the clock too often)
+        for (size_t i = 0; i < 16; ++i) operation();
+
+        // update the administration
+        calls += 16;
+        stop = Clock::now();
+    }
+
+    // the total number of frames
+    double total = double(calls) * frames;
+
+    // report the result
+    return Result(name)
+        .add("frames", total)
+        .add("ns_per_frame", std::chrono::duration<double, std::nano>(stop - start).count() / total)
+        .add("allocations_per_frame", (allocations - allocated) / total);
+}
+
+/**
+ *  A table with a number of headers of mixed types
+ *  @param  count
+ *  @return AMQP::Table
+ */
+static AMQP::Table headers(size_t count)
+{
+    // the result
+    AMQP::Table table;
+
+    // add the headers
+    for (size_t i = 0; i < count; ++i)
+    {
+        // the name of the header
+        std::string name = "x-header-" + std::to_string(i);
+
+        // mix strings, numbers and booleans
+        switch (i % 3)
+        {
+            case 0: table.set(name, "value-" + std::to_string(i)); break;
+            case 1: table.set(name, int64_t(i * 1000)); break;
+            case 2: table.set(name, bool(i % 2)); break;
+        }
+    }
+
+    // done
+    return table;
+}
+
+/**
+ *  Headers with nested arrays and tables, like the ones added by dead-lettering
+ *  @return AMQP::Table
+ */
+static AMQP::Table nested()
+{
+    // the array with the dead-letter history
+    AMQP::Array deaths;
+
+    // add a number of entries
+    for (size_t i = 0; i < 5; ++i)
+    {
+        // the routing keys
+        AMQP::Array keys;
+        keys.push_back(AMQP::LongString("key-" + std::to_string(i)));
+        keys.push_back(AMQP::LongString("other-" + std::to_string(i)));
+
+        // a single entry
+        AMQP::Table death;
+        death.set("count", int64_t(i + 1));
+        death.set("reason", "expired");
+        death.set("queue", "queue-" + std::to_string(i));
+        death.set("time", AMQP::Timestamp(1600000000 + i));
+        death.set("exchange", "exchange");
+        death.set("routing-keys", keys);
+
+        // add to the list
+        deaths.push_back(death);
+    }
+
+    // the headers
+    AMQP::Table table;
+    table.set("x-death", deaths);
+    table.set("x-first-death-reason", "expired");
+    table.set("x-first-death-queue", "queue-0");
+
+    // done
+    return table;
+}
+
+/**
+ *  An envelope with all properties set
+ *  @param  envelope
+ */
+static void properties(AMQP::Envelope &envelope)
+{
+    // set all properties
+    envelope.setContentType("application/json");
+    envelope.setContentEncoding("utf-8");
+    envelope.setDeliveryMode(2);
+    envelope.setPriority(5);
+    envelope.setCorrelationID("c3d7e2a0-5f0e-4c1b-9f0a-6d2b1e4a7c90");
+    envelope.setReplyTo("amq.rabbitmq.reply-to");
+    envelope.setExpiration("60000");
+    envelope.setMessageID("0f8e2b7a-1c4d-4e6f-8a9b-3c5d7e9f1a2b");
+    envelope.setTimestamp(1600000000);
+    envelope.setTypeName("order.created");
+    envelope.setUserID("guest");
+    envelope.setAppID("bench");
+}
+
+/**
+ *  Benchmark for parsing deliveries
+ *  @param  name        name of the benchmark
+ *  @param  size        size of the message body
+ *  @param  prepare     function to set the properties of the message
+ *  @param  tag         the consumer tag
+ *  @param  routingkey  the routing key of the messages
+ *  @param  streamed    consume the messages as streams
+ *  @return Result
+ */
+static Result deliver(const char *name, size_t size, const std::function<void(AMQP::Envelope &)> &prepare, const std::string &tag = "bench", const std::string &routingkey = "routing.key", bool streamed = false)
+{
+    // set up a connection that discards its output
+    NullHandler handler;
+    AMQP::Connection connection(&handler);
+
+    // do the handshake
+    std::string handshake;
+    append(handshake, AMQP::ConnectionStartFrame(0, 9, AMQP::Table(), "PLAIN", "en_US"));
+    append(handshake, AMQP::ConnectionTuneFrame(2047, 131072, 0));
+    append(handshake, AMQP::ConnectionOpenOKFrame());
+    parse(connection, handshake);
+
+    // create a channel with a consumer
+    AMQP::Channel channel(&connection);
+    size_t received = 0;
+    auto &consumer = channel.consume("bench", tag);
+
+    // install the callback for complete messages, or for streams
+    if (!streamed) consumer.onReceived([&received](const AMQP::Message &message, uint64_t deliveryTag, bool redelivered) { received += 1; });
+    else consumer.onMessageStream([&received](AMQP::MessageStream &stream) { stream.onComplete([&received]() { received += 1; }); });
+
+    // open the channel and start the consumer
+    std::string setup;
+    append(setup, AMQP::ChannelOpenOKFrame(1));
+    append(setup, AMQP::BasicConsumeOKFrame(1, tag));
+    parse(connection, setup);
+
+    // the message
+    std::string body(size, 'x');
+    AMQP::Envelope envelope(body.data(), body.size());
+    prepare(envelope);
+
+    // the corpus holds a number of messages
+    std::string corpus;
+    size_t frames = 0;
+    size_t count = size > 65536 ? 4 : 64;
+
+    // construct the corpus
+    for (size_t i = 0; i < count; ++i)
+    {
+        // the deliver and header frames
+        append(corpus, AMQP::BasicDeliverFrame(1, tag, i + 1, false, "exchange", routingkey));
+        append(corpus, AMQP::BasicHeaderFrame(1, envelope));
+        frames += 2;
+
+        // the body frames
+        for (size_t pos = 0; pos < size; pos += 131064, ++frames) append(corpus, AMQP::BodyFrame(1, body.data() + pos, std::min(size_t(131064), size - pos)));
+    }
+
+    // measure parsing the corpus
+    auto result = measure(name, frames, [&]() { parse(connection, corpus); });
+
+    // check that the messages did arrive
+    if (received == 0) throw std::runtime_error("no messages were received");
+
+    // done
+    return result;
+}
+
+/**
+ *  Benchmark for encoding messages
+ *  @param  name        name of the benchmark
+ *  @param  size        size of the message body
+ *  @param  prepare     function to set the properties of the message
+ *  @return Result
+ */
+static Result publish(const char *name, size_t size, const std::function<void(AMQP::Envelope &)> &prepare)
+{
+    // set up a connection that discards its output
+    NullHandler handler;
+    AMQP::Connection connection(&handler);
+
+    // do the handshake
+    std::string handshake;
+    append(handshake, AMQP::ConnectionStartFrame(0, 9, AMQP::Table(), "PLAIN", "en_US"));
+    append(handshake, AMQP::ConnectionTuneFrame(2047, 131072, 0));
+    append(handshake, AMQP::ConnectionOpenOKFrame());
+    parse(connection, handshake);
+
+    // create the channel
+    AMQP::Channel channel(&connection);
+
+    // open the channel
+    std::string setup;
+    append(setup, AMQP::ChannelOpenOKFrame(1));
+    parse(connection, setup);
+
+    // the message
+    std::string body(size, 'x');
+    AMQP::Envelope envelope(body.data(), body.size());
+    prepare(envelope);
+
+    // number of frames per message
+    size_t frames = 2 + (size + 131063) / 131064;
+
+    // measure publishing the message
+    return measure(name, frames, [&]() { channel.publish("exchange", "routing.key", envelope); });
+}
+
+/**
+ *  Main procedure
+ *  @param  argc
+ *  @param  argv
+ *  @return int
+ */
+int main(int argc, const char *argv[])
+{
+    // the benchmarks to run
+    std::vector<std::string> benchmarks(argv + 1, argv + argc);
+
+    // functions to prepare envelopes
+    auto plain = [](AMQP::Envelope &envelope) {};
+    auto headers10 = [](AMQP::Envelope &envelope) { envelope.setHeaders(headers(10)); };
+    auto headers50 = [](AMQP::Envelope &envelope) { envelope.setHeaders(headers(50)); };
+    auto complex = [](AMQP::Envelope &envelope) { envelope.setHeaders(nested()); };
+    auto full = [](AMQP::Envelope &envelope) { properties(envelope); envelope.setHeaders(headers(10)); };
+    auto encoded = [](AMQP::Envelope &envelope) { envelope.setHeaders(AMQP::TableEncoder(headers(10))); };
+
+    // all benchmarks
+    std::vector<std::pair<std::string,std::function<Result()>>> all = {
+        { "deliver-0",          [&]() { return deliver("deliver-0", 128, plain); } },
+        { "deliver-10",         [&]() { return deliver("deliver-10", 128, headers10); } },
+        { "deliver-50",         [&]() { return deliver("deliver-50", 128, headers50); } },
+        { "deliver-nested",     [&]() { return deliver("deliver-nested", 128, complex); } },
+        { "deliver-properties", [&]() { return deliver("deliver-properties", 128, full); } },
+        { "deliver-large",      [&]() { return deliver("deliver-large", 1048576, plain); } },
+        { "deliver-streamed",   [&]() { return deliver("deliver-streamed", 1048576, plain, "bench", "routing.key", true); } },
+        { "deliver-routed",     [&]() { return deliver("deliver-routed", 128, plain, "amq.ctag-Xq3v1kM9dT2pW7bN4cR8yA", "orders.eu-west.created.priority-high"); } },
+        { "publish-0",          [&]() { return publish("publish-0", 128, plain); } },
+        { "publish-10",         [&]() { return publish("publish-10", 128, headers10); } },
+        { "publish-encoded",    [&]() { return publish("publish-encoded", 128, encoded); } },
+        { "publish-50",         [&]() { return publish("publish-50", 128, headers50); } },
+        { "publish-nested",     [&]() { return publish("publish-nested", 128, complex); } },
+        { "publish-properties", [&]() { return publish("publish-properties", 128, full); } },
+        { "publish-large",      [&]() { return publish("publish-large", 1048576, plain); } },
+    };
+
+    // prevent exceptions
+    try
+    {
+        // run the selected benchmarks
+        for (const auto &benchmark : all)
+        {
+            // skip benchmarks that were not selected
+            if (!benchmarks.empty() && std::find(benchmarks.begin(), benchmarks.end(), benchmark.first) == benchmarks.end()) continue;
+
+            // run it
+            std::cout << benchmark.second() << std::endl;
+        }
+    }
+    catch (const std::runtime_error &error)
+    {
+        // report the error
+        std::cerr << "error: " << error.what() << std::endl;
+
+        // failure
+        return 1;
+    }
+
+    // done
+    return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ *  Loop.h
+ *
+ *  Minimal poll() based event loop for the benchmarks, so that they do
+ *  not depend on libev, libuv, libevent or boost.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <amqpcpp.h>
+#include <amqpcpp/linux_tcp.h>
+#include <poll.h>
+#include <map>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+
+/**
+ *  Class definition
+ */
+class Loop : public AMQP::TcpHandler
+{
+private:
+    /**
+     *  The monitored filedescriptors, and the events to watch for
+     *  @var std::map<int,int>
+     */
+    std::map<int,int> _fds;
+
+    /**
+     *  Is the loop running?
+     *  @var bool
+     */
+    bool _running = false;
+
+    /**
+     *  The error that stopped the loop
+     *  @var std::string
+     */
+    std::string _error;
+
+    /**
+     *  Monitor a filedescriptor
+     *  @param  connection
+     *  @param  fd
+     *  @param  flags
+     */
+    virtual void monitor(AMQP::TcpConnection *connection, int fd, int flags) override
+    {
+        // register or forget the filedescriptor
+        if (flags == 0) _fds.erase(fd);
+        else _fds[fd] = flags;
+    }
+
+    /**
+     *  Method that is called when the connection fails
+     *  @param  connection
+     *  @param  message
+     */
+    virtual void onError(AMQP::TcpConnection *connection, const char *message) override
+    {
+        // remember the error, and stop
+        _error = message;
+        _running = false;
+    }
+
+    /**
+     *  Method that is called when the connection is no longer in use
+     *  @param  connection
+     */
+    virtual void onDetached(AMQP::TcpConnection *connection) override
+    {
+        // nothing left to do
+        _running = false;
+    }
+
+public:
+    /**
+     *  Run the loop until it is stopped
+     *
+     *  The optional callback is called on every iteration, as long as it
+     *  returns true the loop does not block waiting for events.
+     *
+     *  @param  connection      the connection to drive
+     *  @param  callback        callback to call on every iteration
+     *  @throws std::runtime_error
+     */
+    void run(AMQP::TcpConnection &connection, const std::function<bool()> &callback = nullptr)
+    {
+        // we are running
+        _running = true;
+
+        // the filedescriptors to poll
+        std::vector<struct pollfd> fds;
+
+        // keep going
+        while (_running)
+        {
+            // give the callback a chance to do some work
+            bool busy = callback && callback();
+
+            // the callback could have stopped the loop
+            if (!_running) break;
+
+            // construct the poll set
+            fds.clear();
+            for (const auto &fd : _fds) fds.push_back({ fd.first, short(((fd.second & AMQP::readable) ? POLLIN : 0) | ((fd.second & AMQP::writable) ? POLLOUT : 0)), 0 });
+
+            // wait for activity
+            if (poll(fds.data(), fds.size(), busy ? 0 : 1000) < 0) throw std::runtime_error(strerror(errno));
+
+            // process the active filedescriptors
+            for (const auto &fd : fds)
+            {
+                // skip inactive ones
+                if (fd.revents == 0) continue;
+
+                // pass on to the connection
+                connection.process(fd.fd, ((fd.revents & (POLLIN | POLLHUP | POLLERR)) ? AMQP::readable : 0) | ((fd.revents & POLLOUT) ? AMQP::writable : 0));
+            }
+        }
+
+        // report errors
+        if (!_error.empty()) throw std::runtime_error(_error);
+    }
+
+    /**
+     *  Stop the loop
+     */
+    void stop()
+    {
+        _running = false;
+    }
+};
@@ -0,0 +1,507 @@
+/**
+ *  Loopback.cpp
+ *
+ *  Benchmarks for the full client stack (channels, connection, and the
+ *  linux_tcp layer) against an in-process broker on a loopback socket.
+ *
+ *  Usage: amqpcpp_bench_loopback [--count N] [--size N] [benchmark ...]
+ *
+ *  Available benchmarks: publish, consume, confirm, large-publish,
+ *  streamed-publish, large-consume, declare, declare-pipelined and channels
+ *  (all of them if none are given).
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Dependencies
+ */
+#include "broker.h"
+#include "loop.h"
+#include "result.h"
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+/**
+ *  The clock that is used for the measurements
+ */
+using Clock = std::chrono::steady_clock;
+
+/**
+ *  Number of seconds between two points in time
+ *  @param  start
+ *  @param  stop
+ *  @return double
+ */
+static double seconds(Clock::time_point start, Clock::time_point stop)
+{
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+/**
+ *  Close a connection and wait until it is done
+ *  @param  loop
+ *  @param  connection
+ */
+static void close(Loop &loop, AMQP::TcpConnection &connection)
+{
+    // start the closing handshake
+    connection.close();
+
+    // run until the connection is detached
+    loop.run(connection);
+}
+
+/**
+ *  Measure the throughput of publishing messages
+ *  @param  broker      the broker to connect to
+ *  @param  name        name of the benchmark
+ *  @param  count       number of messages
+ *  @param  size        size of the messages
+ *  @return Result
+ */
+static Result publish(Broker &broker, const char *name, size_t count, size_t size)
+{
+    // set up the connection
+    Loop loop;
+    AMQP::TcpConnection connection(&loop, broker.address());
+    AMQP::TcpChannel channel(&connection);
+
+    // the message to publish
+    std::string body(size, 'x');
+
+    // administration
+    size_t published = 0;
+    bool ready = false;
+    Clock::time_point start, stop;
+
+    // wait for the channel to be ready
+    channel.onReady([&]() {
+
+        // start the clock
+        ready = true;
+        start = Clock::now();
+    });
+
+    // publish as long as the outgoing buffer does not grow too big
+    loop.run(connection, [&]() -> bool {
+
+        // nothing to do if not yet ready, or if all messages were published
+        if (!ready || published == count) return false;
+
+        // publish messages
+        while (published < count && connection.queued() < 4 * 1024 * 1024)
+        {
+            // publish the next message
+            channel.publish("", "bench", body);
+            published += 1;
+        }
+
+        // are we not yet done?
+        if (published < count) return true;
+
+        // the answer to a declaration arrives after the server processed all messages
+        channel.declareQueue("bench").onSuccess([&]() {
+
+            // stop the clock
+            stop = Clock::now();
+            loop.stop();
+        });
+
+        // we're no longer busy
+        return false;
+    });
+
+    // close the connection
+    close(loop, connection);
+
+    // report the result
+    return Result(name)
+        .add("messages", count)
+        .add("size", size)
+        .add("seconds", seconds(start, stop))
+        .add("messages_per_second", count / seconds(start, stop))
+        .add("megabytes_per_second", count * size / seconds(start, stop) / 1048576.0);
+}
+
+/**
+ *  Measure the throughput of publishing messages of which the body is produced
+ *  while they are sent, and the size of the outgoing buffer
+ *  @param  broker      the broker to connect to
+ *  @param  count       number of messages
+ *  @param  size        size of the messages
+ *  @return Result
+ */
+static Result streamed(Broker &broker, size_t count, size_t size)
+{
+    // set up the connection
+    Loop loop;
+    AMQP::TcpConnection connection(&loop, broker.address());
+    AMQP::TcpChannel channel(&connection);
+
+    // the biggest outgoing buffer that we have seen
+    size_t peak = 0;
+
+    // administration
+    Clock::time_point start, stop;
+
+    // wait for the channel to be ready
+    channel.onReady([&]() {
+
+        // start the clock
+        start = Clock::now();
+
+        // the properties of the messages
+        AMQP::Envelope metadata(nullptr, 0);
+
+        // publish all messages, they are sent one after the other
+        for (size_t i = 0; i < count; ++i) channel.publish("", "bench", metadata, size, [&](char *buffer, size_t size) -> size_t {
+
+            // check the outgoing buffer
+            peak = std::max(peak, connection.queued());
+
+            // produce the data
+            memset(buffer, 'x', size);
+            return size;
+        });
+
+        // the answer to a declaration arrives after the server processed all messages
+        channel.declareQueue("bench").onSuccess([&]() {
+
+            // stop the clock
+            stop = Clock::now();
+            loop.stop();
+        });
+    });
+
+    // run the event loop
+    loop.run(connection);
+
+    // close the connection
+    close(loop, connection);
+
+    // report the result
+    return Result("streamed-publish")
+        .add("messages", count)
+        .add("size", size)
+        .add("seconds", seconds(start, stop))
+        .add("messages_per_second", count / seconds(start, stop))
+        .add("megabytes_per_second", count * size / seconds(start, stop) / 1048576.0)
+        .add("peak_queued_bytes", peak);
+}
+
+/**
+ *  Measure the throughput of consuming messages
+ *  @param  broker      the broker to connect to
+ *  @param  name        name of the benchmark
+ *  @param  count       number of messages
+ *  @param  size        size of the messages
+ *  @return Result
+ */
+static Result consume(Broker &broker, const char *name, size_t count, size_t size)
+{
+    // tell the broker what to deliver
+    broker.deliver(count, size);
+
+    // set up the connection
+    Loop loop;
+    AMQP::TcpConnection connection(&loop, broker.address());
+    AMQP::TcpChannel channel(&connection);
+
+    // administration
+    size_t received = 0;
+    Clock::time_point start, stop;
+
+    // start consuming
+    channel.consume("bench", AMQP::noack)
+        .onSuccess([&]() {
+
+            // start the clock
+            start = Clock::now();
+        })
+        .onReceived([&](const AMQP::Message &message, uint64_t deliveryTag, bool redelivered) {
+
+            // wait for the last message
+            if (++received < count) return;
+
+            // stop the clock
+            stop = Clock::now();
+            loop.stop();
+        });
+
+    // run until all messages are in
+    loop.run(connection);
+
+    // close the connection
+    close(loop, connection);
+
+    // report the result
+    return Result(name)
+        .add("messages", count)
+        .add("size", size)
+        .add("seconds", seconds(start, stop))
+        .add("messages_per_second", count / seconds(start, stop))
+        .add("megabytes_per_second", count * size / seconds(start, stop) / 1048576.0);
+}
+
+/**
+ *  Measure the round-trip time of publisher confirms (one message at a time)
+ *  @param  broker      the broker to connect to
+ *  @param  count       number of messages
+ *  @param  size        size of the messages
+ *  @return Result
+ */
+static Result confirm(Broker &broker, size_t count, size_t size)
+{
+    // set up the connection
+    Loop loop;
+    AMQP::TcpConnection connection(&loop, broker.address());
+    AMQP::TcpChannel channel(&connection);
+
+    // the message to publish
+    std::string body(size, 'x');
+
+    // the measured latencies, and the time when the last message was sent
+    std::vector<double> latencies;
+    Clock::time_point sent, start, stop;
+
+    // function to publish the next message
+    auto next = [&]() {
+
+        // remember when it was sent
+        sent = Clock::now();
+        channel.publish("", "bench", body);
+    };
+
+    // put the channel in confirm mode
+    channel.confirmSelect()
+        .onSuccess([&]() {
+
+            // start publishing
+            start = Clock::now();
+            next();
+        })
+        .onAck([&](uint64_t deliveryTag, bool multiple) {
+
+            // store the latency
+            latencies.push_back(seconds(sent, Clock::now()) * 1000000.0);
+
+            // publish the next message
+            if (latencies.size() < count) return next();
+
+            // stop the clock
+            stop = Clock::now();
+            loop.stop();
+        });
+
+    // run until all messages are confirmed
+    loop.run(connection);
+
+    // close the connection
+    close(loop, connection);
+
+    // sort the latencies to find the percentiles
+    std::sort(latencies.begin(), latencies.end());
+
+    // report the result
+    return Result("confirm")
+        .add("messages", count)
+        .add("size", size)
+        .add("seconds", seconds(start, stop))
+        .add("p50_us", latencies[latencies.size() / 2])
+        .add("p99_us", latencies[latencies.size() * 99 / 100])
+        .add("max_us", latencies.back());
+}
+
+/**
+ *  Measure how fast a topology can be declared
+ *  @param  broker      the broker to connect to
+ *  @param  name        name of the benchmark
+ *  @param  count       number of queues to declare and bind
+ *  @param  pipelined   should the channel be in pipelined mode?
+ *  @return Result
+ */
+static Result declare(Broker &broker, const char *name, size_t count, bool pipelined)
+{
+    // set up the connection
+    Loop loop;
+    AMQP::TcpConnection connection(&loop, broker.address());
+    AMQP::TcpChannel channel(&connection);
+
+    // set the mode
+    channel.pipelined(pipelined);
+
+    // administration
+    size_t bound = 0;
+    Clock::time_point start, stop;
+
+    // wait for the channel to be ready
+    channel.onReady([&]() {
+
+        // start the clock
+        start = Clock::now();
+
+        // declare the exchange
+        channel.declareExchange("bench", AMQP::topic);
+
+        // declare and bind the queues
+        for (size_t i = 0; i < count; ++i)
+        {
+            // the name of the queue
+            std::string queue = "bench-" + std::to_string(i);
+
+            // declare and bind it
+            channel.declareQueue(queue);
+            channel.bindQueue("bench", queue, queue).onSuccess([&]() {
+
+                // wait for the last one
+                if (++bound < count) return;
+
+                // stop the clock
+                stop = Clock::now();
+                loop.stop();
+            });
+        }
+    });
+
+    // run until everything is declared
+    loop.run(connection);
+
+    // close the connection
+    close(loop, connection);
+
+    // report the result
+    return Result(name)
+        .add("queues", count)
+        .add("seconds", seconds(start, stop))
+        .add("operations_per_second", (2 * count + 1) / seconds(start, stop));
+}
+
+/**
+ *  Measure how fast channels can be opened and closed
+ *  @param  broker      the broker to connect to
+ *  @param  count       number of channels
+ *  @return Result
+ */
+static Result channels(Broker &broker, size_t count)
+{
+    // set up the connection
+    Loop loop;
+    AMQP::TcpConnection connection(&loop, broker.address());
+
+    // the current channel
+    std::unique_ptr<AMQP::TcpChannel> channel;
+
+    // administration
+    size_t closed = 0;
+    bool busy = false;
+    Clock::time_point start = Clock::now(), stop;
+
+    // open and close channels one after the other
+    loop.run(connection, [&]() -> bool {
+
+        // wait for the previous channel
+        if (busy) return false;
+
+        // are we done?
+        if (closed == count)
+        {
+            // stop the clock
+            stop = Clock::now();
+            loop.stop();
+            return false;
+        }
+
+        // create the next channel, and close it when it is ready
+        busy = true;
+        channel.reset(new AMQP::TcpChannel(&connection));
+        channel->onReady([&]() {
+
+            // close the channel again
+            channel->close().onSuccess([&]() {
+
+                // the next channel can be opened
+                closed += 1;
+                busy = false;
+            });
+        });
+
+        // the channel is not ready yet
+        return false;
+    });
+
+    // get rid of the last channel
+    channel.reset();
+
+    // close the connection
+    close(loop, connection);
+
+    // report the result
+    return Result("channels")
+        .add("channels", count)
+        .add("seconds", seconds(start, stop))
+        .add("channels_per_second", count / seconds(start, stop));
+}
+
+/**
+ *  Main procedure
+ *  @param  argc
+ *  @param  argv
+ *  @return int
+ */
+int main(int argc, const char *argv[])
+{
+    // overrides for the number of messages and their size
+    size_t count = 0, size = 0;
+
+    // the benchmarks to run
+    std::vector<std::string> benchmarks;
+
+    // parse the arguments
+    for (int i = 1; i < argc; ++i)
+    {
+        // check the options
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) count = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) size = strtoul(argv[++i], nullptr, 10);
+        else benchmarks.push_back(argv[i]);
+    }
+
+    // run everything by default
+    if (benchmarks.empty()) benchmarks = { "publish", "consume", "confirm", "large-publish", "streamed-publish", "large-consume", "declare", "declare-pipelined", "channels" };
+
+    // prevent exceptions
+    try
+    {
+        // start the broker
+        Broker broker;
+
+        // run the benchmarks
+        for (const auto &benchmark : benchmarks)
+        {
+            // check which one
+            if (benchmark == "publish") std::cout << publish(broker, "publish", count ? count : 200000, size ? size : 128) << std::endl;
+            else if (benchmark == "consume") std::cout << consume(broker, "consume", count ? count : 200000, size ? size : 128) << std::endl;
+            else if (benchmark == "confirm") std::cout << confirm(broker, count ? count : 20000, size ? size : 128) << std::endl;
+            else if (benchmark == "large-publish") std::cout << publish(broker, "large-publish", count ? count : 200, size ? size : 1048576) << std::endl;
+            else if (benchmark == "streamed-publish") std::cout << streamed(broker, count ? count : 200, size ? size : 1048576) << std::endl;
+            else if (benchmark == "large-consume") std::cout << consume(broker, "large-consume", count ? count : 200, size ? size : 1048576) << std::endl;
+            else if (benchmark == "declare") std::cout << declare(broker, "declare", count ? count : 10000, false) << std::endl;
+            else if (benchmark == "declare-pipelined") std::cout << declare(broker, "declare-pipelined", count ? count : 10000, true) << std::endl;
+            else if (benchmark == "channels") std::cout << channels(broker, count ? count : 10000) << std::endl;
+            else std::cerr << "unknown benchmark: " << benchmark << std::endl;
+        }
+    }
+    catch (const std::runtime_error &error)
+    {
+        // report the error
+        std::cerr << "error: " << error.what() << std::endl;
+
+        // failure
+        return 1;
+    }
+
+    // done
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ *  Result.h
+ *
+ *  The outcome of a single benchmark. Results are written as one JSON
+ *  object per line, so that they can be collected and compared by scripts.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <string>
+#include <vector>
+#include <utility>
+#include <ostream>
+#include <iomanip>
+
+/**
+ *  Class definition
+ */
+class Result
+{
+private:
+    /**
+     *  Name of the benchmark
+     *  @var std::string
+     */
+    std::string _name;
+
+    /**
+     *  The measured values
+     *  @var std::vector
+     */
+    std::vector<std::pair<std::string,double>> _values;
+
+public:
+    /**
+     *  Constructor
+     *  @param  name
+     */
+    Result(std::string name) : _name(std::move(name)) {}
+
+    /**
+     *  Add a value
+     *  @param  key
+     *  @param  value
+     *  @return Result
+     */
+    Result &add(const std::string &key, double value)
+    {
+        // store the value
+        _values.emplace_back(key, value);
+
+        // allow chaining
+        return *this;
+    }
+
+    /**
+     *  Write the result to a stream
+     *  @param  stream
+     *  @param  result
+     *  @return std::ostream
+     */
+    friend std::ostream &operator<<(std::ostream &stream, const Result &result)
+    {
+        // the name
+        stream << "{\"benchmark\":\"" << result._name << "\"";
+
+        // and the values
+        for (const auto &value : result._values) stream << ",\"" << value.first << "\":" << std::setprecision(12) << value.second;
+
+        // done
+        return stream << "}";
+    }
+};
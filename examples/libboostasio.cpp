@@ -1,7 +1,7 @@
 /**
  *  LibBoostAsio.cpp
  * 
- *  Test program to check AMQP functionality based on Boost's asio io_service.
+ *  Test program to check AMQP functionality based on Boost's asio io_context.
  * 
  *  @author Gavin Smith <gavin.smith@coralbay.tv>
  *
@@ -11,9 +11,7 @@
 /**
  *  Dependencies
  */
-#include <boost/asio/io_service.hpp>
-#include <boost/asio/strand.hpp>
-#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/io_context.hpp>
 
 
 #include <amqpcpp.h>
@@ -28,7 +26,7 @@ int main()
 
     // access to the boost asio handler
     // note: we suggest use of 2 threads - normally one is fin (we are simply demonstrating thread safety).
-    boost::asio::io_service service(4);
+    boost::asio::io_context service(4);
 
     // handler for libev
     AMQP::LibBoostAsioHandler handler(service);
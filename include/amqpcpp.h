@@ -45,21 +45,27 @@
 #include "amqpcpp/outbuffer.h"
 #include "amqpcpp/watchable.h"
 #include "amqpcpp/monitor.h"
+#include "amqpcpp/stats.h"
+#include "amqpcpp/tracer.h"
 
 // amqp types
 #include "amqpcpp/field.h"
 #include "amqpcpp/numericfield.h"
 #include "amqpcpp/decimalfield.h"
+#include "amqpcpp/stringview.h"
 #include "amqpcpp/stringfield.h"
 #include "amqpcpp/booleanset.h"
 #include "amqpcpp/fieldproxy.h"
 #include "amqpcpp/table.h"
 #include "amqpcpp/array.h"
+#include "amqpcpp/fieldview.h"
+#include "amqpcpp/tableencoder.h"
 
 // envelope for publishing and consuming
 #include "amqpcpp/metadata.h"
 #include "amqpcpp/envelope.h"
 #include "amqpcpp/message.h"
+#include "amqpcpp/messagestream.h"
 
 // mid level includes
 #include "amqpcpp/exchangetype.h"
@@ -77,6 +83,7 @@
 #include "amqpcpp/channel.h"
 #include "amqpcpp/login.h"
 #include "amqpcpp/address.h"
+#include "amqpcpp/addresses.h"
 #include "amqpcpp/connectionhandler.h"
 #include "amqpcpp/connectionimpl.h"
 #include "amqpcpp/connection.h"
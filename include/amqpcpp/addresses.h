@@ -41,17 +41,20 @@ public:
         // keep looping
         while (true)
         {
+            // skip leading whitespace
+            while (size > 0 && *buffer == ' ') { ++buffer; --size; }
+            
             // look for the comma
-            const char *comma = memchr(buffer, ',', size);
+            const char *comma = (const char *)memchr(buffer, ',', size);
             
             // stop if there is no comma
             if (comma == nullptr) break;
             
             // size of the address
-            size_t addresssize = comma - buffer - 1;
+            size_t addresssize = comma - buffer;
             
-            // add address
-            _addresses.emplace_back(buffer, addresssize);
+            // add address (empty entries are ignored)
+            if (addresssize > 0) _addresses.emplace_back(buffer, addresssize);
             
             // update for next iteration
             buffer += addresssize + 1;
@@ -68,6 +71,37 @@ public:
         throw std::runtime_error("no addresses");
     }
 
+    /**
+     *  Constructor for a comma separated list in a null terminated string
+     *  @param  addresses
+     *  @throws std::runtime_error
+     */
+    Addresses(const char *addresses) : Addresses(addresses, strlen(addresses)) {}
+
+    /**
+     *  Constructor for a comma separated list in a std::string
+     *  @param  addresses
+     *  @throws std::runtime_error
+     */
+    Addresses(const std::string &addresses) : Addresses(addresses.data(), addresses.size()) {}
+
+    /**
+     *  Constructor for a single address
+     *  @param  address
+     */
+    Addresses(const Address &address) : _addresses({ address }) {}
+
+    /**
+     *  Constructor for a list of addresses
+     *  @param  addresses
+     *  @throws std::runtime_error
+     */
+    Addresses(std::vector<Address> addresses) : _addresses(std::move(addresses))
+    {
+        // was anything passed?
+        if (_addresses.empty()) throw std::runtime_error("no addresses");
+    }
+
     /**
      *  Destructed
      */
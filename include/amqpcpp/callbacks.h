@@ -26,7 +26,10 @@ namespace AMQP {
  *  Forward declarations
  */
 class Message;
+class MessageStream;
 class MetaData;
+class StringView;
+class FieldView;
 
 /**
  *  Generic callbacks that are used by many deferred objects
@@ -60,6 +63,7 @@ using CancelCallback        =   std::function<void(const std::string &consumer)>
  */
 using StartCallback         =   std::function<void(const std::string &exchange, const std::string &routingkey)>;
 using HeaderCallback        =   std::function<void(const MetaData &metaData)>;
+using FieldCallback         =   std::function<void(const StringView &name, const FieldView &value)>;
 using DataCallback          =   std::function<void(const char *data, size_t size)>;
 using DeliveredCallback     =   std::function<void(uint64_t deliveryTag, bool redelivered)>;
 
@@ -76,6 +80,7 @@ using ReturnedCallback      =   std::function<void()>;
  *  implement callbacks that return the collected message.
  */
 using MessageCallback       =   std::function<void(const Message &message, uint64_t deliveryTag, bool redelivered)>;
+using MessageStreamCallback =   std::function<void(MessageStream &stream)>;
 using BounceCallback        =   std::function<void(const Message &message, int16_t code, const std::string &description)>;
 
 /**
@@ -85,6 +90,19 @@ using BounceCallback        =   std::function<void(const Message &message, int16
 using AckCallback           =   std::function<void(uint64_t deliveryTag, bool multiple)>;
 using NackCallback          =   std::function<void(uint64_t deliveryTag, bool multiple, bool requeue)>;
 
+/**
+ *  When a message is published from a producer, the producer is called to fill a
+ *  buffer with the next part of the body. It returns the number of bytes that it
+ *  wrote, which is zero if the body could not be produced.
+ */
+using ProduceCallback       =   std::function<size_t(char *buffer, size_t size)>;
+
+/**
+ *  Called when too much data is waiting to be sent (active is true), and when
+ *  enough of it was sent to start producing again (active is false)
+ */
+using BackpressureCallback  =   std::function<void(bool active)>;
+
 /**
  *  End namespace
  */
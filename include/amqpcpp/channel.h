@@ -95,6 +95,48 @@ public:
         _implementation->onError(callback);
     }
 
+    /**
+     *  Callback that is called when backpressure starts (active is true) or
+     *  ends (active is false). There is backpressure when the frames that the
+     *  channel has queued reach the high watermark (see watermarks()), until
+     *  they have drained to the low watermark, and while the server has asked
+     *  to stop sending messages with a channel.flow frame. You should stop
+     *  publishing on the channel while there is backpressure.
+     *
+     *  Only one callback can be registered. Calling this function multiple
+     *  times will remove the old callback.
+     *
+     *  @param  callback    the callback to execute
+     */
+    void onBackpressure(const BackpressureCallback &callback)
+    {
+        _implementation->onBackpressure(callback);
+    }
+
+    /**
+     *  Set the watermarks for the number of bytes that the channel has queued
+     *  (frames are queued while the channel waits for the answer to a
+     *  synchronous instruction, or while it sends the body of a message that
+     *  is published from a producer). A high watermark of zero, which is the
+     *  default, turns the check off.
+     *
+     *  @param  high        number of bytes at which backpressure starts
+     *  @param  low         number of bytes at which it ends
+     */
+    void watermarks(size_t high, size_t low)
+    {
+        _implementation->watermarks(high, low);
+    }
+
+    /**
+     *  Is there backpressure on the channel?
+     *  @return bool
+     */
+    bool backpressure() const
+    {
+        return _implementation->backpressure();
+    }
+
     /**
      *  Pause deliveries on a channel
      *
@@ -153,6 +195,60 @@ public:
         return usable();
     }
 
+    /**
+     *  Turn pipelined mode on or off
+     *
+     *  By default, the channel waits for the answer to every synchronous
+     *  instruction before it sends out the next one. In pipelined mode,
+     *  instructions that declare, bind, unbind, purge or delete exchanges
+     *  and queues are sent back-to-back, without waiting for the answers
+     *  to earlier ones (the server still handles them in order, and the
+     *  answers are passed to the deferred objects in that same order).
+     *  This makes setting up a large topology much faster, especially on
+     *  connections with a high latency. Other synchronous instructions
+     *  (like consume, get, qos and transactions) are still serialized.
+     *
+     *  Keep in mind that if one of the pipelined instructions fails, the
+     *  server closes the channel, and all instructions that were sent after
+     *  it fail too.
+     *
+     *  @param  enabled
+     */
+    void pipelined(bool enabled)
+    {
+        _implementation->pipelined(enabled);
+    }
+
+    /**
+     *  Is the channel in pipelined mode?
+     *  @return bool
+     */
+    bool pipelined() const
+    {
+        return _implementation->pipelined();
+    }
+
+    /**
+     *  Start collecting statistics for this channel. These are also counted
+     *  in the statistics of the connection (if it collects them), so you
+     *  only need this to tell the channels of a connection apart. Pass a
+     *  nullptr to stop collecting statistics.
+     *  @param  stats
+     */
+    void stats(const std::shared_ptr<Stats> &stats)
+    {
+        _implementation->stats(stats);
+    }
+
+    /**
+     *  The statistics that are collected (nullptr if they are not collected)
+     *  @return std::shared_ptr<Stats>
+     */
+    const std::shared_ptr<Stats> &stats() const
+    {
+        return _implementation->stats();
+    }
+
     /**
      *  Put channel in a confirm mode (RabbitMQ specific)
      *
@@ -415,6 +511,30 @@ public:
     DeferredPublisher &publish(const std::string &exchange, const std::string &routingKey, const char *message, size_t size, int flags = 0) { return _implementation->publish(exchange, routingKey, Envelope(message, size), flags); }
     DeferredPublisher &publish(const std::string &exchange, const std::string &routingKey, const char *message, int flags = 0) { return _implementation->publish(exchange, routingKey, Envelope(message, strlen(message)), flags); }
 
+    /**
+     *  Publish a message of which the body is produced while it is being sent
+     *
+     *  This is meant for (very) large messages that you do not want to load in memory. Instead
+     *  of the body, you pass the size of the body and a producer. The producer is called every
+     *  time that the connection has room for the next body frame, and should write the next part
+     *  of the body into the buffer that it gets (which is never bigger than a single frame), and
+     *  return the number of bytes that it wrote. If it returns zero, the body can not be completed,
+     *  and the channel is closed.
+     *
+     *  Other instructions that you give on the same channel are sent after the body is complete.
+     *  How much data is buffered depends on the connection handler: see the onProducing()
+     *  method of the ConnectionHandler class. A TcpConnection produces the next frames every
+     *  time its outgoing buffer is empty.
+     *
+     *  @param  exchange    the exchange to publish to
+     *  @param  routingkey  the routing key
+     *  @param  metadata    the properties of the message (for example an Envelope without a body)
+     *  @param  size        size of the body
+     *  @param  producer    callback that produces the body
+     *  @param  flags       optional flags
+     */
+    DeferredPublisher &publish(const std::string &exchange, const std::string &routingKey, const MetaData &metadata, uint64_t size, const ProduceCallback &producer, int flags = 0) { return _implementation->publish(exchange, routingKey, metadata, size, producer, flags); }
+
     /**
      *  Set the Quality of Service (QOS) for this channel
      *
@@ -22,8 +22,12 @@
 #include "copiedbuffer.h"
 #include "deferred.h"
 #include "monitor.h"
+#include "stats.h"
+#include "stringview.h"
 #include <memory>
 #include <queue>
+#include <deque>
+#include <chrono>
 #include <map>
 
 /**
@@ -48,8 +52,11 @@ class DeferredGet;
 class DeferredPublisher;
 class Connection;
 class Envelope;
+class MetaData;
 class Table;
 class Frame;
+class Topology;
+class PublishStream;
 
 /**
  *  Class definition
@@ -75,6 +82,12 @@ private:
      */
     ErrorCallback _errorCallback;
 
+    /**
+     *  Callback when backpressure starts or ends
+     *  @var    BackpressureCallback
+     */
+    BackpressureCallback _backpressureCallback;
+
     /**
      *  Handler that deals with incoming messages as a result of publish operations
      *  @var    std::shared_ptr<DeferredPublisher>
@@ -122,9 +135,56 @@ private:
         state_connected,
         state_ready,
         state_closing,
-        state_closed
+        state_closed,
+        state_recovering
     } _state = state_closed;
 
+    /**
+     *  A frame that still needs to be sent out
+     */
+    struct Queued
+    {
+        /**
+         *  Should we wait for the answer before sending the next frame?
+         *  @var bool
+         */
+        bool synchronous;
+
+        /**
+         *  Is the frame sent in pipelined mode?
+         *  @var bool
+         */
+        bool pipelined;
+
+        /**
+         *  Is the frame held back while the connection is blocked?
+         *  @var bool
+         */
+        bool blockable;
+
+        /**
+         *  The frame data
+         *  @var CopiedBuffer
+         */
+        CopiedBuffer buffer;
+
+        /**
+         *  The body of a message that is published from a producer (only set
+         *  for publish frames, the header and body frames follow the frame)
+         *  @var std::shared_ptr<PublishStream>
+         */
+        std::shared_ptr<PublishStream> stream;
+
+        /**
+         *  Constructor
+         *  @param  frame
+         *  @param  pipelined
+         *  @param  stream
+         */
+        Queued(const Frame &frame, bool pipelined, const std::shared_ptr<PublishStream> &stream = nullptr) : 
+            synchronous(frame.synchronous()), pipelined(pipelined), blockable(frame.blockable()), buffer(frame), stream(stream) {}
+    };
+
     /**
      *  The frames that still need to be send out
      *
@@ -133,7 +193,7 @@ private:
      *
      *  @var std::queue
      */
-    std::queue<std::pair<bool, CopiedBuffer>> _queue;
+    std::queue<Queued> _queue;
 
     /**
      *  Are we currently operating in synchronous mode? Meaning: do we first have
@@ -142,12 +202,182 @@ private:
      */
     bool _synchronous = false;
 
+    /**
+     *  Should pipelinable frames (declare, bind, unbind, purge and delete) be
+     *  sent without waiting for the answers to earlier pipelinable frames?
+     *  @var bool
+     */
+    bool _pipelining = false;
+
+    /**
+     *  Number of pipelined frames for which the answer is still expected
+     *  @var size_t
+     */
+    size_t _pipelined = 0;
+
+    /**
+     *  The message that is being published from a producer, while its body
+     *  frames are produced all other frames are queued
+     *  @var std::shared_ptr<PublishStream>
+     */
+    std::shared_ptr<PublishStream> _stream;
+
+    /**
+     *  Watermarks for the number of bytes in the queue (0 if not checked)
+     *  @var size_t
+     */
+    size_t _highWatermark = 0;
+    size_t _lowWatermark = 0;
+
+    /**
+     *  Number of bytes in the queue
+     *  @var size_t
+     */
+    size_t _queuedBytes = 0;
+
+    /**
+     *  Is the queue over the high watermark (and not yet back at the low watermark)?
+     *  @var bool
+     */
+    bool _congested = false;
+
+    /**
+     *  Did the server ask us to stop sending messages (with a channel.flow frame)?
+     *  @var bool
+     */
+    bool _flowStopped = false;
+
+    /**
+     *  Was user space told that there is backpressure?
+     *  @var bool
+     */
+    bool _backpressure = false;
+
     /**
      *  The current object that is busy receiving a message
      *  @var std::shared_ptr<DeferredReceiver>
      */
     std::shared_ptr<DeferredReceiver> _receiver;
 
+    /**
+     *  The exchanges, queues, bindings and consumers that were declared on this
+     *  channel (only recorded if the connection is recoverable)
+     *  @var std::unique_ptr<Topology>
+     */
+    std::unique_ptr<Topology> _topology;
+
+    /**
+     *  Delivery tags of the current connection start counting at one again after
+     *  the channel has been recovered, the offset is added to them so that the
+     *  delivery tags reported to user space keep increasing
+     *  @var uint64_t
+     */
+    uint64_t _offset = 0;
+
+    /**
+     *  The highest delivery tag that was reported to user space
+     *  @var uint64_t
+     */
+    uint64_t _delivered = 0;
+
+    /**
+     *  Number of messages published while in confirm mode
+     *  @var uint64_t
+     */
+    uint64_t _published = 0;
+
+    /**
+     *  Is the channel being re-opened after the connection was recovered?
+     *  @var bool
+     */
+    bool _recovered = false;
+
+    /**
+     *  Statistics of the channel (nullptr if they are not collected)
+     *  @var std::shared_ptr<Stats>
+     */
+    std::shared_ptr<Stats> _stats;
+
+    /**
+     *  Times at which the synchronous operations that are still waiting for 
+     *  an answer were sent (only recorded if statistics are collected)
+     *  @var std::queue
+     */
+    std::queue<std::chrono::steady_clock::time_point> _operations;
+
+    /**
+     *  Delivery tags (as known by the server) and publish times of messages that
+     *  were not yet confirmed (only recorded if statistics are collected)
+     *  @var std::deque
+     */
+    std::deque<std::pair<uint64_t,std::chrono::steady_clock::time_point>> _unconfirmed;
+
+    /**
+     *  Number of messages published in confirm mode on the current connection
+     *  (this is the delivery tag that the server assigned to the last message)
+     *  @var uint64_t
+     */
+    uint64_t _sequence = 0;
+
+    /**
+     *  Are statistics collected for this channel or its connection?
+     *  @return bool
+     */
+    bool measuring() const;
+
+    /**
+     *  Update the statistics of the channel and its connection
+     *  @param  function        function that updates a stats object
+     */
+    template <typename Function>
+    void measure(const Function &function);
+
+    /**
+     *  Forget about the operations and messages that were in progress
+     *  @param  queued          number of frames that were removed from the queue
+     */
+    void discard(size_t queued);
+
+    /**
+     *  Pass a frame to the connection, without checking the queue
+     *  @param  frame
+     *  @return bool
+     */
+    bool transmit(const Frame &frame);
+
+    /**
+     *  Start sending the header and body frames of a message that is published
+     *  from a producer (the publish frame has just been sent)
+     *  @param  stream
+     */
+    void start(const std::shared_ptr<PublishStream> &stream);
+
+    /**
+     *  Send out the frames that are queued, until we have to wait again
+     */
+    void dequeue();
+
+    /**
+     *  Tell user space when backpressure starts or ends
+     */
+    void checkBackpressure();
+
+    /**
+     *  The body of the message that was published from a producer is complete
+     */
+    void complete();
+
+    /**
+     *  Give up on the message that is published from a producer, because its
+     *  body can not be completed (the channel is closed)
+     */
+    void abandon();
+
+    /**
+     *  Count a message that was published
+     */
+    void count();
+
     /**
      *  Attach the connection
      *  @param  connection
@@ -169,6 +399,42 @@ private:
      */
     Deferred &push(const Frame &frame);
 
+    /**
+     *  Report an error to all deferred objects that are waiting for an answer
+     *  @param  message         the error message
+     *  @return bool            is the channel still valid?
+     */
+    bool fail(const char *message);
+
+    /**
+     *  Forget about a channel that was waiting for the connection to be recovered
+     *  @return Deferred
+     */
+    Deferred &forget();
+
+    /**
+     *  Restart a consumer after the connection was recovered
+     *  @param  queue           the queue to consume from
+     *  @param  tag             the consumer tag that was originally requested
+     *  @param  flags           the original flags
+     *  @param  arguments       the original arguments
+     *  @param  deferred        the original deferred object
+     */
+    void restart(const std::string &queue, const std::string &tag, int flags, const Table &arguments, const std::shared_ptr<DeferredConsumer> &deferred);
+
+    /**
+     *  Re-declare the recorded topology
+     *  @param  topology        the recorded topology
+     */
+    void replay(Topology &topology);
+
+    /**
+     *  Re-declare the bindings and consumers of a server-named queue
+     *  @param  oldname         the name that the queue had before the connection was lost
+     *  @param  newname         the name that was assigned by the server
+     */
+    void replay(const std::string &oldname, const std::string &newname);
+
 protected:
     /**
      *  Construct a channel object
@@ -231,6 +497,35 @@ public:
      */
     void onError(const ErrorCallback &callback);
 
+    /**
+     *  Callback that is called when backpressure starts or ends
+     *  @param  callback    the callback to execute
+     */
+    void onBackpressure(const BackpressureCallback &callback)
+    {
+        // store callback
+        _backpressureCallback = callback;
+
+        // direct call if there already is backpressure
+        if (_backpressure && callback) callback(true);
+    }
+
+    /**
+     *  Set the watermarks for the queue of the channel (see Channel::watermarks())
+     *  @param  high        number of bytes at which backpressure starts (0 to disable)
+     *  @param  low         number of bytes at which it ends
+     */
+    void watermarks(size_t high, size_t low);
+
+    /**
+     *  Is there backpressure on the channel?
+     *  @return bool
+     */
+    bool backpressure() const
+    {
+        return _backpressure;
+    }
+
     /**
      *  Pause deliveries on a channel
      *
@@ -437,6 +732,19 @@ public:
      */
     DeferredPublisher &publish(const std::string &exchange, const std::string &routingKey, const Envelope &envelope, int flags);
 
+    /**
+     *  Publish a message of which the body is produced while it is being sent
+     *
+     *  @param  exchange    the exchange to publish to
+     *  @param  routingkey  the routing key
+     *  @param  metadata    the properties of the message
+     *  @param  size        size of the body
+     *  @param  producer    callback that produces the body
+     *  @param  flags       optional flags
+     *  @return DeferredPublisher
+     */
+    DeferredPublisher &publish(const std::string &exchange, const std::string &routingKey, const MetaData &metadata, uint64_t size, const ProduceCallback &producer, int flags);
+
     /**
      *  Set the Quality of Service (QOS) of the entire connection
      *  @param  prefetchCount       maximum number of messages to prefetch
@@ -569,25 +877,154 @@ public:
     /**
      *  Send a frame over the channel
      *  @param  frame       frame to send
+     *  @param  stream      body that follows the frame (only for publish frames)
      *  @return bool        was frame succesfully sent?
      */
-    bool send(const Frame &frame);
+    bool send(const Frame &frame, const std::shared_ptr<PublishStream> &stream = nullptr);
 
     /**
      *  Is this channel waiting for an answer before it can send furher instructions
+     *  (or busy sending the body of a message that is published from a producer)
      *  @return bool
      */
     bool waiting() const
     {
-        return _synchronous || !_queue.empty();
+        return _synchronous || _pipelined > 0 || !_queue.empty() || _stream;
+    }
+
+    /**
+     *  Does the channel have body frames to produce?
+     *  @return bool
+     */
+    bool producing() const
+    {
+        return _stream != nullptr;
     }
 
+    /**
+     *  Produce the next body frame of the message that is published from a producer
+     *  @return size_t      number of bytes sent
+     */
+    size_t produce();
+
+    /**
+     *  Is the channel in pipelined mode?
+     *  @return bool
+     */
+    bool pipelined() const
+    {
+        return _pipelining;
+    }
+
+    /**
+     *  Turn pipelined mode on or off
+     *  @param  enabled
+     */
+    void pipelined(bool enabled)
+    {
+        _pipelining = enabled;
+    }
+
+    /**
+     *  The statistics of the channel
+     *  @return std::shared_ptr<Stats>
+     */
+    const std::shared_ptr<Stats> &stats() const
+    {
+        return _stats;
+    }
+
+    /**
+     *  Start (or stop) collecting statistics
+     *  @param  stats
+     */
+    void stats(const std::shared_ptr<Stats> &stats);
+
     /**
      *  Signal the channel that a synchronous operation was completed, and that any
      *  queued frames can be sent out.
      */
     void flush();
 
+    /**
+     *  Is the channel waiting for the connection to be recovered?
+     *  @return bool
+     */
+    bool recovering() const
+    {
+        return _state == state_recovering;
+    }
+
+    /**
+     *  Suspend the channel because the connection was lost, but keep it around
+     *  so that it can be recovered when the connection is re-established
+     *  @param  message         the error message for operations that were in progress
+     */
+    void suspend(const char *message);
+
+    /**
+     *  Re-open the channel on a recovered connection, and re-declare its topology
+     */
+    void recover();
+
+    /**
+     *  Report that a publisher confirm (an ack or nack from the server) was received
+     *  @param  tag             the delivery tag from the server
+     *  @param  multiple        does it confirm all messages up to the tag?
+     *  @param  ack             was it an ack (or a nack)?
+     */
+    void reportConfirm(uint64_t tag, bool multiple, bool ack);
+
+    /**
+     *  Report that a message was returned by the server
+     */
+    void reportReturned();
+
+    /**
+     *  Report that a message was delivered
+     */
+    void reportDelivered();
+
+    /**
+     *  Convert a delivery tag received from the server into a delivery tag
+     *  that is reported to user space
+     *  @param  tag             the delivery tag from the server
+     *  @return uint64_t
+     */
+    uint64_t deliveryTag(uint64_t tag)
+    {
+        // count the message
+        reportDelivered();
+
+        // apply the offset
+        _delivered = std::max(_delivered, tag + _offset);
+
+        // done
+        return tag + _offset;
+    }
+
+    /**
+     *  Report that a queue was declared
+     *  @param  name            name of the queue
+     */
+    void reportDeclared(const std::string &name);
+
+    /**
+     *  Report that the server asked to stop (or start again) sending messages
+     *  @param  active          may messages be sent?
+     */
+    void reportFlow(bool active);
+
+    /**
+     *  Report that the connection is no longer blocked, the messages that
+     *  were held back can be sent
+     */
+    void reportUnblocked()
+    {
+        // send the queued frames
+        dequeue();
+    }
+
     /**
      *  Report to the handler that the channel is opened
      */
@@ -602,8 +1039,14 @@ public:
         // the last (possibly synchronous) operation was received, so we're no longer in synchronous mode
         if (_synchronous && _queue.empty()) _synchronous = false;
 
-        // inform handler
-        if (_readyCallback) _readyCallback();
+        // was the channel re-opened after the connection was recovered?
+        bool recovered = _recovered;
+
+        // the channel is fully recovered
+        _recovered = false;
+
+        // inform handler (but not if the channel was re-opened, user space already knows it is ready)
+        if (_readyCallback && !recovered) _readyCallback();
 
         // if the monitor is still valid, we flush any waiting operations 
         if (monitor.valid()) flush();
@@ -728,7 +1171,7 @@ public:
      *  @param  consumertag the consumer tag
      *  @return             the receiver object
      */
-    DeferredConsumer *consumer(const std::string &consumertag) const;
+    DeferredConsumer *consumer(const StringView &consumertag) const;
 
     /**
      *  Retrieve the current object that is receiving a message
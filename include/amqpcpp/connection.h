@@ -146,6 +146,20 @@ public:
     {
         return _implementation.parse(buffer);
     }
+
+    /**
+     *  Parse data from a contiguous buffer
+     *
+     *  This is the fastest way to parse data: because all bytes are stored in one
+     *  block of memory, the frames are decoded straight from memory.
+     *
+     *  @param  buffer      buffer to decode
+     *  @return             number of bytes that were processed
+     */
+    uint64_t parse(const ByteBuffer &buffer)
+    {
+        return _implementation.parse(buffer);
+    }
     
     /**
      *  Report that the connection was lost in the middle of an operation
@@ -253,6 +267,218 @@ public:
         return _implementation.waiting();
     }
 
+    /**
+     *  When was the last data sent to the server? Event loops can use this
+     *  to only send a heartbeat if nothing else was sent during the interval
+     *  @return std::chrono::steady_clock::time_point
+     */
+    std::chrono::steady_clock::time_point lastSent() const
+    {
+        return _implementation.lastSent();
+    }
+
+    /**
+     *  When was the last data received from the server? If this was more than
+     *  the heartbeat interval ago, the server is probably no longer alive
+     *  @return std::chrono::steady_clock::time_point
+     */
+    std::chrono::steady_clock::time_point lastReceived() const
+    {
+        return _implementation.lastReceived();
+    }
+
+    /**
+     *  Stop processing incoming data, for example because the application
+     *  can not keep up with the messages that are delivered. The frame that
+     *  is being processed is finished, but no further frames are processed,
+     *  and the handler's onPaused() method is called so that it can stop
+     *  reading from the socket. Every call to pause() should be matched by a
+     *  call to resume(). While the connection is paused, no messages (and no
+     *  other answers from the server) are received. Closing the connection
+     *  resumes it, and a recovered connection starts unpaused.
+     */
+    void pause()
+    {
+        _implementation.pause();
+    }
+
+    /**
+     *  Resume processing incoming data
+     */
+    void resume()
+    {
+        _implementation.resume();
+    }
+
+    /**
+     *  Is processing of incoming data paused?
+     *  @return bool
+     */
+    bool paused() const
+    {
+        return _implementation.paused();
+    }
+
+    /**
+     *  Produce the next body frames of the messages that are published from a
+     *  producer. Each call produces about four frames, which are passed to the
+     *  handler's onData() method. You only have to call this method if your
+     *  handler's onProducing() method returned true: call it every time your
+     *  output buffer has room for more data, until it returns false.
+     *  @return bool            are there more frames to produce?
+     */
+    bool produce()
+    {
+        return _implementation.produce();
+    }
+
+    /**
+     *  Are there messages that are published from a producer, and of which
+     *  body frames still have to be produced?
+     *  @return bool
+     */
+    bool producing() const
+    {
+        return _implementation.producers();
+    }
+
+    /**
+     *  Set watermarks for the number of bytes that are waiting to be sent. When
+     *  the high watermark is reached, the handler's onBackpressure() method is
+     *  called so that you can stop publishing, and when the data has drained to
+     *  the low watermark it is called again. Without watermarks (or with a high
+     *  watermark of zero) the handler is never called.
+     *
+     *  The connection counts the frames in its own queue. If your handler
+     *  buffers the data that is passed to its onData() method, you should
+     *  report the size of that buffer with buffered() every time it changes.
+     *
+     *  @param  high            number of bytes at which backpressure starts
+     *  @param  low             number of bytes at which it ends
+     */
+    void watermarks(size_t high, size_t low)
+    {
+        _implementation.watermarks(high, low);
+    }
+
+    /**
+     *  Report the number of bytes that are still in the output buffer of your handler
+     *  @param  bytes
+     */
+    void buffered(size_t bytes)
+    {
+        _implementation.buffered(bytes);
+    }
+
+    /**
+     *  Is too much data waiting to be sent (was the high watermark reached, and
+     *  the low watermark not yet)?
+     *  @return bool
+     */
+    bool backpressure() const
+    {
+        return _implementation.backpressure();
+    }
+
+    /**
+     *  Did the server block the connection? RabbitMQ blocks connections that
+     *  publish messages when one of its resources runs low (the handler's
+     *  onBlocked() and onUnblocked() methods are called when this changes)
+     *  @return bool
+     */
+    bool blocked() const
+    {
+        return _implementation.blocked();
+    }
+
+    /**
+     *  Hold back published messages while the server blocks the connection.
+     *  The messages (and all instructions that are given after them on the
+     *  same channel) are queued by their channel, and sent as soon as the
+     *  connection is unblocked. This keeps the other channels usable, but the
+     *  messages are kept in memory: use Channel::watermarks() to find out when
+     *  you should stop publishing. By default, messages are sent right away.
+     *  @param  enabled
+     */
+    void gated(bool enabled)
+    {
+        _implementation.gated(enabled);
+    }
+
+    /**
+     *  Are published messages held back while the connection is blocked?
+     *  @return bool
+     */
+    bool gated() const
+    {
+        return _implementation.gated();
+    }
+
+    /**
+     *  Make the connection recoverable. When a recoverable connection is lost,
+     *  the channels are not closed but suspended: pending operations fail, but
+     *  the channel objects stay valid and everything that was declared on them
+     *  (exchanges, queues, bindings, consumers, qos and confirm mode) is
+     *  recorded. After the underlying transport has been re-established, you
+     *  can call recover() to re-open the channels and replay that topology.
+     *
+     *  Set this before you create any channels, because channels that are
+     *  created on a non-recoverable connection do not record their topology.
+     *  Turning it off for a connection that was lost fails the suspended channels.
+     *  @param  enabled
+     */
+    void recoverable(bool enabled)
+    {
+        _implementation.recoverable(enabled);
+    }
+
+    /**
+     *  Is the connection recoverable?
+     *  @return bool
+     */
+    bool recoverable() const
+    {
+        return _implementation.recoverable();
+    }
+
+    /**
+     *  Restart a recoverable connection that was lost. Call this when a new
+     *  transport is ready to carry the data, the connection then starts the
+     *  handshake all over again, and re-opens the suspended channels.
+     *  @param  login       login data for the new connection
+     *  @param  vhost       vhost for the new connection
+     *  @return bool        false if the connection was not lost or is not recoverable
+     */
+    bool recover(const Login &login = Login(), const std::string &vhost = "/")
+    {
+        return _implementation.recover(login, vhost);
+    }
+
+    /**
+     *  Start collecting statistics. Frames and bytes are counted, and so are the
+     *  messages that are published, delivered, acked and confirmed on all
+     *  channels of the connection. The object can be read from any thread.
+     *  Pass a nullptr to stop collecting statistics.
+     *
+     *      auto stats = std::make_shared<AMQP::Stats>();
+     *      connection.stats(stats);
+     *
+     *  @param  stats
+     */
+    void stats(const std::shared_ptr<Stats> &stats)
+    {
+        _implementation.stats(stats);
+    }
+
+    /**
+     *  The statistics that are collected (nullptr if they are not collected)
+     *  @return std::shared_ptr<Stats>
+     */
+    const std::shared_ptr<Stats> &stats() const
+    {
+        return _implementation.stats();
+    }
+
     /**
      *  Some classes have access to private properties
      */
@@ -134,6 +134,102 @@ public:
         (void) connection;
     }
 
+    /**
+     *  Method that is called when the processing of incoming data was paused
+     *  (see Connection::pause()). The Connection::parse() method does not
+     *  process any frames until the connection is resumed, so you can stop
+     *  reading from the socket. When you keep reading, you should buffer
+     *  the data yourself.
+     *
+     *  @param  connection      The connection that was paused
+     */
+    virtual void onPaused(Connection *connection)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+    }
+
+    /**
+     *  Method that is called when the processing of incoming data is resumed.
+     *  You should start reading from the socket again, and pass the data that
+     *  was not yet processed by the Connection::parse() method to it again.
+     *
+     *  @param  connection      The connection that was resumed
+     */
+    virtual void onResumed(Connection *connection)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+    }
+
+    /**
+     *  Method that is called when a message is published from a producer (see
+     *  Channel::publish()), and the body frames are ready to be produced. If you
+     *  return false (which is what the default implementation does), all frames
+     *  are produced right away and passed to your onData() method. If you want to
+     *  limit the amount of data in your output buffer, you should return true,
+     *  and call Connection::produce() every time your buffer has room for more,
+     *  until that method returns false.
+     *
+     *  @param  connection      The connection that has frames to produce
+     *  @return bool            Will you call Connection::produce() yourself?
+     */
+    virtual bool onProducing(Connection *connection)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+
+        // the frames are produced right away
+        return false;
+    }
+
+    /**
+     *  Method that is called when the number of bytes that are waiting to be
+     *  sent crosses one of the watermarks that were set with Connection::watermarks().
+     *  When active is true, the high watermark was reached and you should stop
+     *  publishing. When it is false, the data drained to the low watermark and
+     *  you can start again. The bytes that are counted are the frames that the
+     *  connection has queued, plus the bytes that you reported to be still in
+     *  your own output buffer with Connection::buffered().
+     *
+     *  @param  connection      The connection with too much (or again little enough) data
+     *  @param  active          Is there backpressure?
+     */
+    virtual void onBackpressure(Connection *connection, bool active)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+        (void) active;
+    }
+
+    /**
+     *  Method that is called when the server blocks the connection, because
+     *  one of its resources (like memory or disk space) is running low. The
+     *  server stops reading from the connection as soon as a message is
+     *  published, so you should stop publishing until onUnblocked() is called
+     *  (or enable Connection::gated() to let the channels hold the messages back).
+     *
+     *  @param  connection      The connection that was blocked
+     *  @param  reason          Why the connection was blocked
+     */
+    virtual void onBlocked(Connection *connection, const char *reason)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+        (void) reason;
+    }
+
+    /**
+     *  Method that is called when the server no longer blocks the connection
+     *
+     *  @param  connection      The connection that was unblocked
+     */
+    virtual void onUnblocked(Connection *connection)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+    }
+
     /**
      *  When the connection ends up in an error state this method is called.
      *  This happens when data comes in that does not match the AMQP protocol,
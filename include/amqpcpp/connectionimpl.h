@@ -22,9 +22,12 @@
 #include "copiedbuffer.h"
 #include "monitor.h"
 #include "login.h"
+#include "stats.h"
+#include "bytebuffer.h"
 #include <unordered_map>
 #include <memory>
 #include <queue>
+#include <chrono>
 
 /**
  *  Set up namespace
@@ -76,6 +79,13 @@ protected:
      */
     bool _closed = false;
 
+    /**
+     *  Should channels be kept (and their topology be recorded) when the
+     *  connection is lost, so that they can be recovered later?
+     *  @var    bool
+     */
+    bool _recoverable = false;
+
     /**
      *  All channels that are active
      *  @var    std::unordered_map<uint16_t, std::shared_ptr<ChannelImpl>>
@@ -107,6 +117,50 @@ protected:
      */
     uint32_t _expected = 7;
 
+    /**
+     *  Number of times that processing incoming data was paused (and not yet resumed)
+     *  @var    uint32_t
+     */
+    uint32_t _paused = 0;
+
+    /**
+     *  Was the handler told that there are body frames to produce?
+     *  @var    bool
+     */
+    bool _producing = false;
+
+    /**
+     *  Watermarks for the number of bytes waiting to be sent (0 if not checked)
+     *  @var    size_t
+     */
+    size_t _highWatermark = 0;
+    size_t _lowWatermark = 0;
+
+    /**
+     *  Number of bytes in the queue, and in the output buffer of the handler
+     *  @var    size_t
+     */
+    size_t _queuedBytes = 0;
+    size_t _bufferedBytes = 0;
+
+    /**
+     *  Was the handler told that the high watermark was reached?
+     *  @var    bool
+     */
+    bool _backpressure = false;
+
+    /**
+     *  Did the server block the connection (because one of its resources runs low)?
+     *  @var    bool
+     */
+    bool _blocked = false;
+
+    /**
+     *  Should the channels hold back published messages while the connection is blocked?
+     *  @var    bool
+     */
+    bool _gated = false;
+
     /**
      *  The login for the server (login, password)
      *  @var    Login
@@ -124,6 +178,27 @@ protected:
      *  @var    queue
      */
     std::queue<CopiedBuffer> _queue;
+
+    /**
+     *  Statistics of the connection (nullptr if they are not collected)
+     *  @var std::shared_ptr<Stats>
+     */
+    std::shared_ptr<Stats> _stats;
+
+    /**
+     *  Do one or more channels collect statistics? If so, incoming frames
+     *  have to be counted for their channel too
+     *  @var bool
+     */
+    bool _channelStats = false;
+
+    /**
+     *  When was data last passed to the handler, and when was data last received?
+     *  (heartbeats are only needed if the connection is otherwise idle)
+     *  @var std::chrono::steady_clock::time_point
+     */
+    std::chrono::steady_clock::time_point _sent = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point _received = _sent;
     
     /**
      *  Helper method to send the close frame
@@ -143,6 +218,16 @@ protected:
      *  @return bool
      */
     bool waiting() const;
+
+    /**
+     *  Tell the handler when the bytes waiting to be sent cross a watermark
+     */
+    void checkBackpressure();
+
+    /**
+     *  Let the channels send the messages that they held back
+     */
+    void release();
     
     /**
      *  Helper method for the fail() method
@@ -152,6 +237,28 @@ protected:
      */
     bool fail(const Monitor &monitor, const char *message);
 
+    /**
+     *  Helper method to suspend all channels (or fail the ones that can not be recovered)
+     *  @param  monitor
+     *  @param  message
+     *  @return bool
+     */
+    bool suspend(const Monitor &monitor, const char *message);
+
+    /**
+     *  Count a received frame in the statistics
+     *  @param  frame
+     */
+    void count(const ReceivedFrame &frame);
+
+    /**
+     *  Parse the buffer into recognized frames
+     *  @param  buffer      buffer to decode
+     *  @param  data        the same data in contiguous memory (or nullptr if the buffer is not contiguous)
+     *  @return             number of bytes that were processed
+     */
+    uint64_t parse(const Buffer &buffer, const char *data);
+
 private:
     /**
      *  Construct an AMQP object based on full login data
@@ -359,7 +466,22 @@ public:
      *  @param  buffer      buffer to decode
      *  @return             number of bytes that were processed
      */
-    uint64_t parse(const Buffer &buffer);
+    uint64_t parse(const Buffer &buffer)
+    {
+        // the buffer is not necessarily contiguous
+        return parse(buffer, nullptr);
+    }
+
+    /**
+     *  Parse a contiguous buffer, the frames are decoded straight from memory
+     *  @param  buffer      buffer to decode
+     *  @return             number of bytes that were processed
+     */
+    uint64_t parse(const ByteBuffer &buffer)
+    {
+        // the data is all in one block
+        return parse(buffer, buffer.data(0, buffer.size()));
+    }
 
     /**
      *  Fail all pending - this can be called by user-space when it is recognized that the 
@@ -377,6 +499,166 @@ public:
      */
     bool close();
 
+    /**
+     *  Is the connection recoverable?
+     *  @return bool
+     */
+    bool recoverable() const
+    {
+        return _recoverable;
+    }
+
+    /**
+     *  Make the connection recoverable (or not)
+     *  @param  enabled
+     */
+    void recoverable(bool enabled);
+
+    /**
+     *  Restart a recoverable connection that was lost
+     *  @param  login       login data for the new connection
+     *  @param  vhost       vhost for the new connection
+     *  @return bool
+     */
+    bool recover(const Login &login, const std::string &vhost);
+
+    /**
+     *  The statistics of the connection
+     *  @return std::shared_ptr<Stats>
+     */
+    const std::shared_ptr<Stats> &stats() const
+    {
+        return _stats;
+    }
+
+    /**
+     *  When was the last data sent to the server?
+     *  @return std::chrono::steady_clock::time_point
+     */
+    std::chrono::steady_clock::time_point lastSent() const
+    {
+        return _sent;
+    }
+
+    /**
+     *  When was the last data received from the server?
+     *  @return std::chrono::steady_clock::time_point
+     */
+    std::chrono::steady_clock::time_point lastReceived() const
+    {
+        // while paused we do not read from the socket, so we can not tell
+        // whether the server is still sending, we assume that it is
+        return _paused ? std::chrono::steady_clock::now() : _received;
+    }
+
+    /**
+     *  Stop processing incoming data (see Connection::pause())
+     */
+    void pause();
+
+    /**
+     *  Resume processing incoming data
+     */
+    void resume();
+
+    /**
+     *  Is processing of incoming data paused?
+     *  @return bool
+     */
+    bool paused() const
+    {
+        return _paused > 0;
+    }
+
+    /**
+     *  Called by a channel that has body frames to produce
+     */
+    void producing();
+
+    /**
+     *  Produce the next body frames of the messages that are published from a
+     *  producer (see Connection::produce())
+     *  @return bool            are there more frames to produce?
+     */
+    bool produce();
+
+    /**
+     *  Are there channels with body frames to produce?
+     *  @return bool
+     */
+    bool producers() const;
+
+    /**
+     *  Set the watermarks for the data that is waiting to be sent (see Connection::watermarks())
+     *  @param  high            number of bytes at which backpressure starts (0 to disable)
+     *  @param  low             number of bytes at which it ends
+     */
+    void watermarks(size_t high, size_t low);
+
+    /**
+     *  Tell the number of bytes that are still in the output buffer of the handler
+     *  @param  bytes
+     */
+    void buffered(size_t bytes)
+    {
+        // store it
+        _bufferedBytes = bytes;
+
+        // the watermarks may have been crossed
+        checkBackpressure();
+    }
+
+    /**
+     *  Is too much data waiting to be sent?
+     *  @return bool
+     */
+    bool backpressure() const
+    {
+        return _backpressure;
+    }
+
+    /**
+     *  Did the server block the connection?
+     *  @return bool
+     */
+    bool blocked() const
+    {
+        return _blocked;
+    }
+
+    /**
+     *  Should published messages be held back while the connection is blocked?
+     *  @param  enabled
+     */
+    void gated(bool enabled);
+
+    /**
+     *  Are published messages held back while the connection is blocked?
+     *  @return bool
+     */
+    bool gated() const
+    {
+        return _gated;
+    }
+
+    /**
+     *  Are published messages held back right now?
+     *  @return bool
+     */
+    bool holding() const
+    {
+        return _blocked && _gated;
+    }
+
+    /**
+     *  Start (or stop) collecting statistics
+     *  @param  stats
+     */
+    void stats(const std::shared_ptr<Stats> &stats)
+    {
+        _stats = stats;
+    }
+
     /**
      *  Send a frame over the connection
      *
@@ -428,6 +710,17 @@ public:
         _handler->onClosed(_parent);
     }
 
+    /**
+     *  Report that the server blocked the connection
+     *  @param  reason          why the connection is blocked
+     */
+    void reportBlocked(const char *reason);
+
+    /**
+     *  Report that the server no longer blocks the connection
+     */
+    void reportUnblocked();
+
     /**
      *  Retrieve the amount of channels this connection has
      *  @return std::size_t
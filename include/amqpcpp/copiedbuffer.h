@@ -52,17 +52,25 @@ private:
 
 protected:
     /**
-     *  The method that adds the actual data
+     *  The method that adds the actual data, it is only called when the data
+     *  does not fit in the window, which means that the frame is bigger than
+     *  its totalSize() said it would be, and the buffer has to grow
      *  @param  data
      *  @param  size
      */
     virtual void append(const void *data, size_t size) override
     {
+        // number of bytes in the buffer so far
+        size_t used = _cursor - _buffer;
+
+        // make room
+        _buffer = (char *)realloc(_buffer, _capacity = used + size);
+
         // copy into the buffer
-        memcpy(_buffer + _size, data, size);
-        
-        // update the size
-        _size += size;
+        memcpy(_buffer + used, data, size);
+
+        // the window is full
+        window(_buffer + _capacity, _buffer + _capacity);
     }
 
 public:
@@ -74,11 +82,20 @@ public:
         _capacity(frame.totalSize()),
         _buffer((char *)malloc(_capacity)) 
     {
+        // the frame is written straight into the buffer
+        window(_buffer, _buffer + _capacity);
+
         // tell the frame to fill this buffer
         frame.fill(*this);
         
         // append an end of frame byte (but not when still negotiating the protocol)
         if (frame.needsSeparator()) add((uint8_t)206);
+
+        // this is how much was written
+        _size = _cursor - _buffer;
+
+        // the buffer is complete
+        window(nullptr, nullptr);
     }
 
     /**
@@ -35,6 +35,13 @@ private:
      */
     NackCallback _nackCallback;
 
+    /**
+     *  Number of messages that were published on earlier connections (the
+     *  server starts counting at one again after the connection was recovered)
+     *  @var    uint64_t
+     */
+    uint64_t _offset = 0;
+
     /**
      *  Process an ACK frame
      *
@@ -49,6 +56,14 @@ private:
      */
     void process(BasicNackFrame &frame);
 
+    /**
+     *  Report that the connection was lost, messages that were published
+     *  but not yet confirmed are reported as nack'ed
+     *
+     *  @param  published   Total number of messages published in confirm mode
+     */
+    void reset(uint64_t published);
+
     /**
      *  The channel implementation may call our
      *  private members and construct us
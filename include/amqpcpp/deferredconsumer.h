@@ -137,6 +137,25 @@ public:
         return *this;
     }
 
+    /**
+     *  Register a function to be called when a message comes in of which the
+     *  body should not be collected in memory. The function is called as soon
+     *  as the meta data is known, and can install callbacks on the stream to
+     *  process the body in chunks, straight from the receive buffer. This is
+     *  meant for (very) large messages.
+     *
+     *  @param  callback    the callback to execute
+     *  @return Same object for chaining
+     */
+    DeferredConsumer &onMessageStream(const MessageStreamCallback &callback)
+    {
+        // store callback
+        _streamCallback = callback;
+
+        // allow chaining
+        return *this;
+    }
+
     /**
      *  RabbitMQ sends a message in multiple frames to its consumers.
      *  The AMQP-CPP library collects these frames and merges them into a 
@@ -62,7 +62,7 @@ protected:
      *  @param  exchange            the exchange to which the message was published
      *  @param  routingkey          the routing key that was used to publish the message
      */
-    virtual void initialize(const std::string &exchange, const std::string &routingkey) override;
+    virtual void initialize(const StringView &exchange, const StringView &routingkey) override;
 
     /**
      *  Indicate that a message was done
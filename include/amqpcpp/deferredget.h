@@ -62,11 +62,6 @@ private:
      */
     virtual std::shared_ptr<DeferredReceiver> lock() override { return shared_from_this(); }
 
-    /**
-     *  Extended implementation of the complete method that is called when a message was fully received
-     */
-    virtual void complete() override;
-
     /**
      *  The channel implementation may call our
      *  private members and construct us
@@ -18,6 +18,8 @@
 #include "deferred.h"
 #include "stack_ptr.h"
 #include "message.h"
+#include "messagestream.h"
+#include "stringview.h"
 
 /**
  *  Start namespace
@@ -51,7 +53,7 @@ protected:
      *  @param  exchange            the exchange to which the message was published
      *  @param  routingkey          the routing key that was used to publish the message
      */
-    virtual void initialize(const std::string &exchange, const std::string &routingkey);
+    virtual void initialize(const StringView &exchange, const StringView &routingkey);
     
     /**
      *  Get reference to self to prevent that object falls out of scope
@@ -124,6 +126,18 @@ protected:
      */
     stack_ptr<Message> _message;
 
+    /**
+     *  Callback for messages of which the body is streamed
+     *  @var    MessageStreamCallback
+     */
+    MessageStreamCallback _streamCallback;
+
+    /**
+     *  The message that we are currently streaming
+     *  @var    stack_ptr<MessageStream>
+     */
+    stack_ptr<MessageStream> _stream;
+
     /**
      *  Constructor
      *  @param  failed  Have we already failed?
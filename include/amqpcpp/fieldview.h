@@ -0,0 +1,286 @@
+/**
+ *  FieldView.h
+ *
+ *  A field in an encoded table or array, as it was received from the
+ *  server. Unlike the Field classes, a view does not copy the data: it
+ *  refers to the data in the received frame, and only decodes the value
+ *  when one of its methods is called. This makes it possible to process
+ *  message headers without building a Table. The view is only valid for
+ *  as long as the callback that received it is running.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include "stringview.h"
+#include "callbacks.h"
+#include "endian.h"
+#include "protocolexception.h"
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class FieldView
+{
+private:
+    /**
+     *  The type of the field
+     *  @var char
+     */
+    char _type;
+
+    /**
+     *  The encoded value (for strings, arrays and tables without the size)
+     *  @var StringView
+     */
+    StringView _value;
+
+    /**
+     *  Read a number in network byte order
+     *  @return T
+     */
+    template <typename T>
+    T read() const
+    {
+        // copy the bytes
+        T value;
+        memcpy(&value, _value.data(), sizeof(T));
+
+        // done
+        return value;
+    }
+
+    /**
+     *  Read a size prefix from encoded data
+     *  @param  data
+     *  @param  bytes       number of bytes of the prefix (1 or 4)
+     *  @return size_t
+     */
+    static size_t prefix(const char *data, size_t bytes)
+    {
+        // short strings have a single byte
+        if (bytes == 1) return (uint8_t)data[0];
+
+        // others have four
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+
+        // convert to host byte order
+        return be32toh(value);
+    }
+
+    /**
+     *  Process encoded fields
+     *  @param  data        the encoded fields
+     *  @param  size        size of the data
+     *  @param  named       do the fields have names (true for tables, false for arrays)
+     *  @param  callback    called for each field
+     *  @throws ProtocolException
+     */
+    static void visit(const char *data, size_t size, bool named, const FieldCallback &callback)
+    {
+        // the position in the data
+        size_t pos = 0;
+
+        // process the fields one by one
+        while (pos < size)
+        {
+            // the name of the field
+            StringView name;
+
+            // tables have a name before each field
+            if (named)
+            {
+                // the name starts with its size
+                size_t length = (uint8_t)data[pos++];
+
+                // the name and the type must fit
+                if (size - pos < length + 1) throw ProtocolException("field out of range");
+
+                // get the name
+                name = StringView(data + pos, length);
+                pos += length;
+            }
+
+            // get the type
+            char type = data[pos++];
+
+            // the size of the size prefix, and the size of the value
+            size_t bytes = 0, length = 0;
+
+            // the size depends on the type
+            switch (type)
+            {
+            case 't': case 'b': case 'B':   length = 1; break;
+            case 'U': case 'u':             length = 2; break;
+            case 'I': case 'i': case 'f':   length = 4; break;
+            case 'L': case 'l': case 'd':
+            case 'T':                       length = 8; break;
+            case 'D':                       length = 5; break;
+            case 's':                       bytes = 1; break;
+            case 'S': case 'A': case 'F':   bytes = 4; break;
+            default:                        throw ProtocolException("unknown field type");
+            }
+
+            // the size prefix must fit
+            if (size - pos < bytes) throw ProtocolException("field out of range");
+
+            // read the size prefix
+            if (bytes > 0) length = prefix(data + pos, bytes);
+
+            // the value must fit
+            if (size - pos - bytes < length) throw ProtocolException("field out of range");
+
+            // pass the field to the callback
+            callback(name, FieldView(type, StringView(data + pos + bytes, length)));
+
+            // proceed with the next field
+            pos += bytes + length;
+        }
+    }
+
+    /**
+     *  Check that encoded fields are well-formed, including the nested tables and arrays
+     *  @param  data        the encoded fields
+     *  @param  size        size of the data
+     *  @param  named       do the fields have names (true for tables, false for arrays)
+     *  @throws ProtocolException
+     */
+    static void validate(const char *data, size_t size, bool named)
+    {
+        // walk over the fields, and descend into the nested ones
+        visit(data, size, named, [](const StringView &, const FieldView &value) {
+            
+            // only tables and arrays have to be checked further
+            if (value.isTable() || value.isArray()) validate(value._value.data(), value._value.size(), value.isTable());
+        });
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  type        the type of the field
+     *  @param  value       the encoded value
+     */
+    FieldView(char type, const StringView &value) : _type(type), _value(value) {}
+
+    /**
+     *  Process the fields of an encoded table (without its size prefix)
+     *  @param  table       the encoded table
+     *  @param  callback    called for each field
+     *  @throws ProtocolException
+     */
+    static void table(const StringView &table, const FieldCallback &callback)
+    {
+        visit(table.data(), table.size(), true, callback);
+    }
+
+    /**
+     *  Check that an encoded table (without its size prefix) is well-formed,
+     *  so that it can later be processed or decoded without errors
+     *  @param  table       the encoded table
+     *  @throws ProtocolException
+     */
+    static void validate(const StringView &table)
+    {
+        validate(table.data(), table.size(), true);
+    }
+
+    /**
+     *  The type of the field, this is the same type ID as used by the Field classes
+     *  @return char
+     */
+    char typeID() const { return _type; }
+
+    /**
+     *  The encoded value, in network byte order (strings, arrays and tables
+     *  without their size prefix)
+     *  @return StringView
+     */
+    const StringView &raw() const { return _value; }
+
+    /**
+     *  Check the type of field
+     *  @return bool
+     */
+    bool isString() const { return _type == 's' || _type == 'S'; }
+    bool isInteger() const { return strchr("tbBUuIiLlT", _type) != nullptr; }
+    bool isDecimal() const { return _type == 'f' || _type == 'd'; }
+    bool isArray() const { return _type == 'A'; }
+    bool isTable() const { return _type == 'F'; }
+
+    /**
+     *  Get the value of a string (an empty string for other types)
+     *  @return StringView
+     */
+    StringView string() const
+    {
+        return isString() ? _value : StringView();
+    }
+
+    /**
+     *  Get the value of an integer, a boolean or a timestamp (zero for other types)
+     *  @return int64_t
+     */
+    int64_t integer() const
+    {
+        switch (_type)
+        {
+        case 't':   return read<uint8_t>() != 0;
+        case 'b':   return read<int8_t>();
+        case 'B':   return read<uint8_t>();
+        case 'U':   return (int16_t)be16toh(read<int16_t>());
+        case 'u':   return be16toh(read<uint16_t>());
+        case 'I':   return (int32_t)be32toh(read<int32_t>());
+        case 'i':   return be32toh(read<uint32_t>());
+        case 'L':   return (int64_t)be64toh(read<int64_t>());
+        case 'l':   return (int64_t)be64toh(read<uint64_t>());
+        case 'T':   return (int64_t)be64toh(read<uint64_t>());
+        default:    return 0;
+        }
+    }
+
+    /**
+     *  Get the value of a number (zero for other types)
+     *  @return double
+     */
+    double number() const
+    {
+        // floating point numbers are not converted to network byte order by the library
+        if (_type == 'f') return read<float>();
+        if (_type == 'd') return read<double>();
+
+        // all other numbers
+        return (double)integer();
+    }
+
+    /**
+     *  Process the fields of a nested table or array (nothing happens for other types)
+     *  @param  callback    called for each field
+     *  @throws ProtocolException
+     */
+    void visit(const FieldCallback &callback) const
+    {
+        // only tables and arrays have fields
+        if (_type == 'F') visit(_value.data(), _value.size(), true, callback);
+        if (_type == 'A') visit(_value.data(), _value.size(), false, callback);
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
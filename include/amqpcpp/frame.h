@@ -57,6 +57,18 @@ public:
      */
     virtual void fill(OutBuffer &buffer) const = 0;
 
+    /**
+     *  The type of frame (the first byte on the wire), or zero for the protocol header
+     *  @return uint8_t
+     */
+    virtual uint8_t type() const { return 0; }
+
+    /**
+     *  The channel on which the frame is sent, or zero for frames that belong to the connection
+     *  @return uint16_t
+     */
+    virtual uint16_t channel() const { return 0; }
+
     /**
      *  Is this a frame that is part of the connection setup?
      *  @return bool
@@ -83,6 +95,22 @@ public:
      */
     virtual bool synchronous() const { return false; }
 
+    /**
+     *  Can this synchronous frame be pipelined?
+     *
+     *  In pipelined mode, the channel sends out such frames without 
+     *  waiting for the -ok frames of earlier pipelinable frames
+     */
+    virtual bool pipelinable() const { return false; }
+
+    /**
+     *  Can this frame be held back while the server has blocked the connection?
+     *
+     *  Only frames that publish a message are held back, because that is
+     *  what the server no longer accepts
+     */
+    virtual bool blockable() const { return false; }
+
     /**
      *  Process the frame
      *  @param  connection      The connection over which it was received
@@ -0,0 +1,249 @@
+/**
+ *  HeartbeatTimer.h
+ *
+ *  Timer that the event loop adapters use for each connection: it closes
+ *  the connection if it is not set up in time, sends heartbeats when
+ *  nothing else was sent, and drops the connection if the server was
+ *  silent for too long. The deadlines are kept on the clock of the event
+ *  loop, which the adapter exposes with the now() method of its ticker.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <chrono>
+#include <algorithm>
+#include "amqpcpp/linux_tcp.h"
+#include "amqpcpp/timerwheel.h"
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ *
+ *  The Ticker is the timer wheel of the adapter, it should have a now() method
+ *  that returns the time of the loop (in seconds), and a schedule() method that
+ *  adds a timer to the wheel and makes sure that the wheel is moving
+ */
+template <typename Ticker>
+class HeartbeatTimer : private TimerWheel::Timer
+{
+protected:
+    /**
+     *  The connection that is monitored
+     *  @var TcpConnection
+     */
+    TcpConnection *_connection;
+
+private:
+    /**
+     *  The timer wheel that is shared by all connections on the loop
+     *  @var Ticker
+     */
+    Ticker *_ticker;
+
+    /**
+     *  When should we send the next heartbeat? (in seconds, on the clock of the loop)
+     *  @var double
+     */
+    double _next = 0.0;
+
+    /**
+     *  When does the connection expire / was the server for a too longer period of time idle?
+     *  During connection setup, this member is used as the connect-timeout.
+     *  @var double
+     */
+    double _expire;
+
+    /**
+     *  Timeout after which the connection is no longer considered alive.
+     *  A heartbeat must be sent every _timeout / 2 seconds.
+     *  Value zero means heartbeats are disabled, or not yet negotiated.
+     *  @var uint16_t
+     */
+    uint16_t _timeout = 0;
+
+    /**
+     *  Number of seconds that have passed since a certain moment
+     *  @param  since
+     *  @return double
+     */
+    static double elapsed(std::chrono::steady_clock::time_point since)
+    {
+        // calculate the difference with the current time
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+    }
+
+    /**
+     *  Schedule the timer so that it expires at the earliest of the two deadlines
+     */
+    void schedule()
+    {
+        // find the earliest thing that expires
+        _ticker->schedule(this, _next > 0.0 ? std::min(_next, _expire) : _expire);
+    }
+
+    /**
+     *  Method that is called when the timer expired
+     */
+    virtual void onExpired() override
+    {
+        // get the current time
+        double now = _ticker->now();
+
+        // if the onNegotiate method was not yet called, and no heartbeat timeout was negotiated
+        if (_timeout == 0)
+        {
+            // this can happen in three situations: 1. a connect-timeout, 2. user space has
+            // told us that we're not interested in heartbeats, 3. rabbitmq does not want heartbeats,
+            // in either case we're no longer going to run further timers.
+            _next = _expire = 0.0;
+
+            // if we have an initialized connection, user-space must have overridden the onNegotiate
+            // method, so we keep using the connection
+            if (_connection->initialized()) return;
+
+            // this is a connection timeout, close the connection from our side too
+            return (void)_connection->close(true);
+        }
+
+        // the connection is alive as long as data is received, and heartbeats are only needed
+        // when nothing else was sent, so we base the deadlines on the activity of the connection,
+        // the expire time is set to 1.5 * _timeout to close the connection when the third
+        // heartbeat is about to be sent
+        _expire = now - elapsed(_connection->lastReceived()) + _timeout * 1.5;
+        _next = now - elapsed(_connection->lastSent()) + std::max(_timeout / 2, 1);
+
+        // check if the server was inactive for too long
+        if (now >= _expire)
+        {
+            // the server was inactive for a too long period of time, reset state (but remember
+            // the interval, so that the timer can be re-armed when the connection is recovered)
+            _next = _expire = 0.0;
+
+            // drop the socket because server was inactive, a recoverable connection is recovered
+            return (void)_connection->fail("heartbeat timeout");
+        }
+        else if (now >= _next)
+        {
+            // it's time for the next heartbeat
+            _connection->heartbeat();
+
+            // remember when we should send out the next one, so the next one should be
+            // sent only after _timout/2 seconds again _from now_ (no catching up)
+            _next = now + std::max(_timeout / 2, 1);
+        }
+
+        // schedule the timer again
+        schedule();
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  ticker          The timer wheel of the loop
+     *  @param  connection      The TCP connection
+     *  @param  timeout         Connect timeout
+     */
+    HeartbeatTimer(Ticker *ticker, TcpConnection *connection, uint16_t timeout) :
+        _connection(connection),
+        _ticker(ticker),
+        _expire(ticker->now() + timeout)
+    {
+        // schedule the timer (this is the time that we reserve for setting up the connection)
+        schedule();
+    }
+
+    /**
+     *  Timers cannot be copied or moved
+     *  @param  that
+     */
+    HeartbeatTimer(HeartbeatTimer &&that) = delete;
+    HeartbeatTimer(const HeartbeatTimer &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~HeartbeatTimer() = default;
+
+    /**
+     *  Start the timer (and expose the interval)
+     *  @param  interval        the heartbeat interval proposed by the server
+     *  @return uint16_t        the heartbeat interval that we accepted
+     */
+    uint16_t start(uint16_t timeout)
+    {
+        // we now know for sure that the connection was set up
+        _timeout = timeout;
+
+        // if heartbeats are disabled we do not have to set it
+        if (_timeout == 0) return 0;
+
+        // calculate current time
+        double now = _ticker->now();
+
+        // we also know when the next heartbeat should be sent
+        _next = now + std::max(_timeout / 2, 1);
+
+        // because the server has just sent us some data, we will update the expire time too
+        _expire = now + _timeout * 1.5;
+
+        // schedule the timer again
+        schedule();
+
+        // expose the accepted interval
+        return _timeout;
+    }
+
+    /**
+     *  Stop the timer, no heartbeats are sent or expected while the
+     *  connection is being recovered
+     */
+    void stop()
+    {
+        // forget about the deadlines
+        _next = _expire = 0.0;
+
+        // remove the timer from the wheel
+        _ticker->cancel(this);
+    }
+
+    /**
+     *  Re-arm the timer with the interval that was negotiated before
+     */
+    void restart()
+    {
+        // leap out if the timer is already running (onNegotiate() normally re-armed it)
+        if (_expire > 0.0) return;
+
+        // start with the same interval
+        start(_timeout);
+    }
+
+    /**
+     *  Check if the timer is associated with a certain connection
+     *  @param  connection
+     *  @return bool
+     */
+    bool contains(const TcpConnection *connection) const
+    {
+        // compare the connections
+        return _connection == connection;
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
@@ -1,11 +1,11 @@
 /**
  *  LibBoostAsio.h
  *
- *  Implementation for the AMQP::TcpHandler for boost::asio. You can use this class 
- *  instead of a AMQP::TcpHandler class, just pass the boost asio service to the 
- *  constructor and you're all set.  See tests/libboostasio.cpp for example.
+ *  Implementation for the AMQP::TcpHandler for boost::asio. You can use this class
+ *  instead of a AMQP::TcpHandler class, just pass the boost asio io_context to the
+ *  constructor and you're all set.  See examples/libboostasio.cpp for example.
  *
- *  Watch out: this class was not implemented or reviewed by the original author of 
+ *  Watch out: this class was not implemented or reviewed by the original author of
  *  AMQP-CPP. However, we do get a lot of questions and issues from users of this class,
  *  so we cannot guarantee its quality. If you run into such issues too, it might be
  *  better to implement your own handler that interact with boost.
@@ -23,24 +23,17 @@
 /**
  *  Dependencies
  */
+#include <map>
 #include <memory>
+#include <cstddef>
 
-#include <boost/asio/io_service.hpp>
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/strand.hpp>
-#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/bind_executor.hpp>
 #include <boost/asio/posix/stream_descriptor.hpp>
-#include <boost/bind.hpp>
-#include <boost/function.hpp>
 
 #include "amqpcpp/linux_tcp.h"
 
-// C++17 has 'weak_from_this()' support.
-#if __cplusplus >= 201701L
-#define PTR_FROM_THIS(T) weak_from_this()
-#else
-#define PTR_FROM_THIS(T) std::weak_ptr<T>(shared_from_this())
-#endif
-
 /**
  *  Set up namespace
  */
@@ -53,206 +46,275 @@ namespace AMQP {
 class LibBoostAsioHandler : public virtual TcpHandler
 {
 protected:
+    /**
+     *  The strand type that is used to serialize the callbacks
+     */
+    using strand_type = boost::asio::strand<boost::asio::io_context::executor_type>;
 
     /**
-     *  Helper class that wraps a boost io_service socket monitor.
+     *  Helper class that wraps a boost io_context socket monitor.
      */
-    class Watcher : public virtual std::enable_shared_from_this<Watcher>
+    class Watcher : public std::enable_shared_from_this<Watcher>
     {
     private:
-
         /**
-         *  The boost asio io_service which is responsible for detecting events.
-         *  @var class boost::asio::io_service&
+         *  Memory for the asynchronous operation that is pending in one direction. There
+         *  is never more than one wait per direction in progress, so the memory can be
+         *  recycled, and asio no longer has to allocate for every socket event.
          */
-        boost::asio::io_service & _ioservice;
+        class Memory
+        {
+        private:
+            /**
+             *  The buffer
+             *  @var unsigned char[]
+             */
+            alignas(std::max_align_t) unsigned char _buffer[256];
+
+            /**
+             *  Is the buffer in use?
+             *  @var bool
+             */
+            bool _used = false;
+
+        public:
+            /**
+             *  Allocate memory (falls back to the heap if the buffer is in use or too small)
+             *  @param  size
+             *  @return void*
+             */
+            void *allocate(std::size_t size)
+            {
+                // use the heap if we can not use the buffer
+                if (_used || size > sizeof(_buffer)) return ::operator new(size);
 
-        using strand_weak_ptr = std::weak_ptr<boost::asio::io_service::strand>;
-        
-        /**
-         *  The boost asio io_service::strand managed pointer.
-         *  @var class std::shared_ptr<boost::asio::io_service>
-         */
-        strand_weak_ptr _wpstrand;
+                // the buffer is now in use
+                _used = true;
+
+                // expose the buffer
+                return _buffer;
+            }
+
+            /**
+             *  Deallocate memory
+             *  @param  pointer
+             */
+            void deallocate(void *pointer)
+            {
+                // if this was the buffer, it can be used again
+                if (pointer == _buffer) _used = false;
+
+                // otherwise it came from the heap
+                else ::operator delete(pointer);
+            }
+        };
 
         /**
-         *  The boost tcp socket.
-         *  @var class boost::asio::ip::tcp::socket
-         *  @note https://stackoverflow.com/questions/38906711/destroying-boost-asio-socket-without-closing-native-handler
+         *  Allocator that is associated with the handlers, to allocate from the Memory
          */
-        boost::asio::posix::stream_descriptor _socket;
+        template <typename T>
+        class Allocator
+        {
+        private:
+            /**
+             *  The memory to allocate from
+             *  @var Memory
+             */
+            Memory *_memory;
+
+            /**
+             *  Allocators of other types are constructed from this one
+             */
+            template <typename U> friend class Allocator;
+
+        public:
+            /**
+             *  The type that is allocated
+             */
+            using value_type = T;
+
+            /**
+             *  Constructor
+             *  @param  memory
+             */
+            explicit Allocator(Memory *memory) : _memory(memory) {}
+
+            /**
+             *  Constructor from an allocator of another type
+             *  @param  that
+             */
+            template <typename U>
+            Allocator(const Allocator<U> &that) : _memory(that._memory) {}
+
+            /**
+             *  Allocate objects
+             *  @param  count
+             *  @return T*
+             */
+            T *allocate(std::size_t count) { return static_cast<T*>(_memory->allocate(sizeof(T) * count)); }
+
+            /**
+             *  Deallocate objects
+             *  @param  pointer
+             *  @param  count
+             */
+            void deallocate(T *pointer, std::size_t count) { _memory->deallocate(pointer); }
+
+            /**
+             *  Compare allocators
+             *  @param  that
+             *  @return bool
+             */
+            template <typename U>
+            bool operator==(const Allocator<U> &that) const { return _memory == that._memory; }
+            template <typename U>
+            bool operator!=(const Allocator<U> &that) const { return _memory != that._memory; }
+        };
 
         /**
-         *  A boolean that indicates if the watcher is monitoring for read events.
-         *  @var _read True if reads are being monitored else false.
+         *  The completion handler of a wait. It keeps the watcher alive for as long
+         *  as the wait is in progress, because the memory of the wait lives in it.
          */
-        bool _read{false};
+        class Handler
+        {
+        private:
+            /**
+             *  The watcher that started the wait
+             *  @var std::shared_ptr<Watcher>
+             */
+            std::shared_ptr<Watcher> _watcher;
+
+            /**
+             *  The event that we waited for (readable or writable)
+             *  @var int
+             */
+            int _event;
+
+        public:
+            /**
+             *  The allocator that asio uses for the operation
+             */
+            using allocator_type = Allocator<void>;
+
+            /**
+             *  Constructor
+             *  @param  watcher
+             *  @param  event
+             */
+            Handler(std::shared_ptr<Watcher> &&watcher, int event) : _watcher(std::move(watcher)), _event(event) {}
+
+            /**
+             *  Expose the allocator
+             *  @return allocator_type
+             */
+            allocator_type get_allocator() const noexcept
+            {
+                return allocator_type(&_watcher->_memory[_event == AMQP::readable ? 0 : 1]);
+            }
+
+            /**
+             *  Called by asio when the wait is over
+             *  @param  error
+             */
+            void operator()(const boost::system::error_code &error)
+            {
+                _watcher->onActive(_event, error);
+            }
+        };
 
         /**
-         *  A boolean that indicates if the watcher has a pending read event.
-         *  @var _read True if read is pending else false.
+         *  The strand to serialize the callbacks (nullptr in single-threaded mode)
+         *  @var strand_type
          */
-        bool _read_pending{false};
+        const strand_type *_strand;
 
         /**
-         *  A boolean that indicates if the watcher is monitoring for write events.
-         *  @var _read True if writes are being monitored else false.
+         *  The boost descriptor that is used to wait for the filedescriptor.
+         *  @var class boost::asio::posix::stream_descriptor
+         *  @note https://stackoverflow.com/questions/38906711/destroying-boost-asio-socket-without-closing-native-handler
          */
-        bool _write{false};
+        boost::asio::posix::stream_descriptor _socket;
 
         /**
-         *  A boolean that indicates if the watcher has a pending write event.
-         *  @var _read True if read is pending else false.
+         *  The connection that is monitored
+         *  @var TcpConnection
          */
-        bool _write_pending{false};
-
-        using handler_cb = boost::function<void(boost::system::error_code,std::size_t)>;
-        using io_handler = boost::function<void(const boost::system::error_code&, const std::size_t)>;
+        TcpConnection *_connection = nullptr;
 
         /**
-         * Builds a io handler callback that executes the io callback in a strand.
-         * @param  io_handler  The handler callback to dispatch
-         * @return handler_cb  A function wrapping the execution of the handler function in a io_service::strand.
+         *  Recycled memory for the read and write waits
+         *  @var Memory[]
          */
-        handler_cb get_dispatch_wrapper(io_handler fn)
-        {
-            const strand_weak_ptr wpstrand = _wpstrand;
+        Memory _memory[2];
 
-            return [fn, wpstrand](const boost::system::error_code &ec, const std::size_t bytes_transferred)
-            {
-                const strand_shared_ptr strand = wpstrand.lock();
-                if (!strand)
-                {
-                    fn(boost::system::errc::make_error_code(boost::system::errc::operation_canceled), std::size_t{0});
-                    return;
-                }
-                strand->dispatch(boost::bind(fn, ec, bytes_transferred));
-            };
-        }
-        
         /**
-         * Binds and returns a read handler for the io operation.
-         * @param  connection   The connection being watched.
-         * @param  fd           The file descripter being watched.
-         * @return handler callback
+         *  The events for which the filedescriptor is monitored
+         *  @var int
          */
-        handler_cb get_read_handler(TcpConnection *const connection, const int fd)
-        {
-            auto fn = boost::bind(&Watcher::read_handler,
-                                  this,
-                                  _1,
-                                  _2,
-                                  PTR_FROM_THIS(Watcher),
-                                  connection,
-                                  fd);
-            return get_dispatch_wrapper(fn);
-        }
+        int _events = 0;
 
         /**
-         * Binds and returns a read handler for the io operation.
-         * @param  connection   The connection being watched.
-         * @param  fd           The file descripter being watched.
-         * @return handler callback
+         *  The events for which a wait is in progress
+         *  @var int
          */
-        handler_cb get_write_handler(TcpConnection *const connection, const int fd)
-        {
-            auto fn = boost::bind(&Watcher::write_handler,
-                                  this,
-                                  _1,
-                                  _2,
-                                  PTR_FROM_THIS(Watcher),
-                                  connection,
-                                  fd);
-            return get_dispatch_wrapper(fn);
-        }
+        int _pending = 0;
 
         /**
-         *  Handler method that is called by boost's io_service when the socket pumps a read event.
-         *  @param  ec          The status of the callback.
-         *  @param  bytes_transferred The number of bytes transferred.
-         *  @param  awpWatcher  A weak pointer to this object.
-         *  @param  connection  The connection being watched.
-         *  @param  fd          The file descriptor being watched.
-         *  @note   The handler will get called if a read is cancelled.
+         *  Start waiting for an event
+         *  @param  event       readable or writable
          */
-        void read_handler(const boost::system::error_code &ec,
-                          const std::size_t bytes_transferred,
-                          const std::weak_ptr<Watcher> awpWatcher,
-                          TcpConnection *const connection,
-                          const int fd)
+        void wait(int event)
         {
-            // Resolve any potential problems with dangling pointers
-            // (remember we are using async).
-            const std::shared_ptr<Watcher> apWatcher = awpWatcher.lock();
-            if (!apWatcher) { return; }
+            // leap out if we are already waiting
+            if (_pending & event) return;
 
-            _read_pending = false;
+            // we are now waiting
+            _pending |= event;
 
-            if ((!ec || ec == boost::asio::error::would_block) && _read)
-            {
-                connection->process(fd, AMQP::readable);
+            // the type of wait
+            auto type = event == AMQP::readable ? boost::asio::posix::descriptor_base::wait_read : boost::asio::posix::descriptor_base::wait_write;
 
-                _read_pending = true;
-                
-                _socket.async_read_some(
-                    boost::asio::null_buffers(),
-                    get_read_handler(connection, fd));
-            }
+            // the handler to call when the wait is over
+            Handler handler(shared_from_this(), event);
+
+            // in single-threaded mode the handler can be called right away
+            if (_strand == nullptr) return _socket.async_wait(type, std::move(handler));
+
+            // otherwise it is called in the strand
+            _socket.async_wait(type, boost::asio::bind_executor(*_strand, std::move(handler)));
         }
 
         /**
-         *  Handler method that is called by boost's io_service when the socket pumps a write event.
-         *  @param  ec          The status of the callback.
-         *  @param  bytes_transferred The number of bytes transferred.
-         *  @param  awpWatcher  A weak pointer to this object.
-         *  @param  connection  The connection being watched.
-         *  @param  fd          The file descriptor being watched.
-         *  @note   The handler will get called if a write is cancelled.
+         *  Method that is called when a wait is over
+         *  @param  event       the event that we waited for
+         *  @param  error       the status of the wait
          */
-        void write_handler(const boost::system::error_code ec,
-                           const std::size_t bytes_transferred,
-                           const std::weak_ptr<Watcher> awpWatcher,
-                           TcpConnection *const connection,
-                           const int fd)
+        void onActive(int event, const boost::system::error_code &error)
         {
-            // Resolve any potential problems with dangling pointers
-            // (remember we are using async).
-            const std::shared_ptr<Watcher> apWatcher = awpWatcher.lock();
-            if (!apWatcher) { return; }
+            // we are no longer waiting
+            _pending &= ~event;
 
-            _write_pending = false;
-
-            if ((!ec || ec == boost::asio::error::would_block) && _write)
-            {
-                connection->process(fd, AMQP::writable);
+            // leap out if the wait was cancelled, or if the event is no longer needed
+            if (error == boost::asio::error::operation_aborted || !(_events & event)) return;
 
-                _write_pending = true;
+            // tell the connection (on other errors too, the connection will find out what is wrong)
+            _connection->process(_socket.native_handle(), event);
 
-                _socket.async_write_some(
-                    boost::asio::null_buffers(),
-                    get_write_handler(connection, fd));
-            }
+            // wait for the next event (if it is still needed)
+            if (_events & event) wait(event);
         }
 
     public:
         /**
-         *  Constructor- initialises the watcher and assigns the filedescriptor to 
-         *  a boost socket for monitoring.
-         *  @param  io_service      The boost io_service
-         *  @param  wpstrand        A weak pointer to a io_service::strand instance.
+         *  Constructor- initialises the watcher and assigns the filedescriptor to
+         *  a boost descriptor for monitoring.
+         *  @param  io_context      The boost io_context
+         *  @param  strand          The strand for the callbacks (nullptr for none)
          *  @param  fd              The filedescriptor being watched
          */
-        Watcher(boost::asio::io_service &io_service,
-                const strand_weak_ptr wpstrand,
-                const int fd) :
-            _ioservice(io_service),
-            _wpstrand(wpstrand),
-            _socket(_ioservice)
-        {
-            _socket.assign(fd);
-
-            _socket.non_blocking(true);
-        }
+        Watcher(boost::asio::io_context &io_context, const strand_type *strand, const int fd) :
+            _strand(strand),
+            _socket(io_context, fd) {}
 
         /**
          *  Watchers cannot be copied or moved
@@ -267,208 +329,56 @@ protected:
          */
         ~Watcher()
         {
-            _read = false;
-            _write = false;
-            _socket.release();
+            // the filedescriptor is owned by the connection, we should not close it
+            if (_socket.is_open()) _socket.release();
         }
 
         /**
          *  Change the events for which the filedescriptor is monitored
-         *  @param  events
-         */
-        void events(TcpConnection *connection, int fd, int events)
-        {
-            // 1. Handle reads?
-            _read = ((events & AMQP::readable) != 0);
-
-            // Read requsted but no read pending?
-            if (_read && !_read_pending)
-            {
-                _read_pending = true;
-
-                _socket.async_read_some(
-                    boost::asio::null_buffers(),
-                    get_read_handler(connection, fd));
-            }
-
-            // 2. Handle writes?
-            _write = ((events & AMQP::writable) != 0);
-
-            // Write requested but no write pending?
-            if (_write && !_write_pending)
-            {
-                _write_pending = true;
-
-                _socket.async_write_some(
-                    boost::asio::null_buffers(),
-                    get_write_handler(connection, fd));
-            }
-        }
-    };
-
-    /**
-     *  Timer class to periodically fire a heartbeat
-     */
-    class Timer : public std::enable_shared_from_this<Timer>
-    {
-    private:
-
-        /**
-         *  The boost asio io_service which is responsible for detecting events.
-         *  @var class boost::asio::io_service&
-         */
-        boost::asio::io_service & _ioservice;
-
-        using strand_weak_ptr = std::weak_ptr<boost::asio::io_service::strand>;
-
-        /**
-         *  The boost asio io_service::strand managed pointer.
-         *  @var class std::shared_ptr<boost::asio::io_service>
-         */
-        strand_weak_ptr _wpstrand;
-
-        /**
-         *  The boost asynchronous deadline timer.
-         *  @var class boost::asio::deadline_timer
-         */
-        boost::asio::deadline_timer _timer;
-
-        using handler_fn = boost::function<void(boost::system::error_code)>;
-
-        /**
-         * Binds and returns a lamba function handler for the io operation.
-         * @param  connection   The connection being watched.
-         * @param  timeout      The file descripter being watched.
-         * @return handler callback
-         */
-        handler_fn get_handler(TcpConnection *const connection, const uint16_t timeout)
-        {
-            const auto fn = boost::bind(&Timer::timeout,
-                                  this,
-                                  _1,
-                                  PTR_FROM_THIS(Timer),
-                                  connection,
-                                  timeout);
-
-            const strand_weak_ptr wpstrand = _wpstrand;
-
-            return [fn, wpstrand](const boost::system::error_code &ec)
-            {
-                const strand_shared_ptr strand = wpstrand.lock();
-                if (!strand)
-                {
-                    fn(boost::system::errc::make_error_code(boost::system::errc::operation_canceled));
-                    return;
-                }
-                strand->dispatch(boost::bind(fn, ec));
-            };
-        }
-
-        /**
-         *  Callback method that is called by libev when the timer expires
-         *  @param  ec          error code returned from loop
-         *  @param  loop        The loop in which the event was triggered
          *  @param  connection
-         *  @param  timeout
+         *  @param  events
          */
-        void timeout(const boost::system::error_code &ec,
-                     std::weak_ptr<Timer> awpThis,
-                     TcpConnection *const connection,
-                     const uint16_t timeout)
+        void events(TcpConnection *connection, int events)
         {
-            // Resolve any potential problems with dangling pointers
-            // (remember we are using async).
-            const std::shared_ptr<Timer> apTimer = awpThis.lock();
-            if (!apTimer) { return; }
+            // remember the connection and the events
+            _connection = connection;
+            _events = events;
 
-            if (!ec)
-            {
-                if (connection)
-                {
-                    // send the heartbeat
-                    connection->heartbeat();
-                }
-
-                // Reschedule the timer for the future:
-                _timer.expires_at(_timer.expires_at() + boost::posix_time::seconds(timeout));
-
-                // Posts the timer event
-                _timer.async_wait(get_handler(connection, timeout));
-            }
+            // start waiting for the events (if we are not yet doing that)
+            if (events & AMQP::readable) wait(AMQP::readable);
+            if (events & AMQP::writable) wait(AMQP::writable);
         }
 
         /**
-         *  Stop the timer
+         *  Stop monitoring, the waits that are in progress are cancelled
          */
         void stop()
         {
-            // do nothing if it was never set
-            _timer.cancel();
-        }
-
-    public:
-        /**
-         *  Constructor
-         *  @param  io_service The boost asio io_service.
-         *  @param  wpstrand   A weak pointer to a io_service::strand instance.
-         */
-        Timer(boost::asio::io_service &io_service,
-              const strand_weak_ptr wpstrand) :
-              _ioservice(io_service),
-              _wpstrand(wpstrand),
-              _timer(_ioservice)
-        {
-
-        }
-
-        /**
-         *  Timers cannot be copied or moved
-         *
-         *  @param  that    The object to not move or copy
-         */
-        Timer(Timer &&that) = delete;
-        Timer(const Timer &that) = delete;
-
-        /**
-         *  Destructor
-         */
-        ~Timer()
-        {
-            // stop the timer
-            stop();
-        }
+            // no more events
+            _events = 0;
 
-        /**
-         *  Change the expire time
-         *  @param  connection
-         *  @param  timeout
-         */
-        void set(TcpConnection *connection, uint16_t timeout)
-        {
-            // stop timer in case it was already set
-            stop();
-
-            // Reschedule the timer for the future:
-            _timer.expires_from_now(boost::posix_time::seconds(timeout));
-
-            // Posts the timer event
-            _timer.async_wait(get_handler(connection, timeout));
+            // release the filedescriptor (this also cancels the waits)
+            if (_socket.is_open()) _socket.release();
         }
     };
 
     /**
-     *  The boost asio io_service.
-     *  @var class boost::asio::io_service&
+     *  The boost asio io_context.
+     *  @var class boost::asio::io_context&
      */
-    boost::asio::io_service & _ioservice;
+    boost::asio::io_context & _iocontext;
 
-    using strand_shared_ptr = std::shared_ptr<boost::asio::io_service::strand>;
+    /**
+     *  The strand that serializes the callbacks
+     *  @var strand_type
+     */
+    strand_type _strand;
 
     /**
-     *  The boost asio io_service::strand managed pointer.
-     *  @var class std::shared_ptr<boost::asio::io_service>
+     *  Should the strand be used? (false in single-threaded mode)
+     *  @var bool
      */
-    strand_shared_ptr _strand;
+    bool _threadsafe;
 
     /**
      *  All I/O watchers that are active, indexed by their filedescriptor
@@ -476,13 +386,6 @@ protected:
      */
     std::map<int, std::shared_ptr<Watcher> > _watchers;
 
-    /**
-     * The boost asio io_service::deadline_timer managed pointer.
-     * THIS IS DISABLED FOR NOW BECAUSE THIS BREAKS IF THERE IS MORE THAN ONE CONNECTION
-     * @var class std::shared_ptr<Timer>
-     */
-    //std::shared_ptr<Timer> _timer;
-
     /**
      *  Method that is called by AMQP-CPP to register a filedescriptor for readability or writability
      *  @param  connection  The TCP connection object that is reporting
@@ -502,49 +405,28 @@ protected:
             // we did not yet have this watcher - but that is ok if no filedescriptor was registered
             if (flags == 0){ return; }
 
-            // construct a new pair (watcher/timer), and put it in the map
-            const std::shared_ptr<Watcher> apWatcher = 
-                std::make_shared<Watcher>(_ioservice, _strand, fd);
+            // construct a new watcher, and put it in the map
+            const std::shared_ptr<Watcher> apWatcher =
+                std::make_shared<Watcher>(_iocontext, _threadsafe ? &_strand : nullptr, fd);
 
             _watchers[fd] = apWatcher;
 
             // explicitly set the events to monitor
-            apWatcher->events(connection, fd, flags);
+            apWatcher->events(connection, flags);
         }
         else if (flags == 0)
         {
             // the watcher does already exist, but we no longer have to watch this watcher
+            iter->second->stop();
             _watchers.erase(iter);
         }
         else
         {
             // Change the events on which to act.
-            iter->second->events(connection,fd,flags);
+            iter->second->events(connection, flags);
         }
     }
 
-protected:
-    /**
-     *  Method that is called when the heartbeat frequency is negotiated between the server and the client.
-     *  @param  connection      The connection that suggested a heartbeat interval
-     *  @param  interval        The suggested interval from the server
-     *  @return uint16_t        The interval to use
-     */
-    /* THIS IS DISABLED FOR NOW BECAUSE THIS BREAKS IF THERE IS MORE THAN ONE CONNECTION */
-    /*
-    virtual uint16_t onNegotiate(TcpConnection *connection, uint16_t interval) override
-    {
-        // skip if no heartbeats are needed
-        if (interval == 0) return 0;
-
-        // set the timer
-        _timer->set(connection, interval);
-
-        // we agree with the interval
-        return interval;
-    }
-    */
-
 public:
 
     /**
@@ -556,15 +438,19 @@ public:
 
     /**
      *  Constructor
-     *  @param  io_service    The boost io_service to wrap
+     *
+     *  If the io_context is run by more than one thread, all callbacks are
+     *  serialized in a strand. If only a single thread runs the io_context, you
+     *  can pass threadsafe=false to skip the strand and save a dispatch per
+     *  socket event.
+     *
+     *  @param  io_context    The boost io_context to wrap
+     *  @param  threadsafe    Serialize the callbacks in a strand?
      */
-    explicit LibBoostAsioHandler(boost::asio::io_service &io_service) :
-        _ioservice(io_service),
-        _strand(std::make_shared<boost::asio::io_service::strand>(_ioservice))
-        //_timer(std::make_shared<Timer>(_ioservice,_strand))
-    {
-
-    }
+    explicit LibBoostAsioHandler(boost::asio::io_context &io_context, bool threadsafe = true) :
+        _iocontext(io_context),
+        _strand(io_context.get_executor()),
+        _threadsafe(threadsafe) {}
 
     /**
      *  Handler cannot be copied or moved
@@ -575,18 +461,22 @@ public:
     LibBoostAsioHandler(const LibBoostAsioHandler &that) = delete;
 
     /**
-     *  Returns a reference to the boost io_service object that is being used.
-     *  @return The boost io_service object.
+     *  Returns a reference to the boost io_context object that is being used.
+     *  @return The boost io_context object.
      */
-    boost::asio::io_service &service()
+    boost::asio::io_context &service()
     {
-       return _ioservice;
+       return _iocontext;
     }
 
     /**
      *  Destructor
      */
-    ~LibBoostAsioHandler() override = default;
+    ~LibBoostAsioHandler() override
+    {
+        // cancel the waits that are still in progress
+        for (auto &watcher : _watchers) watcher.second->stop();
+    }
 };
 
 
@@ -8,7 +8,7 @@
  *  Compile with: "g++ -std=c++11 libev.cpp -lamqpcpp -lev -lpthread"
  *
  *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
- *  @copyright 2015 - 2018 Copernica BV
+ *  @copyright 2015 - 2020 Copernica BV
  */
 
 /**
@@ -22,6 +22,8 @@
 #include <ev.h>
 #include <list>
 #include "amqpcpp/linux_tcp.h"
+#include "amqpcpp/timerwheel.h"
+#include "amqpcpp/heartbeattimer.h"
 
 /**
  *  Set up namespace
@@ -46,11 +48,6 @@ private:
          *  @param  events
          */
         virtual void onActive(int fd, int events) = 0;
-        
-        /**
-         *  Method that is called when the timer expires
-         */
-        virtual void onExpired() = 0;
     };
 
     /**
@@ -148,18 +145,13 @@ private:
     };
 
     /**
-     *  Wrapper around a connection, this will monitor the filedescriptors
-     *  and run a timer to send out heartbeats
+     *  The timer wheel for all connections on the loop, with the one and
+     *  only libev timer that moves it forward (once per second, and only
+     *  as long as there are connections that need a timer)
      */
-    class Wrapper : private Watchable
+    class Ticker : public TimerWheel
     {
     private:
-        /**
-         *  The connection that is monitored
-         *  @var TcpConnection
-         */
-        TcpConnection *_connection;
-    
         /**
          *  The event loop to which it is attached
          *  @var struct ev_loop
@@ -168,36 +160,9 @@ private:
 
         /**
          *  The watcher for the timer
-         *  @var struct ev_io
+         *  @var struct ev_timer
          */
         struct ev_timer _timer;
-        
-        /**
-         *  IO-watchers to monitor filedescriptors
-         *  @var std::list
-         */
-        std::list<Watcher> _watchers;
-        
-        /**
-         *  When should we send the next heartbeat?
-         *  @var ev_tstamp
-         */
-        ev_tstamp _next = 0.0;
-        
-        /**
-         *  When does the connection expire / was the server for a too longer period of time idle?
-         *  During connection setup, this member is used as the connect-timeout.
-         *  @var ev_tstamp
-         */
-        ev_tstamp _expire;
-        
-        /**
-         *  Timeout after which the connection is no longer considered alive.
-         *  A heartbeat must be sent every _timeout / 2 seconds.
-         *  Value zero means heartbeats are disabled, or not yet negotiated.
-         *  @var uint16_t
-         */
-        uint16_t _timeout = 0;
 
         /**
          *  Callback method that is called by libev when the timer expires
@@ -208,76 +173,103 @@ private:
         static void callback(struct ev_loop *loop, struct ev_timer *timer, int revents)
         {
             // retrieve the object
-            Watchable *object = static_cast<Watchable*>(timer->data);
+            Ticker *ticker = static_cast<Ticker*>(timer->data);
 
-            // tell the object that it expired
-            object->onExpired();
+            // move the wheel forward
+            ticker->advance(ev_now(loop));
+
+            // stop the timer if nothing is scheduled any more
+            if (ticker->empty()) ticker->stop();
         }
-        
+
         /**
-         *  Do we need timers / is this a timed monitor?
-         *  @return bool
+         *  Stop the timer
          */
-        bool timed() const
+        void stop()
         {
-            // if neither timers are set
-            return _expire > 0.0 || _next > 0.0;
+            // leap out if not running
+            if (!ev_is_active(&_timer)) return;
+
+            // the timer was unref'ed when it was started, so we restore the refcount
+            ev_ref(_loop);
+
+            // stop the timer
+            ev_timer_stop(_loop, &_timer);
         }
-        
+
+    public:
         /**
-         *  Method that is called when the timer expired
+         *  Constructor
+         *  @param  loop            The current event loop
          */
-        virtual void onExpired() override
+        Ticker(struct ev_loop *loop) : TimerWheel(ev_now(loop)), _loop(loop)
         {
-            // get the current time
-            ev_tstamp now = ev_now(_loop);
-            
-            // timer is no longer active, so the refcounter in the loop is restored
-            ev_ref(_loop);
+            // initialize the libev structure, it repeats every tick
+            ev_timer_init(&_timer, callback, interval(), interval());
 
-            // if the onNegotiate method was not yet called, and no heartbeat timeout was negotiated
-            if (_timeout == 0)
-            {
-                // this can happen in three situations: 1. a connect-timeout, 2. user space has
-                // told us that we're not interested in heartbeats, 3. rabbitmq does not want heartbeats,
-                // in either case we're no longer going to run further timers.
-                _next = _expire = 0.0;
-                
-                // if we have an initialized connection, user-space must have overridden the onNegotiate
-                // method, so we keep using the connection
-                if (_connection->initialized()) return;
+            // store the object in the data "void*"
+            _timer.data = this;
+        }
 
-                // this is a connection timeout, close the connection from our side too
-                return (void)_connection->close(true);
-            }
-            else if (now >= _expire)
-            {
-                // the server was inactive for a too long period of time, reset state
-                _next = _expire = 0.0; _timeout = 0;
-                
-                // close the connection because server was inactive
-                return (void)_connection->close();
-            }
-            else if (now >= _next)
-            {
-                // it's time for the next heartbeat
-                _connection->heartbeat();
-                
-                // remember when we should send out the next one, so the next one should be 
-                // sent only after _timout/2 seconds again _from now_ (no catching up)
-                _next = now + std::max(_timeout / 2, 1);
-            }
-            
-            // reset the timer to trigger again later
-            _timer.repeat = std::min(_next, _expire) - now;
-            
-            // restart the timer
-            ev_timer_again(_loop, &_timer);
-            
-            // and because the timer is running again, we restore the refcounter
+        /**
+         *  Destructor
+         */
+        virtual ~Ticker()
+        {
+            // stop the timer
+            stop();
+        }
+
+        /**
+         *  The current time of the loop, in seconds
+         *  @return double
+         */
+        double now() const
+        {
+            // the time that the loop started its current iteration
+            return ev_now(_loop);
+        }
+
+        /**
+         *  Schedule a timer (and make sure the wheel is moving)
+         *  @param  timer       the timer to schedule
+         *  @param  expire      the time at which it expires
+         */
+        void schedule(Timer *timer, ev_tstamp expire)
+        {
+            // add to the wheel
+            TimerWheel::schedule(timer, expire);
+
+            // leap out if the timer is already running
+            if (ev_is_active(&_timer)) return;
+
+            // start the timer
+            ev_timer_start(_loop, &_timer);
+
+            // the timer should not keep the event loop active
             ev_unref(_loop);
         }
-        
+    };
+
+    /**
+     *  Wrapper around a connection, this will monitor the filedescriptors
+     *  and use the timer wheel to send out heartbeats
+     */
+    class Wrapper : private Watchable, public HeartbeatTimer<Ticker>
+    {
+    private:
+        /**
+         *  The event loop to which it is attached
+         *  @var struct ev_loop
+         */
+        struct ev_loop *_loop;
+
+        /**
+         *  IO-watchers to monitor filedescriptors
+         *  @var std::list
+         */
+        std::list<Watcher> _watchers;
+
         /**
          *  Method that is called when a filedescriptor becomes active
          *  @param  fd          the filedescriptor that is active
@@ -285,10 +277,6 @@ private:
          */
         virtual void onActive(int fd, int events) override
         {
-            // if the server is readable, we have some extra time before it expires, the expire time 
-            // is set to 1.5 * _timeout to close the connection when the third heartbeat is about to be sent
-            if (_timeout != 0 && (events & EV_READ)) _expire = ev_now(_loop) + _timeout * 1.5;
-            
             // pass on to the connection
             _connection->process(fd, events);
         }
@@ -297,28 +285,13 @@ private:
         /**
          *  Constructor
          *  @param  loop            The current event loop
+         *  @param  ticker          The timer wheel of the loop
          *  @param  connection      The TCP connection
          *  @param  timeout         Connect timeout
          */
-        Wrapper(struct ev_loop *loop, AMQP::TcpConnection *connection, uint16_t timeout = 60) : 
-            _connection(connection),
-            _loop(loop),
-            _next(0.0),
-            _expire(ev_now(loop) + timeout),
-            _timeout(0)
-        {
-            // store the object in the data "void*"
-            _timer.data = this;
-            
-            // initialize the libev structure, it should expire after the connection timeout
-            ev_timer_init(&_timer, callback, timeout, 0.0);
-
-            // start the timer (this is the time that we reserve for setting up the connection)
-            ev_timer_start(_loop, &_timer);
-
-            // the timer should not keep the event loop active
-            ev_unref(_loop);
-        }
+        Wrapper(struct ev_loop *loop, Ticker *ticker, AMQP::TcpConnection *connection, uint16_t timeout = 60) :
+            HeartbeatTimer(ticker, connection, timeout),
+            _loop(loop) {}
 
         /**
          *  Watchers cannot be copied or moved
@@ -331,61 +304,8 @@ private:
         /**
          *  Destructor
          */
-        virtual ~Wrapper()
-        {
-            // the timer was already stopped
-            if (!timed()) return;
-
-            // stop the timer
-            ev_timer_stop(_loop, &_timer);
-
-            // restore loop refcount
-            ev_ref(_loop);
-        }
+        virtual ~Wrapper() = default;
 
-        /**
-         *  Start the timer (and expose the interval)
-         *  @param  interval        the heartbeat interval proposed by the server
-         *  @return uint16_t        the heartbeat interval that we accepted
-         */
-        uint16_t start(uint16_t timeout)
-        {
-            // we now know for sure that the connection was set up
-            _timeout = timeout;
-            
-            // if heartbeats are disabled we do not have to set it
-            if (_timeout == 0) return 0;
-            
-            // calculate current time
-            auto now = ev_now(_loop);
-            
-            // we also know when the next heartbeat should be sent
-            _next = now + std::max(_timeout / 2, 1);
-            
-            // because the server has just sent us some data, we will update the expire time too
-            _expire = now + _timeout * 1.5;
-
-            // find the earliest thing that expires
-            _timer.repeat = std::min(_next, _expire) - now;
-            
-            // restart the timer
-            ev_timer_again(_loop, &_timer);
-            
-            // expose the accepted interval
-            return _timeout;
-        }
-        
-        /**
-         *  Check if the timer is associated with a certain connection
-         *  @param  connection
-         *  @return bool
-         */
-        bool contains(const AMQP::TcpConnection *connection) const
-        {
-            // compare the connections
-            return _connection == connection;
-        }
-        
         /**
          *  Monitor a filedescriptor
          *  @param  fd
@@ -427,6 +347,12 @@ private:
      */
     struct ev_loop *_loop;
     
+    /**
+     *  The timer wheel that is shared by all connections
+     *  @var Ticker
+     */
+    Ticker _ticker;
+    
     /**
      *  Each connection is wrapped
      *  @var std::list
@@ -448,7 +374,7 @@ private:
         }
         
         // add to the wrappers
-        _wrappers.emplace_back(_loop, connection);
+        _wrappers.emplace_back(_loop, &_ticker, connection);
         
         // done
         return _wrappers.back();
@@ -479,6 +405,34 @@ protected:
         return lookup(connection).start(timeout);
     }
 
+    /**
+     *  Method that is called when a lost connection is about to be recovered
+     *  @param  connection      The TCP connection
+     *  @param  attempt         Number of the attempt
+     *  @return bool            Should the connection be recovered?
+     */
+    virtual bool onRecovering(TcpConnection *connection, size_t attempt) override
+    {
+        // the timer should not expire during the backoff
+        lookup(connection).stop();
+
+        // keep trying
+        return TcpHandler::onRecovering(connection, attempt);
+    }
+
+    /**
+     *  Method that is called when a lost connection has been recovered
+     *  @param  connection      The TCP connection
+     */
+    virtual void onRecovered(TcpConnection *connection) override
+    {
+        // check the heartbeats again
+        lookup(connection).restart();
+
+        // pass on to the base
+        TcpHandler::onRecovered(connection);
+    }
+
     /**
      *  Method that is called when the TCP connection is destructed
      *  @param  connection  The TCP connection
@@ -496,7 +450,7 @@ public:
      *  Constructor
      *  @param  loop    The event loop to wrap
      */
-    LibEvHandler(struct ev_loop *loop) : _loop(loop) {}
+    LibEvHandler(struct ev_loop *loop) : _loop(loop), _ticker(loop) {}
 
     /**
      *  Destructor
@@ -19,8 +19,11 @@
  *  Dependencies
  */
 #include <event2/event.h>
+#include <list>
 #include <amqpcpp/flags.h>
 #include <amqpcpp/linux_tcp.h>
+#include <amqpcpp/timerwheel.h>
+#include <amqpcpp/heartbeattimer.h>
 
 /**
  *  Set up namespace
@@ -34,7 +37,21 @@ class LibEventHandler : public TcpHandler
 {
 private:
     /**
-     *  Helper class that wraps a libev I/O watcher
+     *  Internal interface for the object that is being watched
+     */
+    class Watchable
+    {
+    public:
+        /**
+         *  The method that is called when a filedescriptor becomes active
+         *  @param  fd
+         *  @param  events
+         */
+        virtual void onActive(int fd, int events) = 0;
+    };
+
+    /**
+     *  Helper class that wraps a libevent I/O watcher
      */
     class Watcher
     {
@@ -49,12 +66,12 @@ private:
          *  Callback method that is called by libevent when a filedescriptor becomes active
          *  @param  fd                   The filedescriptor with an event
          *  @param  what                 Events triggered
-         *  @param  connection_arg       void * to the connection
+         *  @param  object_arg           void * to the watched object
          */
-        static void callback(evutil_socket_t fd, short what, void *connection_arg)
+        static void callback(evutil_socket_t fd, short what, void *object_arg)
         {
-            // retrieve the connection
-            TcpConnection *connection = static_cast<TcpConnection*>(connection_arg);
+            // retrieve the watched object
+            Watchable *object = static_cast<Watchable*>(object_arg);
 
             // setup amqp flags
             int amqp_flags = 0;
@@ -63,19 +80,19 @@ private:
             if (what & EV_WRITE)
                 amqp_flags |= AMQP::writable;
 
-            // tell the connection that its filedescriptor is active
-            connection->process(fd, amqp_flags);
+            // tell the object that its filedescriptor is active
+            object->onActive(fd, amqp_flags);
         }
 
     public:
         /**
          *  Constructor
          *  @param  evbase          The current event loop
-         *  @param  connection      The connection being watched
+         *  @param  object          The object being watched
          *  @param  fd              The filedescriptor being watched
          *  @param  events          The events that should be monitored
          */
-        Watcher(struct event_base *evbase, TcpConnection *connection, int fd, int events)
+        Watcher(struct event_base *evbase, Watchable *object, int fd, int events)
         {
             // setup libevent flags
             short event_flags = EV_PERSIST;
@@ -86,10 +103,18 @@ private:
 
             // initialize the event
 
-            _event = event_new(evbase, fd, event_flags, callback, connection);
+            _event = event_new(evbase, fd, event_flags, callback, object);
             event_add(_event, nullptr);
         }
 
+        /**
+         *  Watchers cannot be copied or moved
+         *
+         *  @param  that    The object to not move or copy
+         */
+        Watcher(Watcher &&that) = delete;
+        Watcher(const Watcher &that) = delete;
+
         /**
          *  Destructor
          */
@@ -101,6 +126,13 @@ private:
             event_free(_event);
         }
 
+        /**
+         *  Check if a filedescriptor is covered by the watcher
+         *  @param  fd
+         *  @return bool
+         */
+        bool contains(int fd) const { return event_get_fd(_event) == fd; }
+
         /**
          *  Change the events for which the filedescriptor is monitored
          *  @param  events
@@ -126,6 +158,225 @@ private:
         }
     };
 
+    /**
+     *  The timer wheel for all connections on the loop, with the one and
+     *  only libevent timer that moves it forward (once per second, and only
+     *  as long as there are connections that need a timer)
+     */
+    class Ticker : public TimerWheel
+    {
+    private:
+        /**
+         *  The event loop to which it is attached
+         *  @var struct event_base
+         */
+        struct event_base *_evbase;
+
+        /**
+         *  The timer event
+         *  @var struct event
+         */
+        struct event *_timer;
+
+        /**
+         *  Is the timer running?
+         *  @var bool
+         */
+        bool _active = false;
+
+        /**
+         *  Callback method that is called by libevent when the timer expires
+         *  @param  fd          Not used (always -1)
+         *  @param  what        Events triggered
+         *  @param  ticker_arg  void * to the ticker
+         */
+        static void callback(evutil_socket_t fd, short what, void *ticker_arg)
+        {
+            // retrieve the object
+            Ticker *ticker = static_cast<Ticker*>(ticker_arg);
+
+            // move the wheel forward
+            ticker->advance(now(ticker->_evbase));
+
+            // stop the timer if nothing is scheduled any more
+            if (ticker->empty()) ticker->stop();
+        }
+
+        /**
+         *  Stop the timer
+         */
+        void stop()
+        {
+            // stop the timer
+            evtimer_del(_timer);
+
+            // remember that it is no longer running
+            _active = false;
+        }
+
+    public:
+        /**
+         *  The current time, in seconds
+         *  @param  evbase      The event loop
+         *  @return double
+         */
+        static double now(struct event_base *evbase)
+        {
+            // the time that the loop started its current iteration
+            struct timeval tv;
+            event_base_gettimeofday_cached(evbase, &tv);
+            
+            // convert to seconds
+            return tv.tv_sec + tv.tv_usec / 1000000.0;
+        }
+
+        /**
+         *  The current time of the loop, in seconds
+         *  @return double
+         */
+        double now() const
+        {
+            // use the time of our own loop
+            return now(_evbase);
+        }
+
+        /**
+         *  Constructor
+         *  @param  evbase          The current event loop
+         */
+        Ticker(struct event_base *evbase) : 
+            TimerWheel(now(evbase)),
+            _evbase(evbase),
+            _timer(event_new(evbase, -1, EV_PERSIST, callback, this)) {}
+
+        /**
+         *  Destructor
+         */
+        virtual ~Ticker()
+        {
+            // stop the timer
+            evtimer_del(_timer);
+            
+            // free the timer
+            event_free(_timer);
+        }
+
+        /**
+         *  Schedule a timer (and make sure the wheel is moving)
+         *  @param  timer       the timer to schedule
+         *  @param  expire      the time at which it expires (in seconds)
+         */
+        void schedule(Timer *timer, double expire)
+        {
+            // add to the wheel
+            TimerWheel::schedule(timer, expire);
+
+            // leap out if the timer is already running
+            if (_active) return;
+
+            // convert the interval to a timeval
+            struct timeval tv;
+            tv.tv_sec = long(interval());
+            tv.tv_usec = long((interval() - tv.tv_sec) * 1000000.0);
+
+            // start the timer, it repeats every tick
+            evtimer_add(_timer, &tv);
+
+            // remember that it is running
+            _active = true;
+        }
+    };
+
+    /**
+     *  Wrapper around a connection, this will monitor the filedescriptors
+     *  and use the timer wheel to send out heartbeats
+     */
+    class Wrapper : private Watchable, public HeartbeatTimer<Ticker>
+    {
+    private:
+        /**
+         *  The event loop to which it is attached
+         *  @var struct event_base
+         */
+        struct event_base *_evbase;
+
+        /**
+         *  IO-watchers to monitor filedescriptors
+         *  @var std::list
+         */
+        std::list<Watcher> _watchers;
+
+        /**
+         *  Method that is called when a filedescriptor becomes active
+         *  @param  fd          the filedescriptor that is active
+         *  @param  events      the events that are active (readable/writable)
+         */
+        virtual void onActive(int fd, int events) override
+        {
+            // pass on to the connection
+            _connection->process(fd, events);
+        }
+
+    public:
+        /**
+         *  Constructor
+         *  @param  evbase          The current event loop
+         *  @param  ticker          The timer wheel of the loop
+         *  @param  connection      The TCP connection
+         *  @param  timeout         Connect timeout
+         */
+        Wrapper(struct event_base *evbase, Ticker *ticker, AMQP::TcpConnection *connection, uint16_t timeout = 60) :
+            HeartbeatTimer(ticker, connection, timeout),
+            _evbase(evbase) {}
+
+        /**
+         *  Watchers cannot be copied or moved
+         *
+         *  @param  that    The object to not move or copy
+         */
+        Wrapper(Wrapper &&that) = delete;
+        Wrapper(const Wrapper &that) = delete;
+
+        /**
+         *  Destructor
+         */
+        virtual ~Wrapper() = default;
+
+        /**
+         *  Monitor a filedescriptor
+         *  @param  fd
+         *  @param  events
+         */
+        void monitor(int fd, int events)
+        {
+            // should we remove?
+            if (events == 0)
+            {
+                // remove the io-watcher
+                _watchers.remove_if([fd](const Watcher &watcher) -> bool {
+                    
+                    // compare filedescriptors
+                    return watcher.contains(fd);
+                });
+            }
+            else
+            {
+                // look in the array for this filedescriptor
+                for (auto &watcher : _watchers)
+                {
+                    // do we have a match?
+                    if (watcher.contains(fd)) return watcher.events(events);
+                }
+                
+                // we need a watcher
+                Watchable *watchable = this;
+                
+                // we should monitor a new filedescriptor
+                _watchers.emplace_back(_evbase, watchable, fd, events);
+            }
+        }
+    };
+
 
     /**
      *  The event loop
@@ -134,11 +385,37 @@ private:
     struct event_base *_evbase;
 
     /**
-     *  All I/O watchers that are active, indexed by their filedescriptor
-     *  @var std::map<int,Watcher>
+     *  The timer wheel that is shared by all connections
+     *  @var Ticker
      */
-    std::map<int,std::unique_ptr<Watcher>> _watchers;
+    Ticker _ticker;
 
+    /**
+     *  Each connection is wrapped
+     *  @var std::list
+     */
+    std::list<Wrapper> _wrappers;
+
+    /**
+     *  Lookup a connection-wrapper, when the wrapper is not found, we construct one
+     *  @param  connection
+     *  @return Wrapper
+     */
+    Wrapper &lookup(TcpConnection *connection)
+    {
+        // look for the appropriate connection
+        for (auto &wrapper : _wrappers)
+        {
+            // do we have a match?
+            if (wrapper.contains(connection)) return wrapper;
+        }
+        
+        // add to the wrappers
+        _wrappers.emplace_back(_evbase, &_ticker, connection);
+        
+        // done
+        return _wrappers.back();
+    }
 
     /**
      *  Method that is called by AMQP-CPP to register a filedescriptor for readability or writability
@@ -148,28 +425,61 @@ private:
      */
     virtual void monitor(TcpConnection *connection, int fd, int flags) override
     {
-        // do we already have this filedescriptor
-        auto iter = _watchers.find(fd);
+        // lookup the appropriate wrapper and start monitoring
+        lookup(connection).monitor(fd, flags);
+    }
 
-        // was it found?
-        if (iter == _watchers.end())
-        {
-            // we did not yet have this watcher - but that is ok if no filedescriptor was registered
-            if (flags == 0) return;
+protected:
+    /**
+     *  Method that is called when the heartbeat timeout is negotiated between the server and the client. 
+     *  @param  connection      The connection that suggested a heartbeat timeout
+     *  @param  timeout         The suggested timeout from the server
+     *  @return uint16_t        The timeout to use
+     */
+    virtual uint16_t onNegotiate(TcpConnection *connection, uint16_t timeout) override
+    {
+        // lookup the wrapper, and start the timer to check for activity and send heartbeats
+        return lookup(connection).start(timeout);
+    }
 
-            // construct a new watcher, and put it in the map
-            _watchers[fd] = std::unique_ptr<Watcher>(new Watcher(_evbase, connection, fd, flags));
-        }
-        else if (flags == 0)
-        {
-            // the watcher does already exist, but we no longer have to watch this watcher
-            _watchers.erase(iter);
-        }
-        else
-        {
-            // change the events
-            iter->second->events(flags);
-        }
+    /**
+     *  Method that is called when a lost connection is about to be recovered
+     *  @param  connection      The TCP connection
+     *  @param  attempt         Number of the attempt
+     *  @return bool            Should the connection be recovered?
+     */
+    virtual bool onRecovering(TcpConnection *connection, size_t attempt) override
+    {
+        // the timer should not expire during the backoff
+        lookup(connection).stop();
+
+        // keep trying
+        return TcpHandler::onRecovering(connection, attempt);
+    }
+
+    /**
+     *  Method that is called when a lost connection has been recovered
+     *  @param  connection      The TCP connection
+     */
+    virtual void onRecovered(TcpConnection *connection) override
+    {
+        // check the heartbeats again
+        lookup(connection).restart();
+
+        // pass on to the base
+        TcpHandler::onRecovered(connection);
+    }
+
+    /**
+     *  Method that is called when the TCP connection is destructed
+     *  @param  connection  The TCP connection
+     */
+    virtual void onDetached(TcpConnection *connection) override
+    {
+        // remove from the array
+        _wrappers.remove_if([connection](const Wrapper &wrapper) -> bool {
+            return wrapper.contains(connection);
+        });
     }
 
 public:
@@ -177,7 +487,7 @@ public:
      *  Constructor
      *  @param  evbase  The event loop to wrap
      */
-    LibEventHandler(struct event_base *evbase) : _evbase(evbase) {}
+    LibEventHandler(struct event_base *evbase) : _evbase(evbase), _ticker(evbase) {}
 
     /**
      *  Destructor
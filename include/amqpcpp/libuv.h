@@ -8,7 +8,7 @@
  *  Based heavily on the libev.h implementation by Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
  *
  *  @author David Nikdel <david@nikdel.com>
- *  @copyright 2015 Copernica BV
+ *  @copyright 2015 - 2020 Copernica BV
  */
 
 /**
@@ -20,8 +20,11 @@
  *  Dependencies
  */
 #include <uv.h>
+#include <list>
 
 #include "amqpcpp/linux_tcp.h"
+#include "amqpcpp/timerwheel.h"
+#include "amqpcpp/heartbeattimer.h"
 
 /**
  *  Set up namespace
@@ -35,7 +38,21 @@ class LibUvHandler : public TcpHandler
 {
 private:
     /**
-     *  Helper class that wraps a libev I/O watcher
+     *  Internal interface for the object that is being watched
+     */
+    class Watchable
+    {
+    public:
+        /**
+         *  The method that is called when a filedescriptor becomes active
+         *  @param  fd
+         *  @param  events
+         */
+        virtual void onActive(int fd, int events) = 0;
+    };
+
+    /**
+     *  Helper class that wraps a libuv I/O watcher
      */
     class Watcher
     {
@@ -52,6 +69,12 @@ private:
          */
         uv_poll_t *_poll;
 
+        /**
+         *  The filedescriptor that is watched
+         *  @var int
+         */
+        int _fd;
+
         /**
          *  Callback method that is called by libuv when a filedescriptor becomes active
          *  @param  handle     Internal poll handle
@@ -60,33 +83,33 @@ private:
          */
         static void callback(uv_poll_t *handle, int status, int events)
         {
-            // retrieve the connection
-            TcpConnection *connection = static_cast<TcpConnection*>(handle->data);
+            // retrieve the watched object
+            Watchable *object = static_cast<Watchable*>(handle->data);
 
-            // tell the connection that its filedescriptor is active
+            // tell the object that its filedescriptor is active
             int fd = -1;
             uv_fileno(reinterpret_cast<uv_handle_t*>(handle), &fd);
-            connection->process(fd, uv_to_amqp_events(status, events));
+            object->onActive(fd, uv_to_amqp_events(status, events));
         }
 
     public:
         /**
          *  Constructor
          *  @param  loop            The current event loop
-         *  @param  connection      The connection being watched
+         *  @param  object          The object being watched
          *  @param  fd              The filedescriptor being watched
          *  @param  events          The events that should be monitored
          */
-        Watcher(uv_loop_t *loop, TcpConnection *connection, int fd, int events) : _loop(loop)
+        Watcher(uv_loop_t *loop, Watchable *object, int fd, int events) : _loop(loop), _fd(fd)
         {
             // create a new poll
             _poll = new uv_poll_t();
 
-            // initialize the libev structure
+            // initialize the libuv structure
             uv_poll_init(_loop, _poll, fd);
 
-            // store the connection in the data "void*"
-            _poll->data = connection;
+            // store the object in the data "void*"
+            _poll->data = object;
 
             // start the watcher
             uv_poll_start(_poll, amqp_to_uv_events(events), callback);
@@ -115,6 +138,13 @@ private:
             });
         }
 
+        /**
+         *  Check if a filedescriptor is covered by the watcher
+         *  @param  fd
+         *  @return bool
+         */
+        bool contains(int fd) const { return _fd == fd; }
+
         /**
          *  Change the events for which the filedescriptor is monitored
          *  @param  events
@@ -159,6 +189,195 @@ private:
         }
     };
 
+    /**
+     *  The timer wheel for all connections on the loop, with the one and
+     *  only libuv timer that moves it forward (once per second, and only
+     *  as long as there are connections that need a timer)
+     */
+    class Ticker : public TimerWheel
+    {
+    private:
+        /**
+         *  The event loop to which it is attached
+         *  @var uv_loop_t
+         */
+        uv_loop_t *_loop;
+
+        /**
+         *  The timer (allocated on the heap, because libuv closes handles asynchronously)
+         *  @var uv_timer_t
+         */
+        uv_timer_t *_timer;
+
+        /**
+         *  Callback method that is called by libuv when the timer expires
+         *  @param  timer       Internal timer object
+         */
+        static void callback(uv_timer_t *timer)
+        {
+            // retrieve the object
+            Ticker *ticker = static_cast<Ticker*>(timer->data);
+
+            // move the wheel forward
+            ticker->advance(ticker->now());
+
+            // stop the timer if nothing is scheduled any more
+            if (ticker->empty()) uv_timer_stop(timer);
+        }
+
+    public:
+        /**
+         *  Constructor
+         *  @param  loop            The current event loop
+         */
+        Ticker(uv_loop_t *loop) : TimerWheel(uv_now(loop) / 1000.0), _loop(loop), _timer(new uv_timer_t())
+        {
+            // initialize the libuv structure
+            uv_timer_init(_loop, _timer);
+
+            // store the object in the data "void*"
+            _timer->data = this;
+
+            // the timer should not keep the event loop active
+            uv_unref(reinterpret_cast<uv_handle_t*>(_timer));
+        }
+
+        /**
+         *  Destructor
+         */
+        virtual ~Ticker()
+        {
+            // stop the timer
+            uv_timer_stop(_timer);
+
+            // close the handle
+            uv_close(reinterpret_cast<uv_handle_t*>(_timer), [](uv_handle_t* handle) {
+                // delete memory once closed
+                delete reinterpret_cast<uv_timer_t*>(handle);
+            });
+        }
+
+        /**
+         *  The current time of the loop, in seconds
+         *  @return double
+         */
+        double now() const
+        {
+            // libuv uses milliseconds
+            return uv_now(_loop) / 1000.0;
+        }
+
+        /**
+         *  Schedule a timer (and make sure the wheel is moving)
+         *  @param  timer       the timer to schedule
+         *  @param  expire      the time at which it expires (in seconds)
+         */
+        void schedule(Timer *timer, double expire)
+        {
+            // add to the wheel
+            TimerWheel::schedule(timer, expire);
+
+            // leap out if the timer is already running
+            if (uv_is_active(reinterpret_cast<uv_handle_t*>(_timer))) return;
+
+            // the interval in milliseconds
+            uint64_t interval = uint64_t(this->interval() * 1000.0);
+
+            // start the timer, it repeats every tick
+            uv_timer_start(_timer, callback, interval, interval);
+        }
+    };
+
+    /**
+     *  Wrapper around a connection, this will monitor the filedescriptors
+     *  and use the timer wheel to send out heartbeats
+     */
+    class Wrapper : private Watchable, public HeartbeatTimer<Ticker>
+    {
+    private:
+        /**
+         *  The event loop to which it is attached
+         *  @var uv_loop_t
+         */
+        uv_loop_t *_loop;
+
+        /**
+         *  IO-watchers to monitor filedescriptors
+         *  @var std::list
+         */
+        std::list<Watcher> _watchers;
+
+        /**
+         *  Method that is called when a filedescriptor becomes active
+         *  @param  fd          the filedescriptor that is active
+         *  @param  events      the events that are active (readable/writable)
+         */
+        virtual void onActive(int fd, int events) override
+        {
+            // pass on to the connection
+            _connection->process(fd, events);
+        }
+
+    public:
+        /**
+         *  Constructor
+         *  @param  loop            The current event loop
+         *  @param  ticker          The timer wheel of the loop
+         *  @param  connection      The TCP connection
+         *  @param  timeout         Connect timeout
+         */
+        Wrapper(uv_loop_t *loop, Ticker *ticker, AMQP::TcpConnection *connection, uint16_t timeout = 60) :
+            HeartbeatTimer(ticker, connection, timeout),
+            _loop(loop) {}
+
+        /**
+         *  Watchers cannot be copied or moved
+         *
+         *  @param  that    The object to not move or copy
+         */
+        Wrapper(Wrapper &&that) = delete;
+        Wrapper(const Wrapper &that) = delete;
+
+        /**
+         *  Destructor
+         */
+        virtual ~Wrapper() = default;
+
+        /**
+         *  Monitor a filedescriptor
+         *  @param  fd
+         *  @param  events
+         */
+        void monitor(int fd, int events)
+        {
+            // should we remove?
+            if (events == 0)
+            {
+                // remove the io-watcher
+                _watchers.remove_if([fd](const Watcher &watcher) -> bool {
+                    
+                    // compare filedescriptors
+                    return watcher.contains(fd);
+                });
+            }
+            else
+            {
+                // look in the array for this filedescriptor
+                for (auto &watcher : _watchers)
+                {
+                    // do we have a match?
+                    if (watcher.contains(fd)) return watcher.events(events);
+                }
+                
+                // we need a watcher
+                Watchable *watchable = this;
+                
+                // we should monitor a new filedescriptor
+                _watchers.emplace_back(_loop, watchable, fd, events);
+            }
+        }
+    };
+
 
     /**
      *  The event loop
@@ -167,11 +386,37 @@ private:
     uv_loop_t *_loop;
 
     /**
-     *  All I/O watchers that are active, indexed by their filedescriptor
-     *  @var std::map<int,Watcher>
+     *  The timer wheel that is shared by all connections
+     *  @var Ticker
      */
-    std::map<int,std::unique_ptr<Watcher>> _watchers;
+    Ticker _ticker;
 
+    /**
+     *  Each connection is wrapped
+     *  @var std::list
+     */
+    std::list<Wrapper> _wrappers;
+
+    /**
+     *  Lookup a connection-wrapper, when the wrapper is not found, we construct one
+     *  @param  connection
+     *  @return Wrapper
+     */
+    Wrapper &lookup(TcpConnection *connection)
+    {
+        // look for the appropriate connection
+        for (auto &wrapper : _wrappers)
+        {
+            // do we have a match?
+            if (wrapper.contains(connection)) return wrapper;
+        }
+        
+        // add to the wrappers
+        _wrappers.emplace_back(_loop, &_ticker, connection);
+        
+        // done
+        return _wrappers.back();
+    }
 
     /**
      *  Method that is called by AMQP-CPP to register a filedescriptor for readability or writability
@@ -181,28 +426,61 @@ private:
      */
     virtual void monitor(TcpConnection *connection, int fd, int flags) override
     {
-        // do we already have this filedescriptor
-        auto iter = _watchers.find(fd);
+        // lookup the appropriate wrapper and start monitoring
+        lookup(connection).monitor(fd, flags);
+    }
 
-        // was it found?
-        if (iter == _watchers.end())
-        {
-            // we did not yet have this watcher - but that is ok if no filedescriptor was registered
-            if (flags == 0) return;
+protected:
+    /**
+     *  Method that is called when the heartbeat timeout is negotiated between the server and the client. 
+     *  @param  connection      The connection that suggested a heartbeat timeout
+     *  @param  timeout         The suggested timeout from the server
+     *  @return uint16_t        The timeout to use
+     */
+    virtual uint16_t onNegotiate(TcpConnection *connection, uint16_t timeout) override
+    {
+        // lookup the wrapper, and start the timer to check for activity and send heartbeats
+        return lookup(connection).start(timeout);
+    }
 
-            // construct a new watcher, and put it in the map
-            _watchers[fd] = std::unique_ptr<Watcher>(new Watcher(_loop, connection, fd, flags));
-        }
-        else if (flags == 0)
-        {
-            // the watcher does already exist, but we no longer have to watch this watcher
-            _watchers.erase(iter);
-        }
-        else
-        {
-            // change the events
-            iter->second->events(flags);
-        }
+    /**
+     *  Method that is called when a lost connection is about to be recovered
+     *  @param  connection      The TCP connection
+     *  @param  attempt         Number of the attempt
+     *  @return bool            Should the connection be recovered?
+     */
+    virtual bool onRecovering(TcpConnection *connection, size_t attempt) override
+    {
+        // the timer should not expire during the backoff
+        lookup(connection).stop();
+
+        // keep trying
+        return TcpHandler::onRecovering(connection, attempt);
+    }
+
+    /**
+     *  Method that is called when a lost connection has been recovered
+     *  @param  connection      The TCP connection
+     */
+    virtual void onRecovered(TcpConnection *connection) override
+    {
+        // check the heartbeats again
+        lookup(connection).restart();
+
+        // pass on to the base
+        TcpHandler::onRecovered(connection);
+    }
+
+    /**
+     *  Method that is called when the TCP connection is destructed
+     *  @param  connection  The TCP connection
+     */
+    virtual void onDetached(TcpConnection *connection) override
+    {
+        // remove from the array
+        _wrappers.remove_if([connection](const Wrapper &wrapper) -> bool {
+            return wrapper.contains(connection);
+        });
     }
 
 public:
@@ -210,7 +488,7 @@ public:
      *  Constructor
      *  @param  loop    The event loop to wrap
      */
-    LibUvHandler(uv_loop_t *loop) : _loop(loop) {}
+    LibUvHandler(uv_loop_t *loop) : _loop(loop), _ticker(loop) {}
 
     /**
      *  Destructor
@@ -1,4 +1,6 @@
 #include "linux_tcp/tcpparent.h"
+#include "linux_tcp/backoff.h"
 #include "linux_tcp/tcphandler.h"
 #include "linux_tcp/tcpconnection.h"
 #include "linux_tcp/tcpchannel.h"
+#include "linux_tcp/dnscache.h"
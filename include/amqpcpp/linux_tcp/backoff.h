@@ -0,0 +1,87 @@
+/**
+ *  Backoff.h
+ *
+ *  Policy that determines how long a recoverable TcpConnection waits
+ *  before each attempt to reconnect, and how often it tries.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Begin of namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class Backoff
+{
+private:
+    /**
+     *  Delay before the first attempt, in milliseconds
+     *  @var uint32_t
+     */
+    uint32_t _initial;
+
+    /**
+     *  Upper limit for the delay, in milliseconds
+     *  @var uint32_t
+     */
+    uint32_t _maximum;
+
+    /**
+     *  Max number of consecutive attempts (zero for no limit)
+     *  @var size_t
+     */
+    size_t _attempts;
+
+public:
+    /**
+     *  Constructor
+     * 
+     *  The delay doubles with every failed attempt until it reaches the 
+     *  maximum. A random jitter is applied to every delay (the actual delay 
+     *  is somewhere between half and the full computed delay) so that many 
+     *  clients that lost their connection at the same moment do not all 
+     *  come back at the same moment too.
+     * 
+     *  @param  initial     delay before the first attempt, in milliseconds
+     *  @param  maximum     upper limit for the delay, in milliseconds
+     *  @param  attempts    max number of consecutive attempts (zero for no limit)
+     */
+    Backoff(uint32_t initial = 100, uint32_t maximum = 30000, size_t attempts = 0) :
+        _initial(initial), _maximum(std::max(initial, maximum)), _attempts(attempts) {}
+
+    /**
+     *  Destructor
+     */
+    virtual ~Backoff() = default;
+
+    /**
+     *  Max number of consecutive attempts (zero for no limit)
+     *  @return size_t
+     */
+    size_t attempts() const
+    {
+        return _attempts;
+    }
+
+    /**
+     *  The delay before a certain attempt
+     *  @param  attempt     the attempt number, the first attempt has number 1
+     *  @return uint32_t    delay in milliseconds
+     */
+    uint32_t delay(size_t attempt) const;
+};
+
+/**
+ *  End of namespace
+ */
+}
@@ -0,0 +1,39 @@
+/**
+ *  DnsCache.h
+ *
+ *  Function to control the cache of resolved hostnames
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Begin of namespace
+ */
+namespace AMQP {
+
+/**
+ *  All TcpConnection objects in the process share a cache of resolved
+ *  hostnames, so that setting up many connections to the same broker (or
+ *  reconnecting after a network failure) does not result in a storm of 
+ *  DNS lookups. Connections also remember to which address they last 
+ *  managed to connect, and try that address first the next time.
+ * 
+ *  Because getaddrinfo() does not expose the time-to-live of the DNS 
+ *  records, lookups are cached for a fixed number of seconds (60 by 
+ *  default). With this method you can change that period. Calling it 
+ *  also empties the cache, and passing zero turns off caching altogether.
+ * 
+ *  @param  seconds         number of seconds that a lookup remains valid
+ */
+void dnscache(uint32_t seconds);
+    
+/**
+ *  End of namespace
+ */
+}
@@ -12,6 +12,12 @@
  */
 #pragma once
 
+/**
+ *  Dependencies
+ */
+#include <unistd.h>
+#include <cerrno>
+
 /**
  *  Set up namespace
  */
@@ -53,6 +59,48 @@ public:
      *  @param  other
      */
     TcpChannel(TcpChannel &&other) = default;
+
+    /**
+     *  The publish methods of the base class
+     */
+    using Channel::publish;
+
+    /**
+     *  Publish a message of which the body is read from a file while it is being sent
+     *
+     *  The file is not loaded in memory: every time that the connection has room for the
+     *  next body frame, the data for that frame is read with pread() into a buffer of the
+     *  size of a single frame, and copied from there into the frame that is sent.
+     *  The filedescriptor must stay open until the message was sent. See Channel::publish()
+     *  for the other parameters.
+     *
+     *  @param  exchange    the exchange to publish to
+     *  @param  routingkey  the routing key
+     *  @param  metadata    the properties of the message
+     *  @param  size        size of the body
+     *  @param  fd          the file to read the body from
+     *  @param  offset      position in the file where the body starts
+     *  @param  flags       optional flags
+     */
+    DeferredPublisher &publish(const std::string &exchange, const std::string &routingKey, const MetaData &metadata, uint64_t size, int fd, off_t offset, int flags = 0)
+    {
+        // publish with a producer that reads from the file
+        return Channel::publish(exchange, routingKey, metadata, size, [fd, offset](char *buffer, size_t size) mutable -> size_t {
+
+            // read the next part (and try again if we were interrupted by a signal)
+            ssize_t result;
+            do result = pread(fd, buffer, size, offset); while (result < 0 && errno == EINTR);
+
+            // the body can not be completed if nothing could be read
+            if (result <= 0) return 0;
+
+            // the next part starts after this one
+            offset += result;
+
+            // done
+            return result;
+        }, flags);
+    }
 };
 
 /**
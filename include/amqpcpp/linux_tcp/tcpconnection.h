@@ -52,6 +52,55 @@ private:
      */
     Connection _connection;
 
+    /**
+     *  The addresses to which the connection can be (re)established
+     *  @var    std::vector<Address>
+     */
+    std::vector<Address> _addresses;
+
+    /**
+     *  Index of the address that is currently in use
+     *  @var    size_t
+     */
+    size_t _current = 0;
+
+    /**
+     *  Policy for reconnecting
+     *  @var    Backoff
+     */
+    Backoff _backoff;
+
+    /**
+     *  Should the connection be recovered when it is lost?
+     *  @var    bool
+     */
+    bool _recover = false;
+
+    /**
+     *  Number of consecutive attempts to recover the connection
+     *  @var    size_t
+     */
+    size_t _attempts = 0;
+
+    /**
+     *  Should a new attempt be started as soon as the old state is gone?
+     *  @var    bool
+     */
+    bool _reconnect = false;
+
+    /**
+     *  Is the connection being recovered (and did it not yet pass the handshake)?
+     *  @var    bool
+     */
+    bool _recovering = false;
+
+    /**
+     *  The TLS context that was used for the most recent secure connection, it
+     *  is kept so that a recovered connection can resume the previous session
+     *  @var    std::shared_ptr<SslContext>
+     */
+    std::shared_ptr<SslContext> _context;
+
     /**
      *  The channel may access out _connection
      *  @friend
@@ -94,6 +143,57 @@ private:
         if (_handler) _handler->onHeartbeat(this);
     }
 
+    /**
+     *  Method that is called when the processing of incoming data was paused
+     *  @param  connection      The connection that was paused
+     */
+    virtual void onPaused(Connection *connection) override;
+
+    /**
+     *  Method that is called when the processing of incoming data is resumed
+     *  @param  connection      The connection that was resumed
+     */
+    virtual void onResumed(Connection *connection) override;
+
+    /**
+     *  Method that is called when there are body frames to produce
+     *  @param  connection      The connection that has frames to produce
+     *  @return bool
+     */
+    virtual bool onProducing(Connection *connection) override;
+
+    /**
+     *  Method that is called when the outgoing data crosses a watermark
+     *  @param  connection      The connection with too much (or again little enough) data
+     *  @param  active          Is there backpressure?
+     */
+    virtual void onBackpressure(Connection *connection, bool active) override
+    {
+        // pass on to the handler
+        if (_handler) _handler->onBackpressure(this, active);
+    }
+
+    /**
+     *  Method that is called when the server blocks the connection
+     *  @param  connection      The connection that was blocked
+     *  @param  reason          Why the connection was blocked
+     */
+    virtual void onBlocked(Connection *connection, const char *reason) override
+    {
+        // pass on to the handler
+        if (_handler) _handler->onBlocked(this, reason);
+    }
+
+    /**
+     *  Method that is called when the server no longer blocks the connection
+     *  @param  connection      The connection that was unblocked
+     */
+    virtual void onUnblocked(Connection *connection) override
+    {
+        // pass on to the handler
+        if (_handler) _handler->onUnblocked(this);
+    }
+
     /**
      *  Method called when the connection ends up in an error state
      *  @param  connection      The connection that entered the error state
@@ -105,11 +205,7 @@ private:
      *  Method that is called when the AMQP connection is established
      *  @param  connection      The connection that can now be used
      */
-    virtual void onReady(Connection *connection) override
-    {
-        // pass on to the handler
-        if (_handler) _handler->onReady(this);
-    }
+    virtual void onReady(Connection *connection) override;
 
     /**
      *  Method that is called when the connection was closed.
@@ -128,24 +224,42 @@ private:
     }
 
     /**
-     *  Method that is called when the connection is secured
+     *  Method that is called when a TLS context is needed
+     *  @param  state
+     *  @param  hostname
+     *  @param  port
+     *  @return std::shared_ptr<SslContext>
+     *  @throws std::runtime_error
+     */
+    virtual std::shared_ptr<SslContext> onContext(TcpState *state, const std::string &hostname, uint16_t port) override;
+
+    /**
+     *  Method that is called right before the TLS handshake is started
      *  @param  state
      *  @param  ssl
      *  @return bool
      */
-    virtual bool onSecured(TcpState *state, const SSL *ssl) override
+    virtual bool onSecuring(TcpState *state, SSL *ssl) override
     {
         // pass on to user-space
-        return _handler && _handler->onSecured(this, ssl);
+        return _handler && _handler->onSecuring(this, ssl);
     }
 
+    /**
+     *  Method that is called when the connection is secured
+     *  @param  state
+     *  @param  ssl
+     *  @return bool
+     */
+    virtual bool onSecured(TcpState *state, const SSL *ssl) override;
+
     /**
      *  Method to be called when data was received
      *  @param  state
      *  @param  buffer
      *  @return size_t
      */
-    virtual size_t onReceived(TcpState *state, const Buffer &buffer) override
+    virtual size_t onReceived(TcpState *state, const ByteBuffer &buffer) override
     {
         // pass on to the connection
         return _connection.parse(buffer);
@@ -176,6 +290,17 @@ private:
      *  @param  state
      */
     virtual void onLost(TcpState *state) override;
+
+    /**
+     *  Method that is called when the next body frames can be produced
+     *  @param  state
+     *  @return bool
+     */
+    virtual bool onProduce(TcpState *state) override
+    {
+        // pass on to the connection
+        return _connection.produce();
+    }
     
     /**
      *  The expected number of bytes
@@ -187,6 +312,34 @@ private:
         return _connection.expected();
     }
 
+    /**
+     *  Are there body frames to produce?
+     *  @return bool
+     */
+    virtual bool producing() override
+    {
+        // pass on to the connection
+        return _connection.producing();
+    }
+
+    /**
+     *  Helper method that is called when no further events are going to be fired
+     *  for the current tcp connection, to find out if a new one should be set up
+     */
+    void detach();
+
+    /**
+     *  Start a new attempt to connect to the next address
+     */
+    void reconnect();
+
+    /**
+     *  Replace the current state, and start a new attempt to connect if the
+     *  old state reported that the connection was lost
+     *  @param  state           the new state
+     */
+    void replace(TcpState *state);
+
 public:
     /**
      *  Constructor
@@ -194,6 +347,22 @@ public:
      *  @param  hostname        The address to connect to
      */
     TcpConnection(TcpHandler *handler, const Address &address);
+
+    /**
+     *  Constructor for a recoverable connection
+     * 
+     *  When the connection is lost, it is automatically re-established to
+     *  the next address in the list (after a delay that is determined by the 
+     *  backoff policy). The channels are kept during the reconnect, and all
+     *  exchanges, queues, bindings and consumers that were declared on them 
+     *  are re-declared. The handler's onRecovering() and onRecovered() 
+     *  methods are called to keep you informed.
+     * 
+     *  @param  handler         User implemented handler object
+     *  @param  addresses       The addresses to connect to (in round-robin order)
+     *  @param  backoff         The reconnect policy
+     */
+    TcpConnection(TcpHandler *handler, const Addresses &addresses, const Backoff &backoff = Backoff());
     
     /**
      *  No copying
@@ -231,10 +400,22 @@ public:
      *  pending operations are completed, and then an AMQP closing-handshake is
      *  performed. If you pass a parameter "immediate=true" the connection is 
      *  immediately closed, without waiting for earlier commands (and your handler's
-     *  onError() method is called about the premature close)
+     *  onError() method is called about the premature close). A recoverable connection
+     *  is no longer recovered after it was closed.
      *  @return bool
      */
     bool close(bool immediate = false);
+
+    /**
+     *  Drop the TCP connection because the server no longer responds (for example
+     *  because it did not send heartbeats in time). The same happens as when the
+     *  socket is lost: your handler's onError() and onLost() methods are called,
+     *  and a recoverable connection is recovered. Unlike close(), the connection
+     *  does not have to be usable for this.
+     *  @param  message         the error message to report
+     *  @return bool            false if there was no socket to drop
+     */
+    bool fail(const char *message);
     
     /**
      *  Is the connection connected, meaning: it has passed the login handshake
@@ -291,6 +472,32 @@ public:
         return _connection.expected();
     }
 
+    /**
+     *  Stop processing incoming data (see Connection::pause()), the socket
+     *  is no longer monitored for readability until resume() is called
+     */
+    void pause()
+    {
+        _connection.pause();
+    }
+
+    /**
+     *  Resume processing incoming data
+     */
+    void resume()
+    {
+        _connection.resume();
+    }
+
+    /**
+     *  Is processing of incoming data paused?
+     *  @return bool
+     */
+    virtual bool paused() const override
+    {
+        return _connection.paused();
+    }
+
     /**
       *  Return the number of channels this connection has.
       *  @return std::size_t
@@ -306,6 +513,92 @@ public:
      *  @return std::size_t
      */
     std::size_t queued() const;
+
+    /**
+     *  Set watermarks for the outgoing data (see Connection::watermarks()), the
+     *  handler's onBackpressure() method is called when they are crossed. The
+     *  outgoing buffer of the socket is counted automatically.
+     *  @param  high            number of bytes at which backpressure starts (0 to disable)
+     *  @param  low             number of bytes at which it ends
+     */
+    void watermarks(std::size_t high, std::size_t low)
+    {
+        _connection.watermarks(high, low);
+    }
+
+    /**
+     *  Is too much data waiting to be sent?
+     *  @return bool
+     */
+    bool backpressure() const
+    {
+        return _connection.backpressure();
+    }
+
+    /**
+     *  Did the server block the connection? (see Connection::blocked())
+     *  @return bool
+     */
+    bool blocked() const
+    {
+        return _connection.blocked();
+    }
+
+    /**
+     *  Hold back published messages while the server blocks the connection
+     *  (see Connection::gated())
+     *  @param  enabled
+     */
+    void gated(bool enabled)
+    {
+        _connection.gated(enabled);
+    }
+
+    /**
+     *  Are published messages held back while the connection is blocked?
+     *  @return bool
+     */
+    bool gated() const
+    {
+        return _connection.gated();
+    }
+
+    /**
+     *  Start collecting statistics (see Connection::stats()), for a TcpConnection
+     *  the size of the outgoing buffer is recorded too
+     *  @param  stats
+     */
+    void stats(const std::shared_ptr<Stats> &stats)
+    {
+        _connection.stats(stats);
+    }
+
+    /**
+     *  The statistics that are collected (nullptr if they are not collected)
+     *  @return std::shared_ptr<Stats>
+     */
+    const std::shared_ptr<Stats> &stats() const
+    {
+        return _connection.stats();
+    }
+
+    /**
+     *  When was the last data sent to the server? (see Connection::lastSent())
+     *  @return std::chrono::steady_clock::time_point
+     */
+    std::chrono::steady_clock::time_point lastSent() const
+    {
+        return _connection.lastSent();
+    }
+
+    /**
+     *  When was the last data received from the server? (see Connection::lastReceived())
+     *  @return std::chrono::steady_clock::time_point
+     */
+    std::chrono::steady_clock::time_point lastReceived() const
+    {
+        return _connection.lastReceived();
+    }
     
     /**
      *  Send a heartbeat
@@ -59,6 +59,56 @@ public:
         (void) connection;
     }
 
+    /**
+     *  Method that is called when a secure connection needs an openssl context. All
+     *  connections of this handler to the same hostname and port share a single
+     *  context (as long as one of them exists), so this method is only called for the
+     *  first connection to a server, and is the place to do expensive setup that applies
+     *  to all these connections, like loading the trusted CA certificates, configuring
+     *  the ciphers, or loading a client certificate. Connections of other handlers get
+     *  a context of their own. The context is locked during this call, other connections
+     *  of this handler to the same server wait until it is ready. Return false if the 
+     *  context could not be configured (the connection is then rejected, and the next 
+     *  connection to the same server gets a new context). The passed in SSL_CTX 
+     *  pointer is a pointer to a context from the openssl library. This method is only 
+     *  called for secure connections (connection with an amqps:// address).
+     *  @param  connection      The connection that is the first to use the context
+     *  @param  context         Pointer to the SSL_CTX structure that can be modified
+     *  @return bool            True to use the context, false to reject it
+     */
+    virtual bool onContext(TcpConnection *connection, SSL_CTX *context)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+        (void) context;
+
+        // default implementation: do not change anything
+        return true;
+    }
+
+    /**
+     *  Method that is called after a TCP connection has been set up, and right before
+     *  the TLS handshake is started. This method allows you to configure the SSL 
+     *  structure, for example to load a client certificate, or to let the kernel take 
+     *  over the encryption by setting the SSL_OP_ENABLE_KTLS option (when the kernel
+     *  and openssl support it, AMQP-CPP automatically uses the faster kernel code
+     *  path to send data after the handshake). The passed in SSL pointer is a pointer 
+     *  to a SSL structure from the openssl library. This method is only called for
+     *  secure connections (connection with an amqps:// address).
+     *  @param  connection      The connection for which TLS is going to be started
+     *  @param  ssl             Pointer to the SSL structure that can be modified
+     *  @return bool            True to proceed, false to break up the connection
+     */
+    virtual bool onSecuring(TcpConnection *connection, SSL *ssl)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+        (void) ssl;
+
+        // default implementation: do not change anything
+        return true;
+    }
+
     /**
      *  Method that is called after a TCP connection has been set up and the initial 
      *  TLS handshake is finished too, but right before the AMQP login handshake is
@@ -183,6 +233,79 @@ public:
         (void) connection;
     }
 
+    /**
+     *  Method that is called when a recoverable connection (one that was
+     *  constructed with a list of addresses) is about to make a new attempt
+     *  to connect. It is called instead of onDetached(), after the connection
+     *  was lost (or after the previous attempt failed). The channels are kept
+     *  while the connection is being recovered. If you return false, no new
+     *  attempt is made, the channels fail and onDetached() is called after all.
+     *  @param  connection      The TCP connection
+     *  @param  attempt         Number of the attempt (starts at 1)
+     *  @return bool            Should the connection be recovered?
+     */
+    virtual bool onRecovering(TcpConnection *connection, size_t attempt)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+        (void) attempt;
+
+        // default implementation: keep trying
+        return true;
+    }
+
+    /**
+     *  Method that is called when a recoverable connection has been re-established.
+     *  It is called instead of onReady() after the login handshake on the new
+     *  connection has been completed. The channels are re-opened and everything
+     *  that was declared on them is declared again.
+     *  @param  connection      The TCP connection
+     */
+    virtual void onRecovered(TcpConnection *connection)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+    }
+
+    /**
+     *  Method that is called when the outgoing data crosses one of the watermarks
+     *  that were set with TcpConnection::watermarks(). When active is true, the
+     *  outgoing buffer (plus the frames that the connection has queued) reached
+     *  the high watermark, and you should stop publishing. When it is false, the
+     *  data has drained to the low watermark and you can start again.
+     *  @param  connection      The TCP connection
+     *  @param  active          Is there backpressure?
+     */
+    virtual void onBackpressure(TcpConnection *connection, bool active)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+        (void) active;
+    }
+
+    /**
+     *  Method that is called when the server blocks the connection, because one
+     *  of its resources is running low (see ConnectionHandler::onBlocked())
+     *  @param  connection      The TCP connection
+     *  @param  reason          Why the connection was blocked
+     */
+    virtual void onBlocked(TcpConnection *connection, const char *reason)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+        (void) reason;
+    }
+
+    /**
+     *  Method that is called when the server no longer blocks the connection
+     *  @param  connection      The TCP connection
+     */
+    virtual void onUnblocked(TcpConnection *connection)
+    {
+        // make sure compilers dont complain about unused parameters
+        (void) connection;
+    }
+
     /**
      *  Method that is called when the handler will no longer be notified.
      *  This is the last call to your handler, and it is typically used
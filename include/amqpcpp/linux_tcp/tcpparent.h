@@ -27,7 +27,8 @@ namespace AMQP {
  *  Forward declarations
  */
 class TcpState;
-class Buffer;
+class ByteBuffer;
+class SslContext;
 
 /**
  *  Class definition
@@ -47,6 +48,24 @@ public:
      */
     virtual void onConnected(TcpState *state) = 0;
 
+    /**
+     *  Method that is called when a TLS context is needed
+     *  @param  state
+     *  @param  hostname
+     *  @param  port
+     *  @return std::shared_ptr<SslContext>     nullptr if the context was rejected
+     *  @throws std::runtime_error
+     */
+    virtual std::shared_ptr<SslContext> onContext(TcpState *state, const std::string &hostname, uint16_t port) = 0;
+
+    /**
+     *  Method that is called right before the TLS handshake is started
+     *  @param  state
+     *  @param  ssl
+     *  @return bool
+     */
+    virtual bool onSecuring(TcpState *state, SSL *ssl) = 0;
+
     /**
      *  Method that is called when the connection is secured
      *  @param  state
@@ -61,7 +80,7 @@ public:
      *  @param  buffer
      *  @return size_t
      */
-    virtual size_t onReceived(TcpState *state, const Buffer &buffer) = 0;
+    virtual size_t onReceived(TcpState *state, const ByteBuffer &buffer) = 0;
     
     /**
      *  Method to be called when we need to monitor a different filedescriptor
@@ -84,6 +103,28 @@ public:
      *  @param  state
      */
     virtual void onLost(TcpState *state) = 0;
+
+    /**
+     *  Method that is called when the outgoing buffer is empty, and the next
+     *  body frames of the messages that are published from a producer can be produced
+     *  @param  state
+     *  @return bool        are there more frames to produce?
+     */
+    virtual bool onProduce(TcpState *state) = 0;
+
+    /**
+     *  Are there body frames to produce? (a new state that is constructed
+     *  after the producers were installed uses this to pick them up)
+     *  @return bool
+     */
+    virtual bool producing() = 0;
+
+    /**
+     *  Is processing of incoming data paused? (a new state that is constructed
+     *  while the connection is paused should not read from the socket)
+     *  @return bool
+     */
+    virtual bool paused() const = 0;
     
     /**
      *  The expected number of bytes
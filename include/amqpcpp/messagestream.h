@@ -0,0 +1,235 @@
+/**
+ *  MessageStream.h
+ *
+ *  An incoming message of which the body is not collected in memory, but
+ *  passed to a callback in chunks, right from the buffer in which it was
+ *  received. This is useful for large messages: no matter how big the
+ *  message is, the library does not keep more than a single frame of the
+ *  body in memory.
+ *
+ *  MessageStream objects are constructed by the AMQP library, and passed to
+ *  the callback that was installed with DeferredConsumer::onMessageStream()
+ *  as soon as the meta data of the message is known. The object stays valid
+ *  until the message is complete.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include "metadata.h"
+#include "callbacks.h"
+#include "stringview.h"
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Forward declarations
+ */
+class DeferredReceiver;
+class DeferredExtReceiver;
+
+/**
+ *  Class definition
+ */
+class MessageStream : public MetaData
+{
+private:
+    /**
+     *  The exchange to which it was originally published
+     *  @var    std::string
+     */
+    std::string _exchange;
+
+    /**
+     *  The routing key that was originally used
+     *  @var    std::string
+     */
+    std::string _routingkey;
+
+    /**
+     *  The delivery tag
+     *  @var    uint64_t
+     */
+    uint64_t _deliveryTag;
+
+    /**
+     *  Is this a redelivered message?
+     *  @var    bool
+     */
+    bool _redelivered;
+
+    /**
+     *  Size of the body
+     *  @var    uint64_t
+     */
+    uint64_t _bodySize = 0;
+
+    /**
+     *  Number of bytes of the body that were received so far
+     *  @var    uint64_t
+     */
+    uint64_t _received = 0;
+
+    /**
+     *  Callback for the chunks of the body
+     *  @var    DataCallback
+     */
+    DataCallback _dataCallback;
+
+    /**
+     *  Callback for when the message is complete
+     *  @var    SuccessCallback
+     */
+    SuccessCallback _completeCallback;
+
+    /**
+     *  The receivers pass the data to us
+     */
+    friend class DeferredReceiver;
+    friend class DeferredExtReceiver;
+
+    /**
+     *  Set the meta data, when the header frame was received
+     *  @param  metadata
+     *  @param  size        size of the body
+     */
+    void set(const MetaData &metadata, uint64_t size)
+    {
+        // store the meta data
+        MetaData::set(metadata);
+
+        // and the size
+        _bodySize = size;
+    }
+
+    /**
+     *  Pass a chunk of the body to user space
+     *  @param  data
+     *  @param  size
+     */
+    void process(const char *data, size_t size)
+    {
+        // update the number of bytes received
+        _received += size;
+
+        // pass on
+        if (_dataCallback) _dataCallback(data, size);
+    }
+
+    /**
+     *  Report that the message is complete
+     */
+    void complete()
+    {
+        // pass on
+        if (_completeCallback) _completeCallback();
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  exchange
+     *  @param  routingkey
+     *  @param  deliveryTag
+     *  @param  redelivered
+     */
+    MessageStream(const StringView &exchange, const StringView &routingkey, uint64_t deliveryTag, bool redelivered) :
+        _exchange(exchange), _routingkey(routingkey), _deliveryTag(deliveryTag), _redelivered(redelivered) {}
+
+    /**
+     *  No copying
+     *  @param  that
+     */
+    MessageStream(const MessageStream &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~MessageStream() = default;
+
+    /**
+     *  The exchange to which it was originally published
+     *  @return std::string
+     */
+    const std::string &exchange() const { return _exchange; }
+
+    /**
+     *  The routing key that was originally used
+     *  @return std::string
+     */
+    const std::string &routingkey() const { return _routingkey; }
+
+    /**
+     *  The delivery tag, that is needed to ack or reject the message
+     *  @return uint64_t
+     */
+    uint64_t deliveryTag() const { return _deliveryTag; }
+
+    /**
+     *  Is this a redelivered message?
+     *  @return bool
+     */
+    bool redelivered() const { return _redelivered; }
+
+    /**
+     *  The size of the body
+     *  @return uint64_t
+     */
+    uint64_t bodySize() const { return _bodySize; }
+
+    /**
+     *  The number of bytes of the body that were received so far
+     *  @return uint64_t
+     */
+    uint64_t received() const { return _received; }
+
+    /**
+     *  Register the function that is called for each chunk of the body. The
+     *  data points into the buffer in which it was received, and is only valid
+     *  during the call: copy it if you need it later. If you can not keep up,
+     *  you can call Connection::pause() to stop reading from the socket, and
+     *  Connection::resume() when you are ready for more data.
+     *
+     *  @param  callback    The callback to invoke
+     *  @return Same object for chaining
+     */
+    MessageStream &onData(const DataCallback &callback)
+    {
+        // store callback
+        _dataCallback = callback;
+
+        // allow chaining
+        return *this;
+    }
+
+    /**
+     *  Register the function that is called when the message is complete
+     *
+     *  @param  callback    The callback to invoke
+     *  @return Same object for chaining
+     */
+    MessageStream &onComplete(const SuccessCallback &callback)
+    {
+        // store callback
+        _completeCallback = callback;
+
+        // allow chaining
+        return *this;
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
@@ -15,9 +15,12 @@
 /**
  *  Dependencies
  */
+#include "receivedframe.h"
 #include "booleanset.h"
 #include "stringfield.h"
 #include "table.h"
+#include "tableencoder.h"
+#include "fieldview.h"
 
 /**
  *  Set up namespace
@@ -60,6 +63,21 @@ protected:
      */
     Table _headers;
 
+    /**
+     *  The encoded header fields (without the size of the table), this is
+     *  used instead of the table when it is not empty
+     *  @var    std::string
+     */
+    std::string _encodedHeaders;
+
+    /**
+     *  The table that is decoded from the encoded headers when it is first
+     *  used (it is accessed atomically, because const objects may be shared
+     *  between threads)
+     *  @var    std::shared_ptr<const Table>
+     */
+    mutable std::shared_ptr<const Table> _decodedHeaders;
+
     /**
      *  Delivery mode (non-persistent (1) or persistent (2))
      *  @var    UOctet
@@ -127,12 +145,61 @@ protected:
     ShortString _clusterID;
 
 
+    /**
+     *  Read the encoded headers from a frame, the table is only built when
+     *  the headers() method is called, so that the fields can also be
+     *  processed with visitHeaders() without creating a table at all
+     *  @param  frame
+     *  @throws ProtocolException   if the encoded headers are invalid
+     */
+    void decodeHeaders(ReceivedFrame &frame)
+    {
+        // the table starts with its size
+        uint32_t size = frame.nextUint32();
+
+        // the fields that make up the table
+        const char *data = frame.nextData(size);
+
+        // check them right away, so that errors are reported while the frame is parsed
+        FieldView::validate(StringView(data, size));
+
+        // store the fields
+        _encodedHeaders.assign(data, size);
+    }
+
     /**
      *  Protected constructor to ensure that this class can only be constructed
      *  in a derived class
      */
     MetaData() {}
 
+    /**
+     *  The table with headers, decoded from the encoded fields if necessary
+     *  @return Table
+     */
+    const Table &decodedHeaders() const
+    {
+        // leap out if the headers were not encoded
+        if (_encodedHeaders.empty()) return _headers;
+
+        // the table may already have been decoded (possibly by an other thread)
+        auto decoded = std::atomic_load(&_decodedHeaders);
+
+        // leap out if it was
+        if (decoded) return *decoded;
+
+        // decode the fields (they were validated when they were received, so this does not throw)
+        ReceivedFrame frame(_encodedHeaders.data(), _encodedHeaders.size());
+        decoded = std::make_shared<Table>(frame, (uint32_t)_encodedHeaders.size());
+
+        // store it, unless an other thread was faster (then we use that table instead)
+        std::shared_ptr<const Table> expected;
+        if (std::atomic_compare_exchange_strong(&_decodedHeaders, &expected, decoded)) return *decoded;
+
+        // use the table of the other thread
+        return *expected;
+    }
+
 
 public:
     /**
@@ -146,7 +213,7 @@ public:
         // only copy the properties that were sent
         if (hasContentType())       _contentType = ShortString(frame);
         if (hasContentEncoding())   _contentEncoding = ShortString(frame);
-        if (hasHeaders())           _headers = Table(frame);
+        if (hasHeaders())           decodeHeaders(frame);
         if (hasDeliveryMode())      _deliveryMode = UOctet(frame);
         if (hasPriority())          _priority = UOctet(frame);
         if (hasCorrelationID())     _correlationID = ShortString(frame);
@@ -177,6 +244,8 @@ public:
         _contentType = data._contentType;
         _contentEncoding = data._contentEncoding;
         _headers = data._headers;
+        _encodedHeaders = data._encodedHeaders;
+        _decodedHeaders = std::atomic_load(&data._decodedHeaders);
         _deliveryMode = data._deliveryMode;
         _priority = data._priority;
         _correlationID = data._correlationID;
@@ -218,7 +287,7 @@ public:
     void setCorrelationID   (const std::string &value) { _correlationID     = value; _bools1.set(2,true); }
     void setPriority        (uint8_t value)            { _priority          = value; _bools1.set(3,true); }
     void setDeliveryMode    (uint8_t value)            { _deliveryMode      = value; _bools1.set(4,true); }
-    void setHeaders         (const Table &value)       { _headers           = value; _bools1.set(5,true); }
+    void setHeaders         (const Table &value)       { _headers           = value; _encodedHeaders.clear(); _decodedHeaders = nullptr; _bools1.set(5,true); }
     void setContentEncoding (const std::string &value) { _contentEncoding   = value; _bools1.set(6,true); }
     void setContentType     (const std::string &value) { _contentType       = value; _bools1.set(7,true); }
     void setClusterID       (const std::string &value) { _clusterID         = value; _bools2.set(2,true); }
@@ -236,7 +305,7 @@ public:
     void setExpiration      (std::string &&value) { _expiration       = std::move(value); _bools1.set(0,true); }
     void setReplyTo         (std::string &&value) { _replyTo          = std::move(value); _bools1.set(1,true); }
     void setCorrelationID   (std::string &&value) { _correlationID    = std::move(value); _bools1.set(2,true); }
-    void setHeaders         (Table &&value)       { _headers          = std::move(value); _bools1.set(5,true); }
+    void setHeaders         (Table &&value)       { _headers          = std::move(value); _encodedHeaders.clear(); _decodedHeaders = nullptr; _bools1.set(5,true); }
     void setContentEncoding (std::string &&value) { _contentEncoding  = std::move(value); _bools1.set(6,true); }
     void setContentType     (std::string &&value) { _contentType      = std::move(value); _bools1.set(7,true); }
     void setClusterID       (std::string &&value) { _clusterID        = std::move(value); _bools2.set(2,true); }
@@ -254,7 +323,7 @@ public:
     const std::string &correlationID  () const { return _correlationID;     }
           uint8_t      priority       () const { return _priority;          }
           uint8_t      deliveryMode   () const { return _deliveryMode;      }
-    const Table       &headers        () const { return _headers;           }
+    const Table       &headers        () const { return decodedHeaders();   }
     const std::string &contentEncoding() const { return _contentEncoding;   }
     const std::string &contentType    () const { return _contentType;       }
     const std::string &clusterID      () const { return _clusterID;         }
@@ -264,6 +333,35 @@ public:
           uint64_t     timestamp      () const { return _timestamp;         }
     const std::string &messageID      () const { return _messageID;         }
 
+    /**
+     *  Set the headers from fields that were already encoded (this is
+     *  faster than building a table)
+     *  @param  value
+     */
+    void setHeaders(const TableEncoder &value)
+    {
+        // store the fields, the table is only decoded when it is asked for
+        _encodedHeaders = value.data();
+        _headers = Table();
+        _decodedHeaders = nullptr;
+        _bools1.set(5,true);
+    }
+
+    /**
+     *  Pass each header field to a callback, without building a table (the
+     *  views that are passed to the callback are only valid during the call,
+     *  received headers were already validated so this does not throw)
+     *  @param  callback
+     */
+    void visitHeaders(const FieldCallback &callback) const
+    {
+        // if the headers were set with a table we have to encode it first
+        if (_encodedHeaders.empty()) return FieldView::table(TableEncoder(_headers).data(), callback);
+
+        // process the encoded fields
+        FieldView::table(_encodedHeaders, callback);
+    }
+
     /**
      *  Is this a message with persistent storage
      *  This is an alias for retrieving the delivery mode and checking if it is set to 2
@@ -307,7 +405,7 @@ public:
         if (hasCorrelationID())     result += (uint32_t)_correlationID.size();
         if (hasPriority())          result += (uint32_t)_priority.size();
         if (hasDeliveryMode())      result += (uint32_t)_deliveryMode.size();
-        if (hasHeaders())           result += (uint32_t)_headers.size();
+        if (hasHeaders())           result += (uint32_t)(_encodedHeaders.empty() ? _headers.size() : _encodedHeaders.size() + 4);
         if (hasContentEncoding())   result += (uint32_t)_contentEncoding.size();
         if (hasContentType())       result += (uint32_t)_contentType.size();
         if (hasClusterID())         result += (uint32_t)_clusterID.size();
@@ -321,6 +419,20 @@ public:
         return result;
     }
 
+    /**
+     *  Fill an output buffer with the headers
+     *  @param  buffer
+     */
+    void fillHeaders(OutBuffer &buffer) const
+    {
+        // use the table if there are no encoded fields
+        if (_encodedHeaders.empty()) return _headers.fill(buffer);
+
+        // the size of the table, followed by the fields
+        buffer.add((uint32_t)_encodedHeaders.size());
+        buffer.add(_encodedHeaders);
+    }
+
     /**
      *  Fill an output buffer
      *  @param  buffer
@@ -334,7 +446,7 @@ public:
         // only copy the properties that were sent
         if (hasContentType())       _contentType.fill(buffer);
         if (hasContentEncoding())   _contentEncoding.fill(buffer);
-        if (hasHeaders())           _headers.fill(buffer);
+        if (hasHeaders())           fillHeaders(buffer);
         if (hasDeliveryMode())      _deliveryMode.fill(buffer);
         if (hasPriority())          _priority.fill(buffer);
         if (hasCorrelationID())     _correlationID.fill(buffer);
@@ -31,12 +31,53 @@ class OutBuffer
 {
 protected:
     /**
-     *  The method that adds the actual data
+     *  Contiguous memory in which data can be written directly, derived
+     *  classes that have such memory set this up with the window() method.
+     *  Only when the data does not fit, the virtual append() method is called.
+     *  @var char*
+     */
+    char *_cursor = nullptr;
+    char *_end = nullptr;
+
+    /**
+     *  Set the memory in which data can be written directly
+     *  @param  begin
+     *  @param  end
+     */
+    void window(char *begin, char *end)
+    {
+        // store the range
+        _cursor = begin;
+        _end = end;
+    }
+
+    /**
+     *  The method that adds the actual data (called if it does not fit in the window)
      *  @param  data
      *  @param  size
      */
     virtual void append(const void *data, size_t size) = 0;
 
+    /**
+     *  Write data, straight into the window if possible
+     *  @param  data
+     *  @param  size
+     */
+    void write(const void *data, size_t size)
+    {
+        // nothing to write
+        if (size == 0) return;
+
+        // use the virtual method if the data does not fit
+        if (size > size_t(_end - _cursor)) return append(data, size);
+
+        // copy the data
+        memcpy(_cursor, data, size);
+
+        // move the cursor
+        _cursor += size;
+    }
+
 public:
     /**
      *  Destructor
@@ -53,7 +94,7 @@ public:
     void add(const char *string, uint32_t size)
     {
         // append data
-        append(string, size);
+        write(string, size);
     }
 
     /**
@@ -64,7 +105,7 @@ public:
     void add(const std::string &string)
     {
         // add data
-        append(string.c_str(), string.size());
+        write(string.c_str(), string.size());
     }
 
     /**
@@ -74,7 +115,7 @@ public:
     void add(uint8_t value)
     {
         // append one byte
-        append(&value, sizeof(value));
+        write(&value, sizeof(value));
     }
 
     /**
@@ -87,7 +128,7 @@ public:
         uint16_t v = htobe16(value);
         
         // append the data
-        append(&v, sizeof(v));
+        write(&v, sizeof(v));
     }
 
     /**
@@ -100,7 +141,7 @@ public:
         uint32_t v = htobe32(value);
         
         // append the data
-        append(&v, sizeof(v));
+        write(&v, sizeof(v));
     }
 
     /**
@@ -113,7 +154,7 @@ public:
         uint64_t v = htobe64(value);
         
         // append the data
-        append(&v, sizeof(v));
+        write(&v, sizeof(v));
     }
 
     /**
@@ -123,7 +164,7 @@ public:
     void add(int8_t value)
     {
         // append the data
-        append(&value, sizeof(value));
+        write(&value, sizeof(value));
     }
 
     /**
@@ -136,7 +177,7 @@ public:
         int16_t v = htobe16(value);
         
         // append the data
-        append(&v, sizeof(v));
+        write(&v, sizeof(v));
     }
 
     /**
@@ -149,7 +190,7 @@ public:
         int32_t v = htobe32(value);
 
         // append the data
-        append(&v, sizeof(v));
+        write(&v, sizeof(v));
     }
 
     /**
@@ -162,7 +203,7 @@ public:
         int64_t v = htobe64(value);
         
         // append the data
-        append(&v, sizeof(v));
+        write(&v, sizeof(v));
     }
 
     /**
@@ -172,7 +213,7 @@ public:
     void add(float value)
     {
         // append the data
-        append(&value, sizeof(value));
+        write(&value, sizeof(value));
     }
 
     /**
@@ -182,7 +223,7 @@ public:
     void add(double value)
     {
         // append the data
-        append(&value, sizeof(value));
+        write(&value, sizeof(value));
     }
 };
 
@@ -8,7 +8,7 @@
  *  This is a class that is used internally by the AMQP library. As a user
  *  of this library, you normally do not have to instantiate it.
  *
- *  @copyright 2014 - 2017 Copernica BV
+ *  @copyright 2014 - 2020 Copernica BV
  */
 
 /**
@@ -20,6 +20,9 @@
  *  Dependencies
  */
 #include <cstdint>
+#include <cstring>
+#include "endian.h"
+#include "buffer.h"
 
 /**
  *  Set up namespace
@@ -29,7 +32,6 @@ namespace AMQP {
 /**
  *  Forward declarations
  */
-class Buffer;
 class ConnectionImpl;
 
 /**
@@ -39,10 +41,36 @@ class ReceivedFrame
 {
 private:
     /**
-     *  The buffer we are reading from
+     *  The buffer we are reading from (nullptr if the frame is read from contiguous data)
      *  @var    Buffer
      */
-    const Buffer &_buffer;
+    const Buffer *_buffer = nullptr;
+
+    /**
+     *  Contiguous data, when this is set the fields are read straight from
+     *  memory, without calling the (virtual) methods of the buffer
+     *  @var    const char *
+     */
+    const char *_data = nullptr;
+
+    /**
+     *  Position of the frame in the buffer
+     *  @var    size_t
+     */
+    size_t _offset = 0;
+
+    /**
+     *  Number of bytes that are available (from the start of the frame)
+     *  @var    size_t
+     */
+    size_t _available;
+
+    /**
+     *  Number of bytes that may be read, once the frame is complete this
+     *  is the end of the payload, so that fields can not be read beyond it
+     *  @var    size_t
+     */
+    size_t _end;
 
     /**
      *  Number of bytes already processed
@@ -132,6 +160,49 @@ private:
      */
     bool processHeaderFrame(ConnectionImpl *connection);
 
+    /**
+     *  Parse the frame header, and check the frame size and the end-of-frame marker
+     *  @param  max         Max size for a frame
+     */
+    void initialize(uint32_t max);
+
+    /**
+     *  Report that a field does not fit in the frame
+     *  @throws ProtocolException
+     */
+    [[noreturn]] static void outOfRange();
+
+    /**
+     *  Make sure that a number of bytes can be read from the frame
+     *  @param  size
+     */
+    void check(size_t size) const
+    {
+        // this is the only check per field, a single comparison
+        if (_end - _skip < size) outOfRange();
+    }
+
+    /**
+     *  Read the next value from the frame (in network-byte-order)
+     *  @return T
+     */
+    template <typename T>
+    T next()
+    {
+        // check if there is enough size
+        check(sizeof(T));
+
+        // copy the bytes, straight from memory if we can
+        T value;
+        if (_data) memcpy(&value, _data + _skip, sizeof(T));
+        else _buffer->copy(_offset + _skip, sizeof(T), &value);
+
+        // the bytes have been processed
+        _skip += sizeof(T);
+
+        // done
+        return value;
+    }
 
 public:
     /**
@@ -139,7 +210,42 @@ public:
      *  @param  buffer      Binary buffer
      *  @param  max         Max buffer size
      */
-    ReceivedFrame(const Buffer &buffer, uint32_t max);
+    ReceivedFrame(const Buffer &buffer, uint32_t max) : ReceivedFrame(buffer, 0, max) {}
+
+    /**
+     *  Constructor for a frame that starts somewhere in a buffer
+     *  @param  buffer      Binary buffer
+     *  @param  offset      Position of the frame in the buffer
+     *  @param  max         Max buffer size
+     */
+    ReceivedFrame(const Buffer &buffer, size_t offset, uint32_t max) : 
+        _buffer(&buffer), _offset(offset), _available(buffer.size() - offset), _end(_available)
+    {
+        // parse the header
+        initialize(max);
+    }
+
+    /**
+     *  Constructor for a frame in contiguous memory, this is the fast path
+     *  @param  data        Pointer to the frame
+     *  @param  size        Number of bytes available
+     *  @param  max         Max buffer size
+     */
+    ReceivedFrame(const char *data, size_t size, uint32_t max) : 
+        _data(data), _available(size), _end(size)
+    {
+        // parse the header
+        initialize(max);
+    }
+
+    /**
+     *  Constructor for encoded fields that are not part of a frame (there
+     *  is no frame header, all data can be read right away)
+     *  @param  data        Pointer to the fields
+     *  @param  size        Size of the data
+     */
+    ReceivedFrame(const char *data, size_t size) : 
+        _data(data), _available(size), _end(size) {}
 
     /**
      *  Destructor
@@ -151,13 +257,28 @@ public:
      *  The header contains the frame type, the channel ID and the payload size
      *  @return bool
      */
-    bool header() const;
+    bool header() const
+    {
+        return _available >= 7;
+    }
 
     /**
      *  Is this a complete frame?
      *  @return bool
      */
-    bool complete() const;
+    bool complete() const
+    {
+        return _available >= _payloadSize + 8;
+    }
+
+    /**
+     *  Return the type of frame
+     *  @return uint8_t
+     */
+    uint8_t type() const
+    {
+        return _type;
+    }
 
     /**
      *  Return the channel identifier
@@ -192,77 +313,130 @@ public:
      *
      *  @return uint8_t         value read
      */
-    uint8_t nextUint8();
+    uint8_t nextUint8()
+    {
+        return next<uint8_t>();
+    }
 
     /**
      *  Read the next int8_t from the buffer
      *
      *  @return int8_t          value read
      */
-    int8_t nextInt8();
+    int8_t nextInt8()
+    {
+        return next<int8_t>();
+    }
 
     /**
      *  Read the next uint16_t from the buffer
      *
      *  @return uint16_t        value read
      */
-    uint16_t nextUint16();
+    uint16_t nextUint16()
+    {
+        return be16toh(next<uint16_t>());
+    }
 
     /**
      *  Read the next int16_t from the buffer
      *
      *  @return int16_t     value read
      */
-    int16_t nextInt16();
+    int16_t nextInt16()
+    {
+        return be16toh(next<int16_t>());
+    }
 
     /**
      *  Read the next uint32_t from the buffer
      *
      *  @return uint32_t        value read
      */
-    uint32_t nextUint32();
+    uint32_t nextUint32()
+    {
+        return be32toh(next<uint32_t>());
+    }
 
     /**
      *  Read the next int32_t from the buffer
      *
      *  @return int32_t     value read
      */
-    int32_t nextInt32();
+    int32_t nextInt32()
+    {
+        return be32toh(next<int32_t>());
+    }
 
     /**
      *  Read the next uint64_t from the buffer
      *
      *  @return uint64_t        value read
      */
-    uint64_t nextUint64();
+    uint64_t nextUint64()
+    {
+        return be64toh(next<uint64_t>());
+    }
 
     /**
      *  Read the next int64_t from the buffer
      *
      *  @return int64_t     value read
      */
-    int64_t nextInt64();
+    int64_t nextInt64()
+    {
+        return be64toh(next<int64_t>());
+    }
 
     /**
      *  Read a float from the buffer
      *
      *  @return float       float read from buffer.
      */
-    float nextFloat();
+    float nextFloat()
+    {
+        return next<float>();
+    }
 
     /**
      *  Read a double from the buffer
      *
      *  @return double      double read from buffer
      */
-    double nextDouble();
+    double nextDouble()
+    {
+        return next<double>();
+    }
+
+    /**
+     *  Is the frame read from contiguous memory? In that case, all pointers
+     *  returned by nextData() stay valid for as long as the frame is processed
+     *  @return bool
+     */
+    bool contiguous() const
+    {
+        return _data != nullptr;
+    }
 
     /**
      *  Get a pointer to the next binary buffer of a certain size
      *  @param  size
      *  @return char*
      */
-    const char *nextData(uint32_t size);
+    const char *nextData(uint32_t size)
+    {
+        // check if there is enough size
+        check(size);
+
+        // get the data
+        const char *result = _data ? _data + _skip : _buffer->data(_offset + _skip, size);
+
+        // the bytes have been processed
+        _skip += size;
+
+        // done
+        return result;
+    }
 
     /**
      *  Process the received frame
@@ -276,13 +450,6 @@ public:
      *  @internal
      */
     bool process(ConnectionImpl *connection);
-
-
-    /**
-     *  The checker may access private data
-     */
-    friend class FrameCheck;
-
 };
 
 /**
@@ -0,0 +1,581 @@
+/**
+ *  Stats.h
+ *
+ *  Counters, high-water marks and latency histograms that are kept for a
+ *  connection or a channel. Collecting statistics is opt-in: nothing is
+ *  recorded until a Stats object is installed with Connection::stats() or
+ *  Channel::stats(). All values are relaxed atomics, so they can be read
+ *  from any thread while the connection is busy.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class Stats
+{
+public:
+    /**
+     *  The kinds of frames that are counted separately
+     */
+    enum FrameType {
+        method,                     // method frames (all instructions and their answers)
+        header,                     // header frames (the envelope properties of a message)
+        body,                       // body frames (the content of a message)
+        heartbeat,                  // heartbeat frames
+        other                       // the protocol header
+    };
+
+    /**
+     *  A value that only goes up
+     */
+    class Counter
+    {
+    private:
+        /**
+         *  The value
+         *  @var std::atomic<uint64_t>
+         */
+        std::atomic<uint64_t> _value{0};
+
+    public:
+        /**
+         *  Increment the counter
+         *  @param  amount
+         */
+        void add(uint64_t amount = 1) { _value.fetch_add(amount, std::memory_order_relaxed); }
+
+        /**
+         *  The current value
+         *  @return uint64_t
+         */
+        uint64_t value() const { return _value.load(std::memory_order_relaxed); }
+
+        /**
+         *  Reset to zero
+         */
+        void reset() { _value.store(0, std::memory_order_relaxed); }
+    };
+
+    /**
+     *  A value that goes up and down, for which the highest value is remembered
+     */
+    class Gauge
+    {
+    private:
+        /**
+         *  The current value
+         *  @var std::atomic<uint64_t>
+         */
+        std::atomic<uint64_t> _current{0};
+
+        /**
+         *  The highest value so far
+         *  @var std::atomic<uint64_t>
+         */
+        std::atomic<uint64_t> _maximum{0};
+
+    public:
+        /**
+         *  Update the value
+         *  @param  value
+         */
+        void set(uint64_t value)
+        {
+            // store the current value
+            _current.store(value, std::memory_order_relaxed);
+
+            // only the thread that owns the connection writes, so we do not need a compare-exchange
+            if (value > _maximum.load(std::memory_order_relaxed)) _maximum.store(value, std::memory_order_relaxed);
+        }
+
+        /**
+         *  Increase the value
+         *  @param  amount
+         */
+        void increment(uint64_t amount = 1) { set(current() + amount); }
+
+        /**
+         *  Decrease the value
+         *  @param  amount
+         */
+        void decrement(uint64_t amount = 1) { _current.fetch_sub(amount, std::memory_order_relaxed); }
+
+        /**
+         *  The current value
+         *  @return uint64_t
+         */
+        uint64_t current() const { return _current.load(std::memory_order_relaxed); }
+
+        /**
+         *  The high-water mark
+         *  @return uint64_t
+         */
+        uint64_t maximum() const { return _maximum.load(std::memory_order_relaxed); }
+
+        /**
+         *  Reset the high-water mark to the current value
+         */
+        void reset() { _maximum.store(current(), std::memory_order_relaxed); }
+    };
+
+    /**
+     *  A distribution of durations. Bucket 0 holds everything below one
+     *  microsecond, bucket N holds durations from 2^(N-1) up to 2^N microseconds.
+     */
+    class Histogram
+    {
+    public:
+        /**
+         *  Number of buckets (the last one holds everything above half an hour)
+         */
+        static const size_t buckets = 32;
+
+    private:
+        /**
+         *  Number of measurements per bucket
+         *  @var std::atomic<uint64_t>[]
+         */
+        std::atomic<uint64_t> _buckets[buckets];
+
+        /**
+         *  Sum of all measurements, in microseconds
+         *  @var std::atomic<uint64_t>
+         */
+        std::atomic<uint64_t> _sum{0};
+
+        /**
+         *  The longest measurement, in microseconds
+         *  @var std::atomic<uint64_t>
+         */
+        std::atomic<uint64_t> _maximum{0};
+
+    public:
+        /**
+         *  Constructor
+         */
+        Histogram() { reset(); }
+
+        /**
+         *  Add a measurement
+         *  @param  duration
+         */
+        void add(std::chrono::steady_clock::duration duration)
+        {
+            // the duration in microseconds
+            uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+
+            // find the bucket
+            size_t bucket = 0;
+            for (uint64_t value = us; value > 0 && bucket < buckets - 1; value >>= 1) bucket += 1;
+
+            // update the administration
+            _buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+            _sum.fetch_add(us, std::memory_order_relaxed);
+
+            // only the thread that owns the connection writes, so we do not need a compare-exchange
+            if (us > _maximum.load(std::memory_order_relaxed)) _maximum.store(us, std::memory_order_relaxed);
+        }
+
+        /**
+         *  Number of measurements in a bucket
+         *  @param  bucket
+         *  @return uint64_t
+         */
+        uint64_t bucket(size_t bucket) const
+        {
+            return bucket < buckets ? _buckets[bucket].load(std::memory_order_relaxed) : 0;
+        }
+
+        /**
+         *  Total number of measurements
+         *  @return uint64_t
+         */
+        uint64_t count() const
+        {
+            // the result
+            uint64_t result = 0;
+
+            // add up all buckets
+            for (size_t i = 0; i < buckets; ++i) result += bucket(i);
+
+            // done
+            return result;
+        }
+
+        /**
+         *  The sum of all measurements in microseconds (divide by count() for the average)
+         *  @return uint64_t
+         */
+        uint64_t sum() const { return _sum.load(std::memory_order_relaxed); }
+
+        /**
+         *  The longest measurement in microseconds
+         *  @return uint64_t
+         */
+        uint64_t maximum() const { return _maximum.load(std::memory_order_relaxed); }
+
+        /**
+         *  An upper bound for a percentile in microseconds, for example
+         *  percentile(99) returns the duration that 99% of the measurements did not exceed
+         *  @param  percentage
+         *  @return uint64_t
+         */
+        uint64_t percentile(double percentage) const
+        {
+            // the number of measurements that should be below the result
+            double required = count() * percentage / 100.0;
+
+            // number of measurements seen so far
+            uint64_t seen = 0;
+
+            // find the bucket that holds the percentile
+            for (size_t i = 0; i < buckets; ++i)
+            {
+                // add the measurements in the bucket
+                seen += bucket(i);
+
+                // is this the bucket?
+                if (seen > 0 && seen >= required) return i == 0 ? 1 : uint64_t(1) << i;
+            }
+
+            // no measurements at all
+            return 0;
+        }
+
+        /**
+         *  Remove all measurements
+         */
+        void reset()
+        {
+            // empty all buckets
+            for (auto &bucket : _buckets) bucket.store(0, std::memory_order_relaxed);
+
+            // and the totals
+            _sum.store(0, std::memory_order_relaxed);
+            _maximum.store(0, std::memory_order_relaxed);
+        }
+    };
+
+private:
+    /**
+     *  Number of frames sent, per type
+     *  @var Counter[]
+     */
+    Counter _framesSent[5];
+
+    /**
+     *  Number of bytes sent, per type of frame
+     *  @var Counter[]
+     */
+    Counter _bytesSent[5];
+
+    /**
+     *  Number of frames received, per type
+     *  @var Counter[]
+     */
+    Counter _framesReceived[5];
+
+    /**
+     *  Number of bytes received, per type of frame
+     *  @var Counter[]
+     */
+    Counter _bytesReceived[5];
+
+    /**
+     *  Message counters
+     *  @var Counter
+     */
+    Counter _published;
+    Counter _delivered;
+    Counter _acked;
+    Counter _rejected;
+    Counter _confirmed;
+    Counter _nacked;
+    Counter _returned;
+
+    /**
+     *  Number of TLS handshakes, full and resumed (only for secure TcpConnections)
+     *  @var Counter
+     */
+    Counter _handshakes;
+    Counter _resumed;
+
+    /**
+     *  Time between publishing a message and receiving the confirmation (publisher confirms only)
+     *  @var Histogram
+     */
+    Histogram _confirmLatency;
+
+    /**
+     *  Time between sending a synchronous instruction and receiving its answer
+     *  @var Histogram
+     */
+    Histogram _operationLatency;
+
+    /**
+     *  Number of frames that were queued on the connection (during the handshake or recovery)
+     *  @var Gauge
+     */
+    Gauge _connectionQueue;
+
+    /**
+     *  Number of frames that were queued on channels (waiting for synchronous operations)
+     *  @var Gauge
+     */
+    Gauge _channelQueue;
+
+    /**
+     *  Number of bytes in the outgoing buffer of the TCP connection
+     *  @var Gauge
+     */
+    Gauge _outputBuffer;
+
+    /**
+     *  Map the type byte of a frame to an index in the counters
+     *  @param  type
+     *  @return size_t
+     */
+    static size_t index(uint8_t type)
+    {
+        switch (type) {
+        case 1:     return method;
+        case 2:     return header;
+        case 3:     return body;
+        case 8:     return heartbeat;
+        default:    return other;
+        }
+    }
+
+    /**
+     *  Record a frame that was sent
+     *  @param  type        type byte of the frame
+     *  @param  size        total size of the frame
+     */
+    void sent(uint8_t type, uint64_t size)
+    {
+        _framesSent[index(type)].add();
+        _bytesSent[index(type)].add(size);
+    }
+
+    /**
+     *  Record a frame that was received
+     *  @param  type        type byte of the frame
+     *  @param  size        total size of the frame
+     */
+    void received(uint8_t type, uint64_t size)
+    {
+        _framesReceived[index(type)].add();
+        _bytesReceived[index(type)].add(size);
+    }
+
+    /**
+     *  Add up the counters of all frame types
+     *  @param  counters
+     *  @return uint64_t
+     */
+    static uint64_t total(const Counter counters[])
+    {
+        return counters[0].value() + counters[1].value() + counters[2].value() + counters[3].value() + counters[4].value();
+    }
+
+    /**
+     *  The classes that record the statistics
+     */
+    friend class ConnectionImpl;
+    friend class ChannelImpl;
+    friend class TcpConnection;
+
+public:
+    /**
+     *  Constructor
+     */
+    Stats() = default;
+
+    /**
+     *  Stats can not be copied (they are shared between the connection and user space)
+     *  @param  that
+     */
+    Stats(const Stats &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~Stats() = default;
+
+    /**
+     *  Number of frames sent, in total or of a certain type
+     *  @param  type
+     *  @return uint64_t
+     */
+    uint64_t framesSent() const { return total(_framesSent); }
+    uint64_t framesSent(FrameType type) const { return _framesSent[type].value(); }
+
+    /**
+     *  Number of bytes sent, in total or in frames of a certain type
+     *  @param  type
+     *  @return uint64_t
+     */
+    uint64_t bytesSent() const { return total(_bytesSent); }
+    uint64_t bytesSent(FrameType type) const { return _bytesSent[type].value(); }
+
+    /**
+     *  Number of frames received, in total or of a certain type
+     *  @param  type
+     *  @return uint64_t
+     */
+    uint64_t framesReceived() const { return total(_framesReceived); }
+    uint64_t framesReceived(FrameType type) const { return _framesReceived[type].value(); }
+
+    /**
+     *  Number of bytes received, in total or in frames of a certain type
+     *  @param  type
+     *  @return uint64_t
+     */
+    uint64_t bytesReceived() const { return total(_bytesReceived); }
+    uint64_t bytesReceived(FrameType type) const { return _bytesReceived[type].value(); }
+
+    /**
+     *  Number of messages published
+     *  @return uint64_t
+     */
+    uint64_t published() const { return _published.value(); }
+
+    /**
+     *  Number of messages delivered (to consumers and by get operations)
+     *  @return uint64_t
+     */
+    uint64_t delivered() const { return _delivered.value(); }
+
+    /**
+     *  Number of ack frames sent to the server
+     *  @return uint64_t
+     */
+    uint64_t acked() const { return _acked.value(); }
+
+    /**
+     *  Number of reject and nack frames sent to the server
+     *  @return uint64_t
+     */
+    uint64_t rejected() const { return _rejected.value(); }
+
+    /**
+     *  Number of publisher confirms received (ack frames from the server)
+     *  @return uint64_t
+     */
+    uint64_t confirmed() const { return _confirmed.value(); }
+
+    /**
+     *  Number of negative publisher confirms received (nack frames from the server)
+     *  @return uint64_t
+     */
+    uint64_t nacked() const { return _nacked.value(); }
+
+    /**
+     *  Number of messages that were returned by the server
+     *  @return uint64_t
+     */
+    uint64_t returned() const { return _returned.value(); }
+
+    /**
+     *  Number of full TLS handshakes (only for secure TcpConnections)
+     *  @return uint64_t
+     */
+    uint64_t handshakes() const { return _handshakes.value(); }
+
+    /**
+     *  Number of TLS handshakes in which a previous session was resumed
+     *  @return uint64_t
+     */
+    uint64_t resumed() const { return _resumed.value(); }
+
+    /**
+     *  Round-trip time of publisher confirms
+     *  @return Histogram
+     */
+    const Histogram &confirmLatency() const { return _confirmLatency; }
+
+    /**
+     *  Round-trip time of synchronous operations (declaring, binding, opening channels, etc)
+     *  @return Histogram
+     */
+    const Histogram &operationLatency() const { return _operationLatency; }
+
+    /**
+     *  Number of frames waiting in the queue of the connection
+     *  @return Gauge
+     */
+    const Gauge &connectionQueue() const { return _connectionQueue; }
+
+    /**
+     *  Number of frames waiting in the queue of the channel (or of all channels, for the stats of a connection)
+     *  @return Gauge
+     */
+    const Gauge &channelQueue() const { return _channelQueue; }
+
+    /**
+     *  Number of bytes waiting in the outgoing buffer (only for TcpConnections)
+     *  @return Gauge
+     */
+    const Gauge &outputBuffer() const { return _outputBuffer; }
+
+    /**
+     *  Reset all counters and histograms (the high-water marks are reset to the current values)
+     */
+    void reset()
+    {
+        // reset the frame counters
+        for (size_t i = 0; i < 5; ++i)
+        {
+            _framesSent[i].reset();
+            _bytesSent[i].reset();
+            _framesReceived[i].reset();
+            _bytesReceived[i].reset();
+        }
+
+        // reset the message counters
+        _published.reset();
+        _delivered.reset();
+        _acked.reset();
+        _rejected.reset();
+        _confirmed.reset();
+        _nacked.reset();
+        _returned.reset();
+
+        // reset the handshake counters
+        _handshakes.reset();
+        _resumed.reset();
+
+        // reset the histograms and gauges
+        _confirmLatency.reset();
+        _operationLatency.reset();
+        _connectionQueue.reset();
+        _channelQueue.reset();
+        _outputBuffer.reset();
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
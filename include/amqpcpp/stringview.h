@@ -0,0 +1,130 @@
+/**
+ *  StringView.h
+ *
+ *  Reference to string data that is owned by someone else, for example
+ *  to a string in a frame that was just received. The data is only valid
+ *  for as long as the owner keeps it, if you need it for a longer time you
+ *  should convert it into a std::string.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <string>
+#include <cstring>
+#include <ostream>
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class StringView
+{
+private:
+    /**
+     *  The string data
+     *  @var const char *
+     */
+    const char *_data = "";
+
+    /**
+     *  Size of the data
+     *  @var size_t
+     */
+    size_t _size = 0;
+
+public:
+    /**
+     *  Constructor for an empty string
+     */
+    StringView() = default;
+
+    /**
+     *  Constructor
+     *  @param  data
+     *  @param  size
+     */
+    StringView(const char *data, size_t size) : _data(data), _size(size) {}
+
+    /**
+     *  Constructor that refers to a std::string
+     *  @param  string
+     */
+    StringView(const std::string &string) : _data(string.data()), _size(string.size()) {}
+
+    /**
+     *  Constructor that refers to a null-terminated string
+     *  @param  string
+     */
+    StringView(const char *string) : _data(string), _size(strlen(string)) {}
+
+    /**
+     *  The string data (not null-terminated)
+     *  @return const char *
+     */
+    const char *data() const { return _data; }
+
+    /**
+     *  Size of the string
+     *  @return size_t
+     */
+    size_t size() const { return _size; }
+
+    /**
+     *  Is the string empty?
+     *  @return bool
+     */
+    bool empty() const { return _size == 0; }
+
+    /**
+     *  Copy the data into a std::string
+     *  @return std::string
+     */
+    std::string str() const { return std::string(_data, _size); }
+
+    /**
+     *  Cast to a std::string (this copies the data)
+     *  @return std::string
+     */
+    operator std::string () const { return str(); }
+
+    /**
+     *  Compare with other strings
+     *  @param  that
+     *  @return bool
+     */
+    bool operator==(const StringView &that) const { return _size == that._size && memcmp(_data, that._data, _size) == 0; }
+    bool operator!=(const StringView &that) const { return !operator==(that); }
+    bool operator==(const std::string &that) const { return operator==(StringView(that)); }
+    bool operator!=(const std::string &that) const { return !operator==(StringView(that)); }
+    bool operator==(const char *that) const { return operator==(StringView(that, strlen(that))); }
+    bool operator!=(const char *that) const { return !operator==(that); }
+
+    /**
+     *  Write the string to a stream
+     *  @param  stream
+     *  @param  view
+     *  @return std::ostream
+     */
+    friend std::ostream &operator<<(std::ostream &stream, const StringView &view)
+    {
+        return stream.write(view._data, view._size);
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
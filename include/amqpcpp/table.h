@@ -53,6 +53,15 @@ public:
      */
     Table(ReceivedFrame &frame);
 
+    /**
+     *  Decode fields from a received frame into a table, when the size
+     *  of the encoded fields is already known
+     *
+     *  @param  frame   received frame to decode
+     *  @param  size    number of bytes to decode
+     */
+    Table(ReceivedFrame &frame, uint32_t size);
+
     /**
      *  Copy constructor
      *  @param  table
@@ -0,0 +1,175 @@
+/**
+ *  TableEncoder.h
+ *
+ *  Class to build an encoded header table without creating a Table object.
+ *  The fields are written to a buffer right away, in the same format as
+ *  they are sent to the server, and the encoded table can be passed to the
+ *  setHeaders() method of an Envelope. This is faster than filling a
+ *  Table when you have a fixed set of headers for each message.
+ *
+ *      AMQP::TableEncoder headers;
+ *      headers.add("tenant", tenant).add("version", 3).add("created", AMQP::Timestamp(time(nullptr)));
+ *      envelope.setHeaders(headers);
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include "outbuffer.h"
+#include "field.h"
+#include "numericfield.h"
+#include "stringfield.h"
+#include "booleanset.h"
+#include "table.h"
+#include "stringview.h"
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class TableEncoder
+{
+private:
+    /**
+     *  Output buffer that appends to a string
+     */
+    class Writer : public OutBuffer
+    {
+    private:
+        /**
+         *  The string to append to
+         *  @var std::string
+         */
+        std::string &_data;
+
+    protected:
+        /**
+         *  Append data
+         *  @param  data
+         *  @param  size
+         */
+        virtual void append(const void *data, size_t size) override
+        {
+            _data.append((const char *)data, size);
+        }
+
+    public:
+        /**
+         *  Constructor
+         *  @param  data
+         */
+        Writer(std::string &data) : _data(data) {}
+
+        /**
+         *  Destructor
+         */
+        virtual ~Writer() = default;
+    };
+
+    /**
+     *  The encoded fields (without the size of the table)
+     *  @var std::string
+     */
+    std::string _data;
+
+public:
+    /**
+     *  Constructor
+     */
+    TableEncoder() = default;
+
+    /**
+     *  Constructor that encodes all fields of a table
+     *  @param  table
+     */
+    TableEncoder(const Table &table)
+    {
+        // let the table fill the buffer
+        Writer writer(_data);
+        table.fill(writer);
+
+        // remove the size of the table
+        _data.erase(0, sizeof(uint32_t));
+    }
+
+    /**
+     *  Destructor
+     */
+    virtual ~TableEncoder() = default;
+
+    /**
+     *  Add a field
+     *  @param  name        name of the field (max 255 bytes)
+     *  @param  value       the value
+     *  @return TableEncoder
+     */
+    TableEncoder &add(const StringView &name, const Field &value)
+    {
+        // the buffer to write to
+        Writer writer(_data);
+
+        // the name, the type and the value
+        writer.add((uint8_t)name.size());
+        writer.add(name.data(), (uint32_t)name.size());
+        writer.add((uint8_t)value.typeID());
+        value.fill(writer);
+
+        // allow chaining
+        return *this;
+    }
+
+    /**
+     *  Add a field, the type is derived from the value (strings are
+     *  stored as long strings, like the Table class does)
+     *  @param  name        name of the field
+     *  @param  value       the value
+     *  @return TableEncoder
+     */
+    TableEncoder &add(const StringView &name, const std::string &value) { return add(name, LongString(value)); }
+    TableEncoder &add(const StringView &name, const char *value) { return add(name, LongString(value)); }
+    TableEncoder &add(const StringView &name, bool value) { return add(name, BooleanSet(value)); }
+    TableEncoder &add(const StringView &name, int8_t value) { return add(name, Octet(value)); }
+    TableEncoder &add(const StringView &name, uint8_t value) { return add(name, UOctet(value)); }
+    TableEncoder &add(const StringView &name, int16_t value) { return add(name, Short(value)); }
+    TableEncoder &add(const StringView &name, uint16_t value) { return add(name, UShort(value)); }
+    TableEncoder &add(const StringView &name, int32_t value) { return add(name, Long(value)); }
+    TableEncoder &add(const StringView &name, uint32_t value) { return add(name, ULong(value)); }
+    TableEncoder &add(const StringView &name, int64_t value) { return add(name, LongLong(value)); }
+    TableEncoder &add(const StringView &name, uint64_t value) { return add(name, ULongLong(value)); }
+    TableEncoder &add(const StringView &name, float value) { return add(name, Float(value)); }
+    TableEncoder &add(const StringView &name, double value) { return add(name, Double(value)); }
+
+    /**
+     *  Remove all fields
+     */
+    void clear() { _data.clear(); }
+
+    /**
+     *  Are there any fields?
+     *  @return bool
+     */
+    bool empty() const { return _data.empty(); }
+
+    /**
+     *  The encoded fields (without the size of the table)
+     *  @return std::string
+     */
+    const std::string &data() const { return _data; }
+};
+
+/**
+ *  End of namespace
+ */
+}
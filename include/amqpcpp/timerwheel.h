@@ -0,0 +1,339 @@
+/**
+ *  TimerWheel.h
+ *
+ *  Timer administration that can be shared by many connections that run
+ *  on the same event loop. Instead of a timer per connection (which has
+ *  to be re-armed every time a heartbeat is sent), the event loop only
+ *  needs a single timer that ticks at a coarse granularity and advances
+ *  the wheel. Scheduling, rescheduling and cancelling a timer are O(1).
+ *
+ *  This is a hashed wheel: a deadline that is further away than one
+ *  revolution simply stays in its slot until its tick has come, so there
+ *  is no limit on how far in the future a deadline can be.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class TimerWheel
+{
+public:
+    /**
+     *  Base class for objects that can be scheduled on the wheel
+     */
+    class Timer
+    {
+    private:
+        /**
+         *  The wheel on which the timer is scheduled (nullptr if not scheduled)
+         *  @var TimerWheel
+         */
+        TimerWheel *_wheel = nullptr;
+
+        /**
+         *  The list in which the timer is stored (a slot, or the list of expired timers)
+         *  @var Timer*
+         */
+        Timer **_list = nullptr;
+
+        /**
+         *  Neighbours in the list
+         *  @var Timer*
+         */
+        Timer *_prev = nullptr;
+        Timer *_next = nullptr;
+
+        /**
+         *  The tick at which the timer expires
+         *  @var uint64_t
+         */
+        uint64_t _tick = 0;
+
+        /**
+         *  The wheel manages the members
+         */
+        friend class TimerWheel;
+
+    public:
+        /**
+         *  Constructor
+         */
+        Timer() = default;
+
+        /**
+         *  Timers cannot be copied or moved (the wheel holds a pointer)
+         *  @param  that
+         */
+        Timer(const Timer &that) = delete;
+
+        /**
+         *  Destructor
+         */
+        virtual ~Timer()
+        {
+            // remove from the wheel
+            if (_wheel) _wheel->cancel(this);
+        }
+
+        /**
+         *  Is the timer scheduled?
+         *  @return bool
+         */
+        bool scheduled() const { return _wheel != nullptr; }
+
+        /**
+         *  Method that is called when the timer expires
+         */
+        virtual void onExpired() = 0;
+    };
+
+private:
+    /**
+     *  Number of slots in the wheel
+     *  @var size_t
+     */
+    static const size_t slots = 256;
+
+    /**
+     *  Number of seconds per tick
+     *  @var double
+     */
+    double _interval;
+
+    /**
+     *  The last tick that was processed
+     *  @var uint64_t
+     */
+    uint64_t _current;
+
+    /**
+     *  The slots, each slot holds a list of timers
+     *  @var Timer*[]
+     */
+    Timer *_slots[slots];
+
+    /**
+     *  Timers that have expired, but that were not yet notified
+     *  @var Timer*
+     */
+    Timer *_expired = nullptr;
+
+    /**
+     *  Number of scheduled timers
+     *  @var size_t
+     */
+    size_t _size = 0;
+
+
+    /**
+     *  Convert a time to a tick
+     *  @param  time
+     *  @return uint64_t
+     */
+    uint64_t tick(double time) const
+    {
+        // round up, a timer should never expire too early
+        return uint64_t(std::ceil(time / _interval));
+    }
+
+    /**
+     *  Add a timer to a list
+     *  @param  list
+     *  @param  timer
+     */
+    static void link(Timer **list, Timer *timer)
+    {
+        // insert at the front
+        timer->_list = list;
+        timer->_prev = nullptr;
+        timer->_next = *list;
+
+        // update the neighbour and the head
+        if (*list) (*list)->_prev = timer;
+        *list = timer;
+    }
+
+    /**
+     *  Remove a timer from the list that it is in
+     *  @param  timer
+     */
+    static void unlink(Timer *timer)
+    {
+        // update the neighbours (or the head of the list)
+        if (timer->_prev) timer->_prev->_next = timer->_next;
+        else *timer->_list = timer->_next;
+        if (timer->_next) timer->_next->_prev = timer->_prev;
+
+        // the timer is no longer in a list
+        timer->_list = nullptr;
+        timer->_prev = timer->_next = nullptr;
+    }
+
+public:
+    /**
+     *  Constructor
+     *  @param  now         the current time (in seconds)
+     *  @param  interval    number of seconds per tick
+     */
+    TimerWheel(double now, double interval = 1.0) : _interval(interval), _current(uint64_t(now / interval))
+    {
+        // all slots are empty
+        std::fill(_slots, _slots + slots, nullptr);
+    }
+
+    /**
+     *  The wheel cannot be copied or moved (the timers hold a pointer)
+     *  @param  that
+     */
+    TimerWheel(const TimerWheel &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~TimerWheel()
+    {
+        // forget about the expired timers
+        while (_expired) cancel(_expired);
+
+        // and about the scheduled timers
+        for (size_t i = 0; i < slots; ++i) while (_slots[i]) cancel(_slots[i]);
+    }
+
+    /**
+     *  Number of seconds per tick
+     *  @return double
+     */
+    double interval() const { return _interval; }
+
+    /**
+     *  Number of scheduled timers
+     *  @return size_t
+     */
+    size_t size() const { return _size; }
+
+    /**
+     *  Is the wheel empty?
+     *  @return bool
+     */
+    bool empty() const { return _size == 0; }
+
+    /**
+     *  Schedule a timer (if it was already scheduled, it is moved)
+     *  @param  timer       the timer to schedule
+     *  @param  expire      the time at which it expires (in seconds)
+     */
+    void schedule(Timer *timer, double expire)
+    {
+        // remove it from its current position
+        if (timer->_wheel) cancel(timer);
+
+        // the tick at which it expires (at least the next tick)
+        timer->_tick = std::max(tick(expire), _current + 1);
+        timer->_wheel = this;
+
+        // add it to the slot
+        link(&_slots[timer->_tick % slots], timer);
+
+        // one timer more
+        _size += 1;
+    }
+
+    /**
+     *  Cancel a timer
+     *  @param  timer
+     */
+    void cancel(Timer *timer)
+    {
+        // must be scheduled on this wheel
+        if (timer->_wheel != this) return;
+
+        // remove it from its list
+        unlink(timer);
+
+        // it is no longer on the wheel
+        timer->_wheel = nullptr;
+
+        // one timer less
+        _size -= 1;
+    }
+
+    /**
+     *  Move the wheel forward, and notify all timers that have expired. The
+     *  timers may schedule or cancel timers (including themselves), and may
+     *  even destruct other timers from within their onExpired() method.
+     *  @param  now         the current time (in seconds)
+     */
+    void advance(double now)
+    {
+        // the tick that we have reached
+        uint64_t target = uint64_t(now / _interval);
+
+        // leap out if we are not yet at the next tick
+        if (target <= _current) return;
+
+        // the number of slots that we have to check (there is no need to check a slot twice)
+        uint64_t steps = std::min(target - _current, uint64_t(slots));
+
+        // check all slots that we passed
+        for (uint64_t i = 1; i <= steps; ++i)
+        {
+            // the slot to check
+            Timer *timer = _slots[(_current + i) % slots];
+
+            // check all timers in the slot
+            while (timer)
+            {
+                // remember the next one, because the timer may be moved
+                Timer *next = timer->_next;
+
+                // move expired timers to the expired list
+                if (timer->_tick <= target) { unlink(timer); link(&_expired, timer); }
+
+                // proceed with the next one
+                timer = next;
+            }
+        }
+
+        // we have reached the tick
+        _current = target;
+
+        // notify the expired timers one by one (the list may change while we do this)
+        while (_expired)
+        {
+            // the timer to notify
+            Timer *timer = _expired;
+
+            // it is no longer on the wheel
+            cancel(timer);
+
+            // notify it
+            timer->onExpired();
+        }
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
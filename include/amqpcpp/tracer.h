@@ -0,0 +1,123 @@
+/**
+ *  Tracer.h
+ *
+ *  Interface for objects that want to be notified about the progress of
+ *  frames through the library, to find out where the time goes between
+ *  reading bytes from a socket and calling user space (and the other way
+ *  around when publishing).
+ *
+ *  The hooks are only compiled into the library when it is built with
+ *  AMQP_CPP_TRACING defined (cmake -DAMQP-CPP_TRACING=ON), in all other
+ *  builds they do not cost a thing.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ *  Macro that is used inside the library to report an event
+ */
+#ifdef AMQP_CPP_TRACING
+#define AMQP_CPP_TRACE(event, channel, value) AMQP::Tracer::trace(AMQP::Tracer::event, channel, value)
+#else
+#define AMQP_CPP_TRACE(event, channel, value) ((void)0)
+#endif
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class Tracer
+{
+public:
+    /**
+     *  The events that are reported
+     */
+    enum Event {
+        read,                       // bytes were read from the socket (value: number of bytes)
+        received,                   // a complete frame was recognized (value: size of the frame)
+        dispatched,                 // the frame was processed (value: size of the frame)
+        enter,                      // a message is passed to user space (value: delivery tag)
+        leave,                      // user space returned from the message callback (value: delivery tag)
+        publish,                    // user space started publishing a message (value: size of the body)
+        sent,                       // a frame was passed to the connection handler (value: size of the frame)
+        buffered,                   // data could not be sent right away, and was buffered (value: number of bytes)
+        written                     // bytes were written to the socket (value: number of bytes)
+    };
+
+private:
+    /**
+     *  The installed tracer
+     *  @return std::atomic<Tracer*>
+     */
+    static std::atomic<Tracer*> &current()
+    {
+        // the installed tracer
+        static std::atomic<Tracer*> tracer(nullptr);
+
+        // expose it
+        return tracer;
+    }
+
+public:
+    /**
+     *  Destructor
+     */
+    virtual ~Tracer() = default;
+
+    /**
+     *  Method that is called for every event. This is called from the thread
+     *  that is running the connection, and while the library is busy, so it
+     *  should be fast: store the data and analyze it later.
+     *  @param  event       the event
+     *  @param  channel     the channel (0 if the event is not about a channel, or if it is not known)
+     *  @param  value       the value, depending on the type of event
+     *  @param  time        the time of the event
+     */
+    virtual void onEvent(Event event, uint16_t channel, uint64_t value, std::chrono::steady_clock::time_point time) = 0;
+
+    /**
+     *  Install a tracer for all connections (pass a nullptr to remove it)
+     *  @param  tracer
+     */
+    static void install(Tracer *tracer)
+    {
+        current().store(tracer, std::memory_order_release);
+    }
+
+    /**
+     *  Report an event to the installed tracer
+     *  @param  event
+     *  @param  channel
+     *  @param  value
+     */
+    static void trace(Event event, uint16_t channel, uint64_t value)
+    {
+        // the installed tracer
+        auto *tracer = current().load(std::memory_order_acquire);
+
+        // pass on the event
+        if (tracer) tracer->onEvent(event, channel, value, std::chrono::steady_clock::now());
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
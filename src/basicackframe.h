@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class defintion
  */
-class BasicAckFrame : public BasicFrame {
+class BasicAckFrame : public MethodCodec<BasicAckFrame, BasicFrame> {
 private:
     /**
      *  server-assigned and channel specific delivery tag
@@ -29,23 +29,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param   buffer  buffer to write frame to
-     *  @return  pointer to object to allow for chaining
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // add the delivery tag
-        buffer.add(_deliveryTag);
-
-        // add the booleans
-        _multiple.fill(buffer);
+        visitor(self._deliveryTag, self._multiple);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic acknowledgement frame
@@ -55,18 +53,24 @@ public:
      *  @param  multiple        acknowledge mutiple messages
      */
     BasicAckFrame(uint16_t channel, uint64_t deliveryTag, bool multiple = false) :
-        BasicFrame(channel, 9),
+        Codec(channel),
         _deliveryTag(deliveryTag),
-        _multiple(multiple) {}
+        _multiple(multiple)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct based on received frame
      *  @param  frame
      */
     BasicAckFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _deliveryTag(frame.nextUint64()),
-        _multiple(frame) {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -130,6 +134,9 @@ public:
         // if there is no deferred confirm, we can just as well stop
         if (confirm == nullptr) return false;
 
+        // update the statistics
+        channel->reportConfirm(deliveryTag(), multiple(), true);
+
         // process the frame
         confirm->process(*this);
 
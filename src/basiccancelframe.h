@@ -12,7 +12,7 @@ namespace AMQP{
 /**
  *  Class implementation
  */
-class BasicCancelFrame : public BasicFrame
+class BasicCancelFrame : public MethodCodec<BasicCancelFrame, BasicFrame>
 {
 private:
     /**
@@ -29,27 +29,33 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param   buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // add consumer tag + booleans
-        _consumerTag.fill(buffer);
-        _noWait.fill(buffer);
+        visitor(self._consumerTag, self._noWait);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic cancel frame from a received frame
      *
      *  @param  frame   received frame to parse
      */
-    BasicCancelFrame(ReceivedFrame &frame) : BasicFrame(frame), _consumerTag(frame), _noWait(frame) {}
+    BasicCancelFrame(ReceivedFrame &frame) :
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
     
     /**
      *  Construct a basic cancel frame
@@ -59,9 +65,13 @@ public:
      *  @param  noWait          whether to wait for a response.
      */
     BasicCancelFrame(uint16_t channel, const std::string& consumerTag, bool noWait = false) : 
-        BasicFrame(channel, (uint32_t)(consumerTag.size() + 2)),    // 1 for extra string size, 1 for bool
+        Codec(channel),
         _consumerTag(consumerTag),
-        _noWait(noWait) {}
+        _noWait(noWait)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
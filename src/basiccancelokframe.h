@@ -12,7 +12,7 @@ namespace AMQP{
 /**
  *  Class implementation
  */
-class BasicCancelOKFrame : public BasicFrame
+class BasicCancelOKFrame : public MethodCodec<BasicCancelOKFrame, BasicFrame>
 {
 private:
     /**
@@ -23,19 +23,21 @@ private:
 
 protected:
     /**
-     * Encode a frame on a string buffer
-     *
-     * @param   buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // add own information
-        _consumerTag.fill(buffer);
+        visitor(self._consumerTag);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic cancel ok frame
@@ -43,9 +45,11 @@ public:
      *  @param  frame   received frame
      */
     BasicCancelOKFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _consumerTag(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Construct a basic cancel ok frame (client-side)
@@ -53,9 +57,12 @@ public:
      *  @param  consumerTag holds the consumertag specified by client or server
      */
     BasicCancelOKFrame(uint16_t channel, std::string& consumerTag) :
-        BasicFrame(channel, (uint32_t)(consumerTag.length() + 1)),    // add 1 byte for encoding the size of consumer tag
+        Codec(channel),
         _consumerTag(consumerTag)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
@@ -12,7 +12,7 @@ namespace AMQP{
 /**
  *  Class implementation
  */
-class BasicConsumeFrame : public BasicFrame
+class BasicConsumeFrame : public MethodCodec<BasicConsumeFrame, BasicFrame>
 {
 private:
     /**
@@ -55,23 +55,21 @@ private:
 
 protected:
     /**
-     * Encode a frame on a string buffer
-     *
-     * @param   buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-        
-        // fill the buffer
-        buffer.add((uint16_t) _deprecated);
-        _queueName.fill(buffer);
-        _consumerTag.fill(buffer);
-        _bools.fill(buffer);
-        _filter.fill(buffer);
+        visitor(self._deprecated, self._queueName, self._consumerTag, self._bools, self._filter);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic consume frame
@@ -86,25 +84,26 @@ public:
      *  @param  filter          additional arguments
      */
     BasicConsumeFrame(uint16_t channel, const std::string& queueName, const std::string& consumerTag, bool noLocal = false, bool noAck = false, bool exclusive = false, bool noWait = false, const Table& filter = {}) :
-        BasicFrame(channel, (uint32_t)(queueName.length() + consumerTag.length() + 5 + filter.size())), // size of vars, +1 for each shortstring size, +1 for bools, +2 for deprecated value
+        Codec(channel),
         _queueName(queueName),
         _consumerTag(consumerTag),
         _bools(noLocal, noAck, exclusive, noWait),
         _filter(filter)
-    {}    
+    {
+        // calculate the size
+        measure();
+    }    
 
     /**
      *  Constructor based on incoming data
      *  @param  frame
      */
     BasicConsumeFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _deprecated(frame.nextUint16()), // read deprecated info
-        _queueName(frame),
-        _consumerTag(frame),
-        _bools(frame),
-        _filter(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
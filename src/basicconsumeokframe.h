@@ -12,7 +12,7 @@ namespace AMQP{
 /**
  *  Class implementation
  */
-class BasicConsumeOKFrame : public BasicFrame
+class BasicConsumeOKFrame : public MethodCodec<BasicConsumeOKFrame, BasicFrame>
 {
 private:
     /**
@@ -23,19 +23,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // add payload
-        _consumerTag.fill(buffer);
+        visitor(self._consumerTag);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic consume frame
@@ -43,9 +45,12 @@ public:
      *  @param  consumerTag       consumertag specified by client of provided by server
      */
     BasicConsumeOKFrame(uint16_t channel, const std::string& consumerTag) :
-        BasicFrame(channel, (uint32_t)(consumerTag.length() + 1)), // length of string + 1 for encoding of stringsize
+        Codec(channel),
         _consumerTag(consumerTag)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct a basic consume ok frame from a received frame
@@ -53,9 +58,11 @@ public:
      *  @param frame    received frame
      */
     BasicConsumeOKFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _consumerTag(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -13,6 +13,7 @@
  *  Dependencies
  */
 #include "basicframe.h"
+#include "methodcodec.h"
 #include "amqpcpp/stringfield.h"
 #include "amqpcpp/booleanset.h"
 #include "amqpcpp/connectionimpl.h"
@@ -26,14 +27,14 @@ namespace AMQP{
 /**
  *  Class implementation
  */
-class BasicDeliverFrame : public BasicFrame
+class BasicDeliverFrame : public MethodCodec<BasicDeliverFrame, BasicFrame>
 {
 private:
     /**
      *  identifier for the consumer, valid within current channel
-     *  @var ShortString
+     *  @var ShortStringView
      */
-    ShortString _consumerTag;
+    ShortStringView _consumerTag;
 
     /**
      *  server-assigned and channel specific delivery tag
@@ -49,33 +50,33 @@ private:
 
     /**
      *  the name of the exchange to publish to. An empty exchange name means the default exchange.
-     *  @var ShortString
+     *  @var ShortStringView
      */
-    ShortString _exchange;
+    ShortStringView _exchange;
 
     /**
      *  Message routing key
-     *  @var ShortString
+     *  @var ShortStringView
      */
-    ShortString _routingKey;
+    ShortStringView _routingKey;
 
 protected:
     /**
-     * Encode a frame on a string buffer
-     *
-     * @param   buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        BasicFrame::fill(buffer);
-
-        _consumerTag.fill(buffer);
-        buffer.add(_deliveryTag);
-        _redelivered.fill(buffer);
-        _exchange.fill(buffer);
-        _routingKey.fill(buffer);
+        visitor(self._consumerTag, self._deliveryTag, self._redelivered, self._exchange, self._routingKey);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic deliver frame (client side)
@@ -88,14 +89,17 @@ public:
      *  @param  routingKey      message routing key
      */
     BasicDeliverFrame(uint16_t channel, const std::string& consumerTag, uint64_t deliveryTag, bool redelivered = false, const std::string& exchange = "", const std::string& routingKey = "") :
-        BasicFrame(channel, (uint32_t)(consumerTag.length() + exchange.length() + routingKey.length() + 12)),
+        Codec(channel),
             // length of strings + 1 byte per string for stringsize, 8 bytes for uint64_t and 1 for bools
         _consumerTag(consumerTag),
         _deliveryTag(deliveryTag),
         _redelivered(redelivered),
         _exchange(exchange),
         _routingKey(routingKey)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct a basic deliver frame from a received frame
@@ -103,13 +107,11 @@ public:
      *  @param  frame   received frame
      */
     BasicDeliverFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _consumerTag(frame),
-        _deliveryTag(frame.nextUint64()),
-        _redelivered(frame),
-        _exchange(frame),
-        _routingKey(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -118,18 +120,18 @@ public:
 
     /**
      *  Return the name of the exchange to publish to
-     *  @return  string
+     *  @return  StringView
      */
-    const std::string& exchange() const
+    const StringView &exchange() const
     {
         return _exchange;
     }
 
     /**
      *  Return the routing key
-     *  @return  string
+     *  @return  StringView
      */
-    const std::string& routingKey() const
+    const StringView &routingKey() const
     {
         return _routingKey;
     }
@@ -165,9 +167,9 @@ public:
 
     /**
      *  Return the identifier for the consumer (channel specific)
-     *  @return  string
+     *  @return  StringView
      */
-    const std::string& consumerTag() const
+    const StringView &consumerTag() const
     {
         return _consumerTag;
     }
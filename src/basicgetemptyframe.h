@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class BasicGetEmptyFrame : public BasicFrame 
+class BasicGetEmptyFrame : public MethodCodec<BasicGetEmptyFrame, BasicFrame> 
 {
 private:
     /**
@@ -23,19 +23,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // recreate deprecated field and encode
-        _deprecated.fill(buffer);
+        visitor(self._deprecated);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 
 public:
     /**
@@ -44,17 +46,22 @@ public:
      *  @param  channel     channel we're working on
      */
     BasicGetEmptyFrame(uint16_t channel) :
-        BasicFrame(channel, 1)  // 1 for encoding the deprecated cluster id (shortstring)
-    {}
+        Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor for incoming data
      *  @param  frame   received frame
      */
     BasicGetEmptyFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _deprecated(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
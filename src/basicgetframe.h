@@ -12,7 +12,7 @@ namespace AMQP{
 /**
  *  Class implementation
  */
-class BasicGetFrame : public BasicFrame 
+class BasicGetFrame : public MethodCodec<BasicGetFrame, BasicFrame> 
 {
 private:
     /**
@@ -35,21 +35,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // encode other values
-        buffer.add(_deprecated);
-        _queue.fill(buffer);
-        _noAck.fill(buffer);
+        visitor(self._deprecated, self._queue, self._noAck);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic get frame
@@ -59,21 +59,24 @@ public:
      *  @param  noAck        whether server expects acknowledgements for messages     
      */
     BasicGetFrame(uint16_t channel, const std::string& queue, bool noAck = false) :
-        BasicFrame(channel, (uint32_t)(queue.length() + 4)), // 1 for bool, 1 for string size, 2 for deprecated field
+        Codec(channel),
         _queue(queue),
         _noAck(noAck)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor based on incoming frame
      *  @param  frame
      */
     BasicGetFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _deprecated(frame.nextUint16()),
-        _queue(frame),
-        _noAck(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -12,7 +12,7 @@ namespace AMQP{
 /**
  *  Class implementation
  */
-class BasicGetOKFrame : public BasicFrame
+class BasicGetOKFrame : public MethodCodec<BasicGetOKFrame, BasicFrame>
 {
 private:
     /**
@@ -29,15 +29,15 @@ private:
 
     /**
      *  the name of the exchange to publish to. An empty exchange name means the default exchange.
-     *  @var ShortString
+     *  @var ShortStringView
      */
-    ShortString _exchange;
+    ShortStringView _exchange;
 
     /**
      *  Message routing key
-     *  @var ShortString
+     *  @var ShortStringView
      */
-    ShortString _routingKey;
+    ShortStringView _routingKey;
 
     /**
      *  number of messages in the queue
@@ -47,23 +47,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // encode rest of the fields
-        buffer.add(_deliveryTag);
-        _redelivered.fill(buffer);
-        _exchange.fill(buffer);
-        _routingKey.fill(buffer);
-        buffer.add(_messageCount);
+        visitor(self._deliveryTag, self._redelivered, self._exchange, self._routingKey, self._messageCount);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic get ok frame
@@ -76,13 +74,16 @@ public:
      *  @param  messageCount    number of messages in the queue
      */
     BasicGetOKFrame(uint16_t channel, uint64_t deliveryTag, bool redelivered, const std::string& exchange, const std::string& routingKey, uint32_t messageCount) :
-        BasicFrame(channel, (uint32_t)(exchange.length() + routingKey.length() + 15)), // string length, +1 for each shortsrting length + 8 (uint64_t) + 4 (uint32_t) + 1 (bool)
+        Codec(channel),
         _deliveryTag(deliveryTag),
         _redelivered(redelivered),
         _exchange(exchange),
         _routingKey(routingKey),
         _messageCount(messageCount)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct a basic get ok frame from a received frame
@@ -90,13 +91,11 @@ public:
      *  @param  frame   received frame
      */
     BasicGetOKFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _deliveryTag(frame.nextUint64()),
-        _redelivered(frame),
-        _exchange(frame),
-        _routingKey(frame),
-        _messageCount(frame.nextUint32())
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -105,18 +104,18 @@ public:
 
     /**
      *  Return the name of the exchange to publish to
-     *  @return string
+     *  @return  StringView
      */
-    const std::string& exchange() const
+    const StringView &exchange() const
     {
         return _exchange;
     }
 
     /**
      *  Return the routing key
-     *  @return string
+     *  @return  StringView
      */
-    const std::string& routingKey() const
+    const StringView &routingKey() const
     {
         return _routingKey;
     }
@@ -125,6 +125,16 @@ public:
         return 60;
     }
 
+    /**
+     *  Content frames follow a publish frame that was already sent, so they
+     *  are also sent when the connection is being closed
+     *  @return bool
+     */
+    virtual bool partOfShutdown() const override
+    {
+        return true;
+    }
+
     /**
      *  Process the frame
      *  @param  connection      The connection over which it was received
@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class defintion
  */
-class BasicNackFrame : public BasicFrame {
+class BasicNackFrame : public MethodCodec<BasicNackFrame, BasicFrame> {
 private:
     /**
      *  server-assigned and channel specific delivery tag
@@ -28,23 +28,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param   buffer  buffer to write frame to
-     *  @return  pointer to object to allow for chaining
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // add the delivery tag
-        buffer.add(_deliveryTag);
-
-        // add the booleans
-        _bits.fill(buffer);
+        visitor(self._deliveryTag, self._bits);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic negative-acknowledgement frame
@@ -55,18 +53,24 @@ public:
      *  @param  requeue         requeue the message
      */
     BasicNackFrame(uint16_t channel, uint64_t deliveryTag, bool multiple = false, bool requeue = false) :
-        BasicFrame(channel, 9),
+        Codec(channel),
         _deliveryTag(deliveryTag),
-        _bits(multiple, requeue) {}
+        _bits(multiple, requeue)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct based on received frame
      *  @param  frame
      */
     BasicNackFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _deliveryTag(frame.nextUint64()),
-        _bits(frame) {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -128,6 +132,9 @@ public:
         // if there is no deferred confirm, we can just as well stop
         if (confirm == nullptr) return false;
 
+        // update the statistics
+        channel->reportConfirm(deliveryTag(), multiple(), false);
+
         // process the frame
         confirm->process(*this);
 
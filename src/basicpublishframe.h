@@ -12,7 +12,7 @@ namespace AMQP{
 /**
  *  Class implementation
  */
-class BasicPublishFrame : public BasicFrame 
+class BasicPublishFrame : public MethodCodec<BasicPublishFrame, BasicFrame> 
 {
 private:
     /**
@@ -43,22 +43,21 @@ private:
 
 protected:
     /**
-     * Encode a frame on a string buffer
-     *
-     * @param   buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // encode fields
-        buffer.add(_deprecated);
-        _exchange.fill(buffer);
-        _routingKey.fill(buffer);
-        _bools.fill(buffer);
+        visitor(self._deprecated, self._exchange, self._routingKey, self._bools);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic publish frame
@@ -70,11 +69,14 @@ public:
      *  @param  immediate       request immediate delivery       @default = false
      */
     BasicPublishFrame(uint16_t channel, const std::string& exchange = "", const std::string& routingKey = "", bool mandatory = false, bool immediate = false) :
-        BasicFrame(channel, (uint32_t)(exchange.length() + routingKey.length() + 5)), // 1 extra per string (for the size), 1 for bools, 2 for deprecated field
+        Codec(channel),
         _exchange(exchange),
         _routingKey(routingKey),
         _bools(mandatory, immediate)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct a basic publish frame from a received frame
@@ -82,12 +84,11 @@ public:
      *  @param frame    received frame to parse
      */
     BasicPublishFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _deprecated(frame.nextInt16()),
-        _exchange(frame),
-        _routingKey(frame),
-        _bools(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -105,6 +106,16 @@ public:
         return false;
     }
 
+    /**
+     *  Can this frame be held back while the server has blocked the connection?
+     *
+     *  The server does not accept published messages while it is blocked
+     */
+    bool blockable() const override
+    {
+        return true;
+    }
+
     /**
      *  Return the name of the exchange to publish to
      *  @return  string
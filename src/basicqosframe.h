@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class BasicQosFrame : public BasicFrame
+class BasicQosFrame : public MethodCodec<BasicQosFrame, BasicFrame>
 {
 private:
     /**
@@ -35,20 +35,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *  @param   buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_prefetchSize);
-        buffer.add(_prefetchCount);
-        _global.fill(buffer);
+        visitor(self._prefetchSize, self._prefetchCount, self._global);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      * Construct a basic qos frame
@@ -59,22 +60,25 @@ public:
      * @default false
      */
     BasicQosFrame(uint16_t channel, int16_t prefetchCount = 0, bool global = false) :
-        BasicFrame(channel, 7), // 4 (int32) + 2 (int16) + 1 (bool)
+        Codec(channel),
         _prefetchSize(0),
         _prefetchCount(prefetchCount),
         _global(global)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor based on incoming frame
      *  @param  frame
      */
     BasicQosFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _prefetchSize(frame.nextInt32()),
-        _prefetchCount(frame.nextInt16()),
-        _global(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -12,32 +12,41 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class BasicQosOKFrame : public BasicFrame
+class BasicQosOKFrame : public MethodCodec<BasicQosOKFrame, BasicFrame>
 {
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param      buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base, then done (no other params)
-        BasicFrame::fill(buffer);
+        visitor();
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic qos ok frame
      *  @param  channel     channel we're working on
      */
-    BasicQosOKFrame(uint16_t channel) : BasicFrame(channel, 0) {}
+    BasicQosOKFrame(uint16_t channel) : Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor based on incoming data
      *  @param  frame
      */
-    BasicQosOKFrame(ReceivedFrame &frame) : BasicFrame(frame) {}
+    BasicQosOKFrame(ReceivedFrame &frame) : Codec(frame) {}
 
     /**
      *  Destructor
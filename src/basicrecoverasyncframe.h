@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class definition
  */
-class BasicRecoverAsyncFrame : public BasicFrame {
+class BasicRecoverAsyncFrame : public MethodCodec<BasicRecoverAsyncFrame, BasicFrame> {
 private:
     /**
      *  Server will try to requeue messages. If requeue is false or requeue attempt fails, messages are discarded or dead-lettered
@@ -22,19 +22,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // encode fields
-        _requeue.fill(buffer);
+        visitor(self._requeue);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic recover async frame from a received frame
@@ -42,9 +44,11 @@ public:
      *  @param  frame   received frame
      */
     BasicRecoverAsyncFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _requeue(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Construct a basic recover-async frame
@@ -53,9 +57,12 @@ public:
      *  @param  requeue         whether to attempt to requeue messages
      */
     BasicRecoverAsyncFrame(uint16_t channel, bool requeue = false) :
-        BasicFrame(channel, 1), //sizeof bool
+        Codec(channel),
         _requeue(requeue)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
@@ -12,19 +12,25 @@ namespace AMQP {
 /**
  *  Class definition
  */
-class BasicRecoverOKFrame : public BasicFrame {
+class BasicRecoverOKFrame : public MethodCodec<BasicRecoverOKFrame, BasicFrame>
+{
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base then done, no other fields to encode
-        BasicFrame::fill(buffer);
+        visitor();
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic recover ok frame from a received frame
@@ -32,7 +38,7 @@ public:
      *  @param frame    received frame
      */
     BasicRecoverOKFrame(ReceivedFrame &frame) :
-        BasicFrame(frame)
+        Codec(frame)
     {}
 
     /**
@@ -41,8 +47,11 @@ public:
      *  @param  channel         channel id
      */
     BasicRecoverOKFrame(uint16_t channel) :
-        BasicFrame(channel, 0)
-    {}
+        Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
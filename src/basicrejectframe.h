@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class definition
  */
-class BasicRejectFrame : public BasicFrame 
+class BasicRejectFrame : public MethodCodec<BasicRejectFrame, BasicFrame> 
 {
 private:
     /**
@@ -29,20 +29,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // encode fields
-        buffer.add(_deliveryTag);
-        _requeue.fill(buffer);
+        visitor(self._deliveryTag, self._requeue);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  construct a basic reject frame from a received frame
@@ -50,10 +51,11 @@ public:
      *  @param  frame   received frame
      */
     BasicRejectFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _deliveryTag(frame.nextInt64()),
-        _requeue(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Construct a basic reject frame
@@ -63,10 +65,13 @@ public:
      *  @param  requeue         whether to attempt to requeue messages
      */
     BasicRejectFrame(uint16_t channel, int64_t deliveryTag, bool requeue = true) :
-        BasicFrame(channel, 9), // 8 for uint64_t, 1 for bool
+        Codec(channel),
         _deliveryTag(deliveryTag),
         _requeue(requeue)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
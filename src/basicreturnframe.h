@@ -12,7 +12,7 @@ namespace AMQP{
 /**
  *  Class implementation
  */
-class BasicReturnFrame : public BasicFrame {
+class BasicReturnFrame : public MethodCodec<BasicReturnFrame, BasicFrame> {
 private:
     /**
      *  reply code
@@ -22,40 +22,39 @@ private:
 
     /**
      *  reply text
-     *  @var ShortString
+     *  @var ShortStringView
      */
-    ShortString _replyText;
+    ShortStringView _replyText;
 
     /**
      *  the name of the exchange to publish to. An empty exchange name means the default exchange.
-     *  @var ShortString
+     *  @var ShortStringView
      */
-    ShortString _exchange;
+    ShortStringView _exchange;
 
     /**
      *  Message routing key
-     *  @var ShortString
+     *  @var ShortStringView
      */
-    ShortString _routingKey;
+    ShortStringView _routingKey;
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param   buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        BasicFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_replyCode);
-        _replyText.fill(buffer);
-        _exchange.fill(buffer);
-        _routingKey.fill(buffer);
+        visitor(self._replyCode, self._replyText, self._exchange, self._routingKey);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a basic return frame
@@ -67,12 +66,15 @@ public:
      *  @param  routingKey      message routing key
      */
     BasicReturnFrame(uint16_t channel, int16_t replyCode, const std::string& replyText = "", const std::string& exchange = "", const std::string& routingKey = "") :
-        BasicFrame(channel, (uint32_t)(replyText.length() + exchange.length() + routingKey.length() + 5)), // 3 for each string (extra size byte), 2 for uint16_t
+        Codec(channel),
         _replyCode(replyCode),
         _replyText(replyText),
         _exchange(exchange),
         _routingKey(routingKey)
-    {}   
+    {
+        // calculate the size
+        measure();
+    }   
 
     /**
      *  Construct a basic return frame from a received frame
@@ -80,12 +82,11 @@ public:
      *  @param  received frame
      */ 
     BasicReturnFrame(ReceivedFrame &frame) :
-        BasicFrame(frame),
-        _replyCode(frame.nextInt16()),
-        _replyText(frame),
-        _exchange(frame),
-        _routingKey(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -105,18 +106,18 @@ public:
 
     /**
      *  Return the name of the exchange to publish to
-     *  @return  string
+     *  @return  StringView
      */
-    const std::string& exchange() const
+    const StringView &exchange() const
     {
         return _exchange;
     }
 
     /**
      *  Return the routing key
-     *  @return  string
+     *  @return  StringView
      */
-    const std::string& routingKey() const
+    const StringView &routingKey() const
     {
         return _routingKey;
     }
@@ -132,9 +133,9 @@ public:
 
     /**
      *  Return the reply text
-     *  @return  string
+     *  @return  StringView
      */
-    const std::string& replyText() const
+    const StringView &replyText() const
     {
         return _replyText;
     }
@@ -167,6 +168,9 @@ public:
         // if there is no deferred publisher, we can just as well stop
         if (publisher == nullptr) return false;
         
+        // update the statistics
+        channel->reportReturned();
+
         // initialize the object, because we're about to receive a message
         publisher->process(*this);
         
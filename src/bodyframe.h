@@ -96,6 +96,16 @@ public:
         return _payload;
     }
 
+    /**
+     *  Content frames follow a publish frame that was already sent, so they
+     *  are also sent when the connection is being closed
+     *  @return bool
+     */
+    virtual bool partOfShutdown() const override
+    {
+        return true;
+    }
+
     /**
      *  Process the frame
      *  @param  connection      The connection over which it was received
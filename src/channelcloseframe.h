@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ChannelCloseFrame : public ChannelFrame
+class ChannelCloseFrame : public MethodCodec<ChannelCloseFrame, ChannelFrame>
 {
 private:
     /**
@@ -43,21 +43,20 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ChannelFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_code);
-        _text.fill(buffer);
-        buffer.add(_failingClass);
-        buffer.add(_failingMethod);
+        visitor(self._code, self._text, self._failingClass, self._failingMethod);
     }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
 public:
     /**
      *  Construct a channel close frame
@@ -65,12 +64,11 @@ public:
      *  @param  frame   received frame
      */
     ChannelCloseFrame(ReceivedFrame &frame) :
-        ChannelFrame(frame),
-        _code(frame.nextInt16()),
-        _text(frame),
-        _failingClass(frame.nextInt16()),
-        _failingMethod(frame.nextInt16())
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
     
     /**
      *  Construct a channel close frame
@@ -82,12 +80,15 @@ public:
      *  @param  failingMethod   failing method id if applicable
      */
     ChannelCloseFrame(uint16_t channel, uint16_t code = 0, std::string text = "", uint16_t failingClass = 0, uint16_t failingMethod = 0) :
-        ChannelFrame(channel, (uint32_t)(text.length() + 7)), // sizeof code, failingclass, failingmethod (2byte + 2byte + 2byte) + text length + text length byte
+        Codec(channel),
         _code(code),
         _text(std::move(text)),
         _failingClass(failingClass),
         _failingMethod(failingMethod)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
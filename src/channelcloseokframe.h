@@ -12,27 +12,32 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ChannelCloseOKFrame : public ChannelFrame
+class ChannelCloseOKFrame : public MethodCodec<ChannelCloseOKFrame, ChannelFrame>
 {
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ChannelFrame::fill(buffer);
+        visitor();
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a channel close ok  frame
      *  @param  frame
      */
     ChannelCloseOKFrame(ReceivedFrame &frame) :
-        ChannelFrame(frame)
+        Codec(frame)
     {}
 
     /**
@@ -41,8 +46,11 @@ public:
      *  @param  channel     channel we're working on
      */
     ChannelCloseOKFrame(uint16_t channel) :
-        ChannelFrame(channel, 0)
-    {}
+        Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
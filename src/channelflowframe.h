@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ChannelFlowFrame : public ChannelFrame
+class ChannelFlowFrame : public MethodCodec<ChannelFlowFrame, ChannelFrame>
 {
 private:
     /**
@@ -23,19 +23,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ChannelFrame::fill(buffer);
-
-        // add fields
-        _active.fill(buffer);
+        visitor(self._active);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a channel flow frame
@@ -43,9 +45,11 @@ public:
      *  @param  frame   received frame
      */
     ChannelFlowFrame(ReceivedFrame &frame) :    
-        ChannelFrame(frame),
-        _active(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Construct a channel flow frame
@@ -54,9 +58,12 @@ public:
      *  @param  active      enable or disable channel flow
      */
     ChannelFlowFrame(uint16_t channel, bool active) : 
-        ChannelFrame(channel, 1), //sizeof bool
+        Codec(channel),
         _active(active)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
@@ -80,6 +87,29 @@ public:
     {
         return _active.get(0);
     }
+
+    /**
+     *  Process the frame (the server asks us to stop or start sending messages)
+     *  @param  connection      The connection over which it was received
+     *  @return bool            Was it succesfully processed?
+     */
+    virtual bool process(ConnectionImpl *connection) override
+    {
+        // we need the appropriate channel
+        auto channel = connection->channel(this->channel());
+
+        // channel does not exist
+        if (!channel) return false;
+
+        // tell the server that we got the message
+        connection->send(ChannelFlowOKFrame(this->channel(), active()));
+
+        // report to the channel
+        channel->reportFlow(active());
+
+        // done
+        return true;
+    }
 };
 
 /**
@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ChannelFlowOKFrame : public ChannelFrame
+class ChannelFlowOKFrame : public MethodCodec<ChannelFlowOKFrame, ChannelFrame>
 {
 private:
     /**
@@ -23,18 +23,20 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ChannelFrame::fill(buffer);
-
-        // add fields
-        _active.fill(buffer);
+        visitor(self._active);
     }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
 public:
     /**
      *  Construct a channel flow frame
@@ -42,9 +44,11 @@ public:
      *  @param  frame   received frame to decode
      */
     ChannelFlowOKFrame(ReceivedFrame &frame) :
-        ChannelFrame(frame),
-        _active(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Construct a channel flow frame
@@ -53,9 +57,12 @@ public:
      *  @param  active  enable or disable channel flow
      */
     ChannelFlowOKFrame(uint16_t channel, bool active) :
-        ChannelFrame(channel, 1), //sizeof bool
+        Codec(channel),
         _active(active)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
@@ -11,6 +11,7 @@
 #include "consumedmessage.h"
 #include "returnedmessage.h"
 #include "channelopenframe.h"
+#include "channelflowokframe.h"
 #include "channelflowframe.h"
 #include "channelcloseokframe.h"
 #include "channelcloseframe.h"
@@ -38,6 +39,8 @@
 #include "basicrecoverframe.h"
 #include "basicrejectframe.h"
 #include "basicgetframe.h"
+#include "topology.h"
+#include "publishstream.h"
 
 /**
  *  Set up namespace
@@ -54,10 +57,49 @@ ChannelImpl::ChannelImpl() = default;
  */
 ChannelImpl::~ChannelImpl()
 {
+    // frames that were still queued are never going to be sent
+    if (!_queue.empty()) measure([this](Stats &stats) { stats._channelQueue.decrement(_queue.size()); });
+
     // remove this channel from the connection (but not if the connection is already destructed)
     if (_connection) _connection->remove(this);
 }
 
+/**
+ *  Are statistics collected for this channel or its connection?
+ *  @return bool
+ */
+bool ChannelImpl::measuring() const
+{
+    return _stats || (_connection && _connection->_stats);
+}
+
+/**
+ *  Update the statistics of the channel and its connection
+ *  @param  function        function that updates a stats object
+ */
+template <typename Function>
+void ChannelImpl::measure(const Function &function)
+{
+    // update the stats of the channel
+    if (_stats) function(*_stats);
+
+    // and of the connection
+    if (_connection && _connection->_stats) function(*_connection->_stats);
+}
+
+/**
+ *  Start (or stop) collecting statistics
+ *  @param  stats
+ */
+void ChannelImpl::stats(const std::shared_ptr<Stats> &stats)
+{
+    // store the object
+    _stats = stats;
+
+    // the connection has to count the incoming frames for us
+    if (_stats && _connection) _connection->_channelStats = true;
+}
+
 /**
  *  Callback that is called when an error occurs.
  *
@@ -80,6 +122,9 @@ void ChannelImpl::onError(const ErrorCallback &callback)
     // is the channel closing down?
     if (_state == state_closing) return callback("Channel is closing down");
 
+    // a channel that waits for the connection to be recovered is not in an error state
+    if (_state == state_recovering) return;
+
     // the channel is closed, but what is the connection doing?
     if (_connection == nullptr) return callback("Channel is not linked to a connection");
     
@@ -122,6 +167,9 @@ bool ChannelImpl::attach(Connection *connection)
     {
         // assume channel is connected
         _state = state_connected;
+        
+        // if the connection can be recovered, we keep track of everything that is declared
+        if (_connection->recoverable()) _topology.reset(new Topology());
     
         // send the open frame
         if (send(ChannelOpenFrame(_id))) return true;
@@ -205,6 +253,9 @@ DeferredConfirm &ChannelImpl::confirmSelect()
     // send the frame, and create deferred object
     _confirm = std::make_shared<DeferredConfirm>(!send(frame));
 
+    // remember the setting, so that it is restored after recovery
+    if (_topology) _topology->confirm = true;
+
     // push to list
     push(_confirm);
 
@@ -256,6 +307,9 @@ Deferred &ChannelImpl::rollbackTransaction()
  */
 Deferred &ChannelImpl::close()
 {
+    // a channel that is waiting for the connection to be recovered no longer has to be recovered
+    if (_state == state_recovering) return forget();
+
     // this is completely pointless if already closed
     if (!usable()) return push(std::make_shared<Deferred>(_state == state_closing));
     
@@ -299,6 +353,9 @@ Deferred &ChannelImpl::declareExchange(const std::string &name, ExchangeType typ
     bool internal = (flags & AMQP::internal) != 0;
     bool nowait = (flags & AMQP::nowait) != 0;
 
+    // remember the exchange, so that it is declared again after recovery
+    if (_topology) _topology->declareExchange(name, type, flags, arguments);
+
     // send declare exchange frame
     return push(ExchangeDeclareFrame(_id, name, exchangeType, passive, durable, autodelete, internal, nowait, arguments));
 }
@@ -316,6 +373,9 @@ Deferred &ChannelImpl::declareExchange(const std::string &name, ExchangeType typ
  */
 Deferred &ChannelImpl::bindExchange(const std::string &source, const std::string &target, const std::string &routingkey, const Table &arguments)
 {
+    // remember the binding, so that it is restored after recovery
+    if (_topology) Topology::bind(_topology->exchangeBindings, source, target, routingkey, arguments);
+
     // send exchange bind frame
     return push(ExchangeBindFrame(_id, target, source, routingkey, false, arguments));
 }
@@ -333,6 +393,9 @@ Deferred &ChannelImpl::bindExchange(const std::string &source, const std::string
  */
 Deferred &ChannelImpl::unbindExchange(const std::string &source, const std::string &target, const std::string &routingkey, const Table &arguments)
 {
+    // the binding no longer has to be restored after recovery
+    if (_topology) Topology::unbind(_topology->exchangeBindings, source, target, routingkey);
+
     // send exchange unbind frame
     return push(ExchangeUnbindFrame(_id, target, source, routingkey, false, arguments));
 }
@@ -348,6 +411,9 @@ Deferred &ChannelImpl::unbindExchange(const std::string &source, const std::stri
  */
 Deferred &ChannelImpl::removeExchange(const std::string &name, int flags)
 {
+    // the exchange no longer has to be declared after recovery
+    if (_topology) _topology->removeExchange(name);
+
     // send delete exchange frame
     return push(ExchangeDeleteFrame(_id, name, (flags & ifunused) != 0, false));
 }
@@ -366,6 +432,9 @@ DeferredQueue &ChannelImpl::declareQueue(const std::string &name, int flags, con
     // the frame to send
     QueueDeclareFrame frame(_id, name, (flags & passive) != 0, (flags & durable) != 0, (flags & exclusive) != 0, (flags & autodelete) != 0, false, arguments);
 
+    // remember the queue, so that it is declared again after recovery
+    if (_topology) _topology->declareQueue(name, flags, arguments);
+
     // send the queuedeclareframe
     auto result = std::make_shared<DeferredQueue>(!send(frame));
 
@@ -389,6 +458,9 @@ DeferredQueue &ChannelImpl::declareQueue(const std::string &name, int flags, con
  */
 Deferred &ChannelImpl::bindQueue(const std::string &exchangeName, const std::string &queueName, const std::string &routingkey, const Table &arguments)
 {
+    // remember the binding, so that it is restored after recovery
+    if (_topology) Topology::bind(_topology->queueBindings, exchangeName, queueName, routingkey, arguments);
+
     // send the bind queue frame
     return push(QueueBindFrame(_id, queueName, exchangeName, routingkey, false, arguments));
 }
@@ -406,6 +478,9 @@ Deferred &ChannelImpl::bindQueue(const std::string &exchangeName, const std::str
  */
 Deferred &ChannelImpl::unbindQueue(const std::string &exchange, const std::string &queue, const std::string &routingkey, const Table &arguments)
 {
+    // the binding no longer has to be restored after recovery
+    if (_topology) Topology::unbind(_topology->queueBindings, exchange, queue, routingkey);
+
     // send the unbind queue frame
     return push(QueueUnbindFrame(_id, queue, exchange, routingkey, arguments));
 }
@@ -465,6 +540,9 @@ DeferredDelete &ChannelImpl::removeQueue(const std::string &name, int flags)
     // the frame to send
     QueueDeleteFrame frame(_id, name, (flags & ifunused) != 0, (flags & ifempty) != 0, false);
 
+    // the queue no longer has to be declared after recovery
+    if (_topology) _topology->removeQueue(name);
+
     // send the frame, and create deferred object
     auto deferred = std::make_shared<DeferredDelete>(!send(frame));
 
@@ -497,9 +575,15 @@ DeferredPublisher &ChannelImpl::publish(const std::string &exchange, const std::
     // make sure we have a deferred object to return
     if (!_publisher) _publisher.reset(new DeferredPublisher(this));
 
+    // trace the start of the operation
+    AMQP_CPP_TRACE(publish, _id, envelope.bodySize());
+
     // send the publish frame
     if (!send(BasicPublishFrame(_id, exchange, routingKey, (flags & mandatory) != 0, (flags & immediate) != 0))) return *_publisher;
 
+    // count the message
+    count();
+
     // channel still valid?
     if (!monitor.valid()) return *_publisher;
 
@@ -538,6 +622,62 @@ DeferredPublisher &ChannelImpl::publish(const std::string &exchange, const std::
     return *_publisher;
 }
 
+/**
+ *  Publish a message of which the body is produced while it is being sent.
+ *  The producer is called every time that the connection has room for the
+ *  next body frame, and writes the next part of the body into a buffer of the
+ *  stream, from which it is copied into the body frame.
+ *
+ *  @param  exchange    the exchange to publish to
+ *  @param  routingkey  the routing key
+ *  @param  metadata    the properties of the message
+ *  @param  size        size of the body
+ *  @param  producer    callback that produces the body
+ *  @param  flags       optional flags
+ */
+DeferredPublisher &ChannelImpl::publish(const std::string &exchange, const std::string &routingKey, const MetaData &metadata, uint64_t size, const ProduceCallback &producer, int flags)
+{
+    // the frames that are sent could destruct the channel
+    Monitor monitor(this);
+
+    // make sure we have a deferred object to return
+    if (!_publisher) _publisher.reset(new DeferredPublisher(this));
+
+    // trace the start of the operation
+    AMQP_CPP_TRACE(publish, _id, size);
+
+    // the header and body frames follow the publish frame
+    auto stream = std::make_shared<PublishStream>(metadata, size, producer);
+
+    // send the publish frame
+    if (!send(BasicPublishFrame(_id, exchange, routingKey, (flags & mandatory) != 0, (flags & immediate) != 0), stream)) return *_publisher;
+
+    // count the message (if the channel still exists)
+    if (monitor.valid()) count();
+
+    // done
+    return *_publisher;
+}
+
+/**
+ *  Count a message that was published
+ */
+void ChannelImpl::count()
+{
+    // count the message
+    measure([](Stats &stats) { stats._published.add(); });
+
+    // in confirm mode the server numbers the published messages
+    if (!_confirm) return;
+
+    // update the counters
+    _published++;
+    _sequence++;
+
+    // remember when it was published, to measure the confirm latency
+    if (measuring()) _unconfirmed.emplace_back(_sequence, std::chrono::steady_clock::now());
+}
+
 /**
  *  Set the Quality of Service (QOS) for this channel
  *  @param  prefetchCount       maximum number of messages to prefetch
@@ -550,6 +690,9 @@ DeferredPublisher &ChannelImpl::publish(const std::string &exchange, const std::
  */
 Deferred &ChannelImpl::setQos(uint16_t prefetchCount, bool global)
 {
+    // remember the setting, so that it is restored after recovery
+    if (_topology) (global ? _topology->globalPrefetch : _topology->prefetch) = prefetchCount;
+
     // send a qos frame
     return push(BasicQosFrame(_id, prefetchCount, global));
 }
@@ -582,6 +725,9 @@ DeferredConsumer& ChannelImpl::consume(const std::string &queue, const std::stri
     // send the frame, and create deferred object
     auto deferred = std::make_shared<DeferredConsumer>(this, !send(frame));
 
+    // remember the consumer, so that it is restarted after recovery
+    if (_topology) _topology->consume(queue, tag, flags, arguments, deferred);
+
     // push to list
     push(deferred);
 
@@ -611,6 +757,9 @@ DeferredCancel &ChannelImpl::cancel(const std::string &tag)
     // the cancel frame to send
     BasicCancelFrame frame(_id, tag, false);
 
+    // the consumer no longer has to be restarted after recovery
+    if (_topology) _topology->cancel(tag, consumer(tag));
+
     // send the frame, and create deferred object
     auto deferred = std::make_shared<DeferredCancel>(this, !send(frame));
 
@@ -676,8 +825,17 @@ DeferredGet &ChannelImpl::get(const std::string &queue, int flags)
  */
 bool ChannelImpl::ack(uint64_t deliveryTag, int flags)
 {
+    // tag zero with the multiple flag means: all outstanding messages (also after a recovery)
+    bool all = deliveryTag == 0 && (flags & multiple);
+
+    // messages that were delivered before the connection was recovered can not be acked
+    if (!all && deliveryTag <= _offset) return false;
+
+    // count the ack
+    measure([](Stats &stats) { stats._acked.add(); });
+
     // send an ack frame
-    return send(BasicAckFrame(_id, deliveryTag, (flags & multiple) != 0));
+    return send(BasicAckFrame(_id, all ? 0 : deliveryTag - _offset, (flags & multiple) != 0));
 }
 
 /**
@@ -688,6 +846,18 @@ bool ChannelImpl::ack(uint64_t deliveryTag, int flags)
  */
 bool ChannelImpl::reject(uint64_t deliveryTag, int flags)
 {
+    // tag zero with the multiple flag means: all outstanding messages (also after a recovery)
+    bool all = deliveryTag == 0 && (flags & multiple);
+
+    // messages that were delivered before the connection was recovered can not be rejected
+    if (!all && deliveryTag <= _offset) return false;
+
+    // the delivery tag as known by the server
+    if (!all) deliveryTag -= _offset;
+
+    // count the rejection
+    measure([](Stats &stats) { stats._rejected.add(); });
+
     // should we reject multiple messages?
     if (flags & multiple)
     {
@@ -717,9 +887,10 @@ Deferred &ChannelImpl::recover(int flags)
 /**
  *  Send a frame over the channel
  *  @param  frame       frame to send
+ *  @param  stream      body that follows the frame (only for publish frames)
  *  @return bool        was the frame sent?
  */
-bool ChannelImpl::send(const Frame &frame)
+bool ChannelImpl::send(const Frame &frame, const std::shared_ptr<PublishStream> &stream)
 {
     // skip if channel is not connected
     if (_state == state_closed || !_connection) return false;
@@ -730,13 +901,26 @@ bool ChannelImpl::send(const Frame &frame)
     // the error when the close operation succeeds
     if (_state == state_closing) return true;
     
-    // are we currently in synchronous mode or are there
-    // other frames waiting for their turn to be sent?
-    if (_synchronous || !_queue.empty())
+    // is the frame going to be sent in pipelined mode?
+    bool pipelined = _pipelining && frame.pipelinable();
+
+    // are we currently in synchronous mode, are there other frames waiting for
+    // their turn to be sent, are we busy sending the body of a message, is this
+    // a synchronous frame that has to wait for the answers to the frames that were
+    // pipelined before it, or a message that is held back because the server
+    // has blocked the connection?
+    if (_synchronous || !_queue.empty() || _stream || (_pipelined > 0 && frame.synchronous() && !pipelined) || (frame.blockable() && _connection->holding()))
     {
         // we need to wait until the synchronous frame has
         // been processed, so queue the frame until it was
-        _queue.emplace(frame.synchronous(), frame);
+        _queue.emplace(frame, pipelined, stream);
+        _queuedBytes += _queue.back().buffer.size();
+
+        // one frame more in the queue
+        measure([](Stats &stats) { stats._channelQueue.increment(); });
+
+        // the queue may have grown over the high watermark
+        checkBackpressure();
 
         // it was of course not actually sent but we pretend
         // that it was, because no error occured
@@ -744,62 +928,293 @@ bool ChannelImpl::send(const Frame &frame)
     }
 
     // send to tcp connection
-    if (!_connection->send(frame)) return false;
+    if (!transmit(frame)) return false;
+
+    // remember when a synchronous operation started
+    if (frame.synchronous() && measuring()) _operations.push(std::chrono::steady_clock::now());
     
     // frame was sent, if this was a synchronous frame, we now have to wait
-    _synchronous = frame.synchronous();
+    // (unless it was pipelined, then we just count the answers that we expect)
+    if (pipelined && frame.synchronous()) _pipelined += 1;
+    else _synchronous = frame.synchronous();
+
+    // the header and body frames of a published message follow the publish frame
+    if (stream) start(stream);
     
     // done
     return true;
 }
 
+/**
+ *  Pass a frame to the connection, without checking the queue
+ *  @param  frame       frame to send
+ *  @return bool        was the frame sent?
+ */
+bool ChannelImpl::transmit(const Frame &frame)
+{
+    // send to tcp connection
+    if (!_connection->send(frame)) return false;
+
+    // count the frame (the connection counts it for itself)
+    if (_stats) _stats->sent(frame.type(), frame.totalSize());
+
+    // done
+    return true;
+}
+
+/**
+ *  Start sending the header and body frames of a message that is published
+ *  from a producer, the publish frame has just been sent
+ *  @param  stream      the message
+ */
+void ChannelImpl::start(const std::shared_ptr<PublishStream> &stream)
+{
+    // all other frames have to wait until the body is complete
+    _stream = stream;
+
+    // sending the header could destruct the channel
+    Monitor monitor(this);
+
+    // send the header frame
+    if (!transmit(BasicHeaderFrame(_id, stream->envelope()))) return abandon();
+
+    // leap out if the channel no longer exists
+    if (!monitor.valid() || _stream != stream) return;
+
+    // a message without a body is already complete
+    if (stream->left() == 0) return complete();
+
+    // the connection is going to ask us for the body frames
+    _connection->producing();
+}
+
+/**
+ *  Produce the next body frame of the message that is published from a producer
+ *  @return size_t      number of bytes sent
+ */
+size_t ChannelImpl::produce()
+{
+    // keep the message alive while the producer is called
+    auto stream = _stream;
+
+    // leap out if there is nothing to produce
+    if (!stream || !_connection) return 0;
+
+    // the producer could destruct the channel
+    Monitor monitor(this);
+
+    // let the producer write the next part of the body
+    size_t size = stream->produce(_connection->maxPayload());
+
+    // leap out if the channel no longer exists, or if the message was dropped in the meantime
+    if (!monitor.valid() || _stream != stream) return 0;
+
+    // if nothing was produced, or if the frame can not be sent, the body can not be completed
+    if (size == 0 || !transmit(BodyFrame(_id, stream->data(), (uint32_t)size)))
+    {
+        // give up on the message (if the channel still exists)
+        if (monitor.valid()) abandon();
+
+        // nothing was sent
+        return 0;
+    }
+
+    // leap out if the channel no longer exists
+    if (!monitor.valid()) return size;
+
+    // was this the last part of the body?
+    if (stream->left() == 0 && _stream == stream) complete();
+
+    // done (the frame also has a header and a trailer)
+    return size + 8;
+}
+
+/**
+ *  The body of the message that was published from a producer is complete,
+ *  the frames that were waiting for it can now be sent
+ */
+void ChannelImpl::complete()
+{
+    // the message is done
+    _stream.reset();
+
+    // send the frames that were waiting
+    dequeue();
+}
+
+/**
+ *  Give up on the message that is published from a producer, because its body
+ *  can not be completed. The server is still expecting the rest of the body,
+ *  so the only way out is to close the channel.
+ */
+void ChannelImpl::abandon()
+{
+    // the message is never going to be complete
+    _stream.reset();
+
+    // the channel could be destructed
+    Monitor monitor(this);
+
+    // tell the server that the channel is closed (this fails if the connection is already gone)
+    if (_connection) transmit(ChannelCloseFrame(_id, 0, "message body could not be produced"));
+
+    // leap out if the channel no longer exists
+    if (!monitor.valid()) return;
+
+    // report the error to user space
+    reportError("message body could not be produced");
+}
+
 /**
  *  Signal the channel that a synchronous operation was completed. After 
  *  this operation, waiting frames can be sent out.
  */
 void ChannelImpl::flush()
 {
-    // we are no longer waiting for synchronous operations
-    _synchronous = false;
+    // if frames were pipelined, the answer belongs to the oldest of them (a regular 
+    // synchronous frame is never sent while pipelined frames are waiting for their answer)
+    if (_pipelined > 0) _pipelined -= 1;
+    
+    // otherwise we are no longer waiting for synchronous operations
+    else _synchronous = false;
+
+    // the oldest synchronous operation is done
+    if (!_operations.empty())
+    {
+        // the duration of the operation
+        auto duration = std::chrono::steady_clock::now() - _operations.front();
+
+        // record it
+        measure([duration](Stats &stats) { stats._operationLatency.add(duration); });
+
+        // on to the next one
+        _operations.pop();
+    }
 
+    // send the frames that were waiting
+    dequeue();
+}
+
+/**
+ *  Send out the frames that are queued, until we have to wait again for
+ *  the answer to a synchronous frame, or for the body of a message
+ */
+void ChannelImpl::dequeue()
+{
     // we need to monitor the channel for validity
     Monitor monitor(this);
 
-    // send all frames while not in synchronous mode
-    while (_connection && !_synchronous && !_queue.empty())
+    // send all frames while not in synchronous mode (or busy with the body of a message)
+    while (_connection && !_synchronous && !_stream && !_queue.empty())
     {
         // retrieve the first buffer and synchronous
-        auto &pair = _queue.front();
+        auto &queued = _queue.front();
 
-        // mark as synchronous if necessary
-        _synchronous = pair.first;
+        // a regular synchronous frame waits for the pipelined frames to be answered
+        if (queued.synchronous && !queued.pipelined && _pipelined > 0) break;
+
+        // a published message waits until the server no longer blocks the connection
+        if (queued.blockable && _connection->holding()) break;
+
+        // mark as synchronous if necessary (or count the answers that we expect)
+        if (queued.synchronous && queued.pipelined) _pipelined += 1;
+        else _synchronous = queued.synchronous;
+
+        // update the statistics before the buffer is moved away
+        if (measuring())
+        {
+            // count the frame (the connection counts it for itself)
+            if (_stats) _stats->sent(queued.buffer.data()[0], queued.buffer.size());
+
+            // one frame less in the queue
+            measure([](Stats &stats) { stats._channelQueue.decrement(); });
+
+            // remember when a synchronous operation started
+            if (queued.synchronous) _operations.push(std::chrono::steady_clock::now());
+        }
+
+        // the frame leaves the queue
+        _queuedBytes -= queued.buffer.size();
 
         // send it over the connection
-        _connection->send(std::move(pair.second));
+        _connection->send(std::move(queued.buffer));
 
         // the user space handler may have destructed this channel object
         if (!monitor.valid()) return;
 
+        // the body of a published message may follow the frame
+        auto stream = std::move(queued.stream);
+
         // remove from the list
         _queue.pop();
+
+        // start sending the header and body frames
+        if (stream) start(stream);
+
+        // the channel could have been destructed
+        if (!monitor.valid()) return;
     }
+
+    // the queue may have drained to the low watermark
+    checkBackpressure();
 }
 
 /**
- *  Report an error message on a channel
- *  @param  message             the error message
- *  @param  notifyhandler       should the channel-wide handler also be called?
+ *  Tell user space when backpressure starts or ends
  */
-void ChannelImpl::reportError(const char *message, bool notifyhandler)
+void ChannelImpl::checkBackpressure()
 {
-    // change state
-    _state = state_closed;
-    _synchronous = false;
-    
-    // the queue of messages that still have to sent can be emptied now
-    // (we do this by moving the current queue into an unused variable)
-    auto queue(std::move(_queue));
+    // the queue is congested from the high watermark until it is back at the low watermark
+    _congested = _highWatermark > 0 && (_congested ? _queuedBytes > _lowWatermark : _queuedBytes >= _highWatermark);
+
+    // the server can also ask us to stop
+    bool active = _congested || _flowStopped;
+
+    // leap out if nothing changed
+    if (active == _backpressure) return;
+
+    // remember the new situation
+    _backpressure = active;
+
+    // tell user space
+    if (_backpressureCallback) _backpressureCallback(active);
+}
+
+/**
+ *  Set the watermarks for the queue of the channel
+ *  @param  high        number of bytes at which backpressure starts (0 to disable)
+ *  @param  low         number of bytes at which it ends
+ */
+void ChannelImpl::watermarks(size_t high, size_t low)
+{
+    // store the watermarks (the low one can not be above the high one)
+    _highWatermark = high;
+    _lowWatermark = std::min(low, high);
+
+    // the queue may already be over (or under) them
+    checkBackpressure();
+}
 
+/**
+ *  Report that the server asked to stop (or start again) sending messages
+ *  @param  active          may messages be sent?
+ */
+void ChannelImpl::reportFlow(bool active)
+{
+    // remember what the server wants
+    _flowStopped = !active;
+
+    // tell user space
+    checkBackpressure();
+}
+
+/**
+ *  Report an error to all deferred objects that are waiting for an answer
+ *  @param  message             the error message
+ *  @return bool                is the channel still valid?
+ */
+bool ChannelImpl::fail(const char *message)
+{
     // we are going to call callbacks that could destruct the channel
     Monitor monitor(this);
 
@@ -814,7 +1229,7 @@ void ChannelImpl::reportError(const char *message, bool notifyhandler)
         auto next = cb->reportError(message);
 
         // leap out if channel no longer exists
-        if (!monitor.valid()) return;
+        if (!monitor.valid()) return false;
 
         // in case the callback-shared-pointer is still kept in scope (for example because it
         // is stored in the list of consumers), we do want to ensure that it no longer maintains
@@ -836,7 +1251,7 @@ void ChannelImpl::reportError(const char *message, bool notifyhandler)
         auto next = cb->reportError("Channel is in error state");
 
         // leap out if channel no longer exists
-        if (!monitor.valid()) return;
+        if (!monitor.valid()) return false;
 
         // in case the callback-shared-pointer is still kept in scope (for example because it
         // is stored in the list of consumers), we do want to ensure that it no longer maintains
@@ -850,6 +1265,37 @@ void ChannelImpl::reportError(const char *message, bool notifyhandler)
     // all callbacks have been processed, so we also can reset the pointer to the newest
     _newestCallback = nullptr;
 
+    // the channel still exists
+    return true;
+}
+
+/**
+ *  Report an error message on a channel
+ *  @param  message             the error message
+ *  @param  notifyhandler       should the channel-wide handler also be called?
+ */
+void ChannelImpl::reportError(const char *message, bool notifyhandler)
+{
+    // change state
+    _state = state_closed;
+    _synchronous = false;
+    _pipelined = 0;
+    _stream.reset();
+    
+    // the queue of messages that still have to sent can be emptied now
+    // (we do this by moving the current queue into an unused variable)
+    auto queue(std::move(_queue));
+    _queuedBytes = 0;
+
+    // the operations and messages that were in progress are not going to be answered
+    discard(queue.size());
+
+    // we are going to call callbacks that could destruct the channel
+    Monitor monitor(this);
+
+    // report the error to all pending operations
+    if (!fail(message)) return;
+
     // inform handler
     if (notifyhandler && _errorCallback) _errorCallback(message);
 
@@ -872,13 +1318,353 @@ void ChannelImpl::reportError(const char *message, bool notifyhandler)
     _connection = nullptr;
 }
 
+/**
+ *  Forget about a channel that was waiting for the connection to be recovered
+ *  @return Deferred
+ */
+Deferred &ChannelImpl::forget()
+{
+    // the channel is closed, and there is no need to remember its topology
+    _state = state_closed;
+    _topology.reset();
+
+    // the connection no longer has to recover the channel (we need an extra 
+    // reference, because the connection could hold the last one)
+    auto self = shared_from_this();
+    if (_connection) _connection->remove(this);
+    _connection = nullptr;
+
+    // there is no closing handshake, so the close operation can not report success
+    return push(std::make_shared<Deferred>(true));
+}
+
+/**
+ *  Suspend the channel because the connection was lost, the channel is kept 
+ *  so that it can be re-opened when the connection is recovered
+ *  @param  message             the error message for operations that were in progress
+ */
+void ChannelImpl::suspend(const char *message)
+{
+    // the channel is waiting for the connection to come back (a message
+    // that was being published from a producer can not be completed)
+    _state = state_recovering;
+    _synchronous = false;
+    _pipelined = 0;
+    _stream.reset();
+
+    // frames that were not yet sent are discarded, and so is a message that
+    // was being received (the server is going to deliver it again)
+    auto queue(std::move(_queue));
+    _queuedBytes = 0;
+    _receiver = nullptr;
+
+    // a recovered channel starts with the flow of messages active
+    _flowStopped = false;
+
+    // the operations and messages that were in progress are not going to be answered
+    discard(queue.size());
+
+    // the server starts numbering the published messages at one again
+    _sequence = 0;
+
+    // consumers that were not yet started are reported as failed, we do not restart 
+    // them because user space could just as well do that itself after the error
+    if (_topology) _topology->consumers.remove_if([this](const Topology::Consumer &consumer) {
+        
+        // look for the consumer in the list of active consumers
+        for (auto &iter : _consumers) if (iter.second == consumer.deferred) return false;
+        
+        // the consumer was not yet active
+        return true;
+    });
+
+    // the consumer tags are no longer in use
+    _consumers.clear();
+
+    // the queues that are still being declared are not going to get an answer
+    if (_topology) _topology->declaring.clear();
+
+    // delivery tags will start at one again on the recovered connection
+    _offset = _delivered;
+
+    // we are going to call callbacks that could destruct the channel
+    Monitor monitor(this);
+
+    // the frames that were discarded no longer hold back user space
+    checkBackpressure();
+
+    // leap out if the channel no longer exists
+    if (!monitor.valid()) return;
+
+    // messages that were not yet confirmed are never going to be confirmed
+    if (_confirm)
+    {
+        // keep the object in scope during the callback
+        auto confirm = _confirm;
+
+        // report the unconfirmed messages as failed
+        confirm->reset(_published);
+
+        // leap out if the channel no longer exists
+        if (!monitor.valid()) return;
+    }
+
+    // report the error to all operations that were in progress
+    fail(message);
+}
+
+/**
+ *  Re-open the channel after the connection was recovered, and re-declare 
+ *  everything that was declared before
+ */
+void ChannelImpl::recover()
+{
+    // only channels that were suspended can be recovered
+    if (_state != state_recovering || !_connection) return;
+
+    // we are going to re-open the channel, but user space does not have to be told about that
+    _state = state_connected;
+    _recovered = true;
+
+    // send the open frame
+    if (!send(ChannelOpenFrame(_id))) return reportError("Channel could not be re-opened");
+
+    // if nothing was recorded, we are done
+    if (!_topology) return;
+
+    // while we re-declare everything, we should not record it again
+    std::unique_ptr<Topology> topology(std::move(_topology));
+
+    // the topology was valid before, so it can be sent back-to-back
+    bool pipelining = _pipelining;
+    _pipelining = true;
+
+    // replay the recorded topology
+    replay(*topology);
+
+    // restore the original mode and the record
+    _pipelining = pipelining;
+    _topology = std::move(topology);
+}
+
+/**
+ *  Re-declare the recorded topology. All instructions are sent out in one go,
+ *  and the declarations and bindings are pipelined.
+ *  @param  topology            the recorded topology
+ */
+void ChannelImpl::replay(Topology &topology)
+{
+    // restore the channel settings
+    if (topology.prefetch > 0) setQos(topology.prefetch, false);
+    if (topology.globalPrefetch > 0) setQos(topology.globalPrefetch, true);
+
+    // restore confirm mode (we re-use the deferred object, so that the callbacks are preserved)
+    if (topology.confirm && _confirm) 
+    {
+        // the confirm frame is sent, and the original deferred object is pushed
+        _confirm->_failed = !send(ConfirmSelectFrame(_id));
+        push(_confirm);
+    }
+
+    // declare the exchanges
+    for (auto &exchange : topology.exchanges) declareExchange(exchange.name, exchange.type, exchange.flags, exchange.arguments);
+
+    // declare the queues (and we need the declare-ok frames to find out the names of server-named queues)
+    for (auto &queue : topology.queues) 
+    {
+        // declare the queue (server-named queues get a new name)
+        declareQueue(queue->generated ? std::string() : queue->name, queue->flags, queue->arguments);
+
+        // we need the answer to find out the new name
+        topology.declaring.push_back(queue);
+    }
+
+    // restore the bindings between exchanges
+    for (auto &binding : topology.exchangeBindings) bindExchange(binding.exchange, binding.target, binding.routingkey, binding.arguments);
+
+    // restore the bindings of queues (except for server-named queues that do not yet have their new name)
+    for (auto &binding : topology.queueBindings)
+    {
+        // bindings of server-named queues are restored when the new name is known
+        if (topology.generated(binding.target)) continue;
+
+        // restore the binding
+        bindQueue(binding.exchange, binding.target, binding.routingkey, binding.arguments);
+    }
+
+    // restart the consumers
+    for (auto &consumer : topology.consumers)
+    {
+        // consumers of server-named queues are restarted when the new name is known
+        if (topology.generated(consumer.queue)) continue;
+
+        // restart the consumer
+        restart(consumer.queue, consumer.tag, consumer.flags, consumer.arguments, consumer.deferred);
+    }
+}
+
+/**
+ *  Re-declare the bindings and consumers of a server-named queue that was 
+ *  just re-declared and that got a new name
+ *  @param  oldname             the name of the queue before the connection was lost
+ *  @param  newname             the name that was assigned by the server
+ */
+void ChannelImpl::replay(const std::string &oldname, const std::string &newname)
+{
+    // while we re-declare everything, we should not record it again
+    std::unique_ptr<Topology> topology(std::move(_topology));
+
+    // the bindings and consumers now refer to the new name
+    topology->renameQueue(oldname, newname);
+
+    // restore the bindings
+    for (auto &binding : topology->queueBindings)
+    {
+        // only the bindings of this queue
+        if (binding.target == newname) bindQueue(binding.exchange, binding.target, binding.routingkey, binding.arguments);
+    }
+
+    // restart the consumers
+    for (auto &consumer : topology->consumers)
+    {
+        // only the consumers of this queue
+        if (consumer.queue == newname) restart(consumer.queue, consumer.tag, consumer.flags, consumer.arguments, consumer.deferred);
+    }
+
+    // restore the record
+    _topology = std::move(topology);
+}
+
+/**
+ *  Restart a consumer after the connection was recovered
+ *  @param  queue               the queue to consume from
+ *  @param  tag                 the consumer tag that was originally requested
+ *  @param  flags               the original flags
+ *  @param  arguments           the original arguments
+ *  @param  deferred            the original deferred object
+ */
+void ChannelImpl::restart(const std::string &queue, const std::string &tag, int flags, const Table &arguments, const std::shared_ptr<DeferredConsumer> &deferred)
+{
+    // the frame to send
+    BasicConsumeFrame frame(_id, queue, tag, (flags & nolocal) != 0, (flags & noack) != 0, (flags & exclusive) != 0, false, arguments);
+
+    // we re-use the deferred object, so that the callbacks that were installed by user space are preserved
+    deferred->_failed = !send(frame);
+
+    // push to list
+    push(deferred);
+}
+
+/**
+ *  Report that a queue was declared
+ *  @param  name                name of the queue
+ */
+void ChannelImpl::reportDeclared(const std::string &name)
+{
+    // this only matters if we record the topology
+    if (!_topology || _topology->declaring.empty()) return;
+
+    // the queue for which the answer was received
+    auto queue = _topology->declaring.front();
+
+    // it no longer waits for the answer
+    _topology->declaring.pop_front();
+
+    // nothing changes for queues that were declared with a name
+    if (!queue->generated || queue->name == name) return;
+
+    // if this is the first time that the queue was declared, we now know the name
+    if (queue->name.empty()) queue->name = name;
+
+    // otherwise the queue was re-declared after recovery, and its bindings and consumers can now be restored
+    else replay(queue->name, name);
+}
+
+/**
+ *  Report that a publisher confirm (an ack or nack from the server) was received
+ *  @param  tag             the delivery tag from the server
+ *  @param  multiple        does it confirm all messages up to the tag?
+ *  @param  ack             was it an ack (or a nack)?
+ */
+void ChannelImpl::reportConfirm(uint64_t tag, bool multiple, bool ack)
+{
+    // nothing to do if no statistics are collected
+    if (!measuring()) return;
+
+    // count the confirm
+    measure([ack](Stats &stats) { (ack ? stats._confirmed : stats._nacked).add(); });
+
+    // the current time
+    auto now = std::chrono::steady_clock::now();
+
+    // look for the messages that are confirmed (they are usually at the front)
+    for (auto iter = _unconfirmed.begin(); iter != _unconfirmed.end() && iter->first <= tag; )
+    {
+        // skip the messages that are not confirmed
+        if (!multiple && iter->first != tag) { ++iter; continue; }
+
+        // the latency of this message
+        auto duration = now - iter->second;
+
+        // record it
+        measure([duration](Stats &stats) { stats._confirmLatency.add(duration); });
+
+        // the message is no longer unconfirmed
+        iter = _unconfirmed.erase(iter);
+    }
+}
+
+/**
+ *  Report that a message was returned by the server
+ */
+void ChannelImpl::reportReturned()
+{
+    // count the message
+    measure([](Stats &stats) { stats._returned.add(); });
+}
+
+/**
+ *  Report that a message was delivered
+ */
+void ChannelImpl::reportDelivered()
+{
+    // count the message
+    measure([](Stats &stats) { stats._delivered.add(); });
+}
+
+/**
+ *  Forget about the operations and messages that were in progress when 
+ *  the channel failed or was suspended
+ *  @param  queued          number of frames that were removed from the queue
+ */
+void ChannelImpl::discard(size_t queued)
+{
+    // the frames are no longer queued
+    if (queued > 0) measure([queued](Stats &stats) { stats._channelQueue.decrement(queued); });
+
+    // the operations and messages are never going to be answered
+    _operations = std::queue<std::chrono::steady_clock::time_point>();
+    _unconfirmed.clear();
+}
+
 /**
  *  Get the current receiver for a given consumer tag
  *  @param  consumertag     the consumer frame
  *  @return DeferredConsumer
  */
-DeferredConsumer *ChannelImpl::consumer(const std::string &consumertag) const
+DeferredConsumer *ChannelImpl::consumer(const StringView &consumertag) const
 {
+    // a channel normally has just a few consumers, so we compare the tags one by one
+    // (looking it up in the map would first require a std::string to be constructed)
+    if (_consumers.size() <= 8)
+    {
+        // check all consumers
+        for (const auto &iter : _consumers) if (consumertag == iter.first) return iter.second.get();
+
+        // not found
+        return nullptr;
+    }
+
     // look in the map
     auto iter = _consumers.find(consumertag);
     
@@ -12,42 +12,52 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ChannelOpenFrame : public ChannelFrame
+class ChannelOpenFrame : public MethodCodec<ChannelOpenFrame, ChannelFrame>
 {
+private:
+    /**
+     *  Field that is no longer in use
+     *  @var ShortString
+     */
+    ShortString _deprecated;
+
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ChannelFrame::fill(buffer);
-        
-        // add deprecated data
-        ShortString unused;
-        
-        // add to the buffer
-        unused.fill(buffer);
+        visitor(self._deprecated);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Constructor to create a channelOpenFrame
      *
      *  @param  channel     channel we're working on
      */
-    ChannelOpenFrame(uint16_t channel) : ChannelFrame(channel, 1) {}    // 1 for the deprecated shortstring size
+    ChannelOpenFrame(uint16_t channel) : Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct to parse a received frame
      *  @param  frame
      */
-    ChannelOpenFrame(ReceivedFrame &frame) : ChannelFrame(frame)
+    ChannelOpenFrame(ReceivedFrame &frame) : Codec(frame)
     {
-        // deprecated argument
-        ShortString unused(frame);
+        // read the fields
+        decode(frame);
     }
 
     /**
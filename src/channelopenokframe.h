@@ -12,41 +12,51 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ChannelOpenOKFrame : public ChannelFrame
+class ChannelOpenOKFrame : public MethodCodec<ChannelOpenOKFrame, ChannelFrame>
 {
+private:
+    /**
+     *  Field that is no longer in use
+     *  @var LongString
+     */
+    LongString _deprecated;
+
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ChannelFrame::fill(buffer);
-        
-        // create and encode the silly deprecated argument
-        LongString unused;
-        
-        // add to the buffer
-        unused.fill(buffer);
+        visitor(self._deprecated);
     }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
     
 public:
     /**
      *  Constructor based on client information
      *  @param  channel     Channel identifier
      */
-    ChannelOpenOKFrame(uint16_t channel) : ChannelFrame(channel, 4) {} // 4 for the longstring size value
+    ChannelOpenOKFrame(uint16_t channel) : Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor based on incoming frame
      *  @param  frame
      */
-    ChannelOpenOKFrame(ReceivedFrame &frame) : ChannelFrame(frame) 
+    ChannelOpenOKFrame(ReceivedFrame &frame) : Codec(frame)
     {
-        // read in a deprecated argument
-        LongString unused(frame);
+        // read the fields
+        decode(frame);
     }
     
     /**
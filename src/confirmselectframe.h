@@ -13,7 +13,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ConfirmSelectFrame : public ConfirmFrame
+class ConfirmSelectFrame : public MethodCodec<ConfirmSelectFrame, ConfirmFrame>
 {
 private:
 
@@ -25,26 +25,32 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param   buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ConfirmFrame::fill(buffer);
-
-        // add boolean
-        _noWait.fill(buffer);
+        visitor(self._noWait);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Decode a confirm select frame from a received frame
      *
      *  @param   frame   received frame to decode
      */
-    ConfirmSelectFrame(ReceivedFrame& frame) : ConfirmFrame(frame), _noWait(frame) {}
+    ConfirmSelectFrame(ReceivedFrame& frame) : Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Construct a confirm select frame
@@ -53,9 +59,12 @@ public:
      *  @return  newly created confirm select frame
      */
     ConfirmSelectFrame(uint16_t channel, bool noWait = false) :
-        ConfirmFrame(channel, 1),   //sizeof bool
+        Codec(channel),
         _noWait(noWait)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
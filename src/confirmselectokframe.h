@@ -13,20 +13,25 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ConfirmSelectOKFrame : public ConfirmFrame
+class ConfirmSelectOKFrame : public MethodCodec<ConfirmSelectOKFrame, ConfirmFrame>
 {
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ConfirmFrame::fill(buffer);
+        visitor();
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Constructor for an incoming frame
@@ -34,7 +39,7 @@ public:
      *  @param   frame   received frame to decode
      */
     ConfirmSelectOKFrame(ReceivedFrame& frame) :
-        ConfirmFrame(frame)
+        Codec(frame)
     {}
 
     /**
@@ -44,8 +49,11 @@ public:
      *  @return  newly created confirm select ok frame
      */
     ConfirmSelectOKFrame(uint16_t channel) :
-        ConfirmFrame(channel, 0)
-    {}
+        Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
@@ -0,0 +1,113 @@
+/**
+ *  Class describing a connection blocked frame
+ *
+ *  The server sends this frame when it no longer accepts published messages,
+ *  because one of its resources (like memory or disk space) is running low.
+ *  This is a RabbitMQ extension to the protocol.
+ *
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class implementation
+ */
+class ConnectionBlockedFrame : public MethodCodec<ConnectionBlockedFrame, ConnectionFrame>
+{
+private:
+    /**
+     *  The reason why the connection is blocked
+     *  @var ShortString
+     */
+    ShortString _reason;
+
+protected:
+    /**
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
+     */
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
+    {
+        visitor(self._reason);
+    }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
+public:
+    /**
+     *  Construct a connection blocked frame from a received frame
+     *
+     *  @param frame    received frame
+     */
+    ConnectionBlockedFrame(ReceivedFrame &frame) :
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
+
+    /**
+     *  Construct a connection blocked frame
+     *
+     *  @param  reason      the reason why the connection is blocked
+     */
+    ConnectionBlockedFrame(std::string reason) :
+        Codec(0),
+        _reason(std::move(reason))
+    {
+        // calculate the size
+        measure();
+    }
+
+    /**
+     *  Destructor
+     */
+    virtual ~ConnectionBlockedFrame() {}
+
+    /**
+     *  Method id
+     *  @return uint16_t
+     */
+    virtual uint16_t methodID() const override
+    {
+        return 60;
+    }
+
+    /**
+     *  Get the reason why the connection is blocked
+     *  @return string
+     */
+    const std::string& reason() const
+    {
+        return _reason;
+    }
+
+    /**
+     *  Process the frame
+     *  @param  connection      The connection over which it was received
+     *  @return bool            Was it succesfully processed?
+     */
+    virtual bool process(ConnectionImpl *connection) override
+    {
+        // report to the connection
+        connection->reportBlocked(_reason.value().c_str());
+
+        // done
+        return true;
+    }
+};
+
+/**
+ *  end namespace
+ */
+}
+
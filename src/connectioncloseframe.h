@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ConnectionCloseFrame : public ConnectionFrame
+class ConnectionCloseFrame : public MethodCodec<ConnectionCloseFrame, ConnectionFrame>
 {
 private:
     /**
@@ -43,22 +43,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ConnectionFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_code);
-        _text.fill(buffer);
-        buffer.add(_failingClass);
-        buffer.add(_failingMethod);
+        visitor(self._code, self._text, self._failingClass, self._failingMethod);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a connection close frame from a received frame
@@ -66,12 +65,11 @@ public:
      *  @param frame    received frame
      */
     ConnectionCloseFrame(ReceivedFrame &frame) :
-        ConnectionFrame(frame),
-        _code(frame.nextUint16()),
-        _text(frame),
-        _failingClass(frame.nextUint16()),
-        _failingMethod(frame.nextUint16())
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Construct a connection close frame
@@ -82,12 +80,15 @@ public:
      *  @param  failingMethod   id of the failing method if applicable
      */
     ConnectionCloseFrame(uint16_t code, std::string text, uint16_t failingClass = 0, uint16_t failingMethod = 0) :
-        ConnectionFrame((uint32_t)(text.length() + 7)), // 1 for extra string byte, 2 for each uint16
+        Codec(0),
         _code(code),
         _text(std::move(text)),
         _failingClass(failingClass),
         _failingMethod(failingMethod)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
@@ -12,19 +12,24 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ConnectionCloseOKFrame : public ConnectionFrame
+class ConnectionCloseOKFrame : public MethodCodec<ConnectionCloseOKFrame, ConnectionFrame>
 {
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ConnectionFrame::fill(buffer);
+        visitor();
     }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
 public:
     /**
      *  Constructor based on a received frame
@@ -32,15 +37,18 @@ public:
      *  @param frame    received frame
      */
     ConnectionCloseOKFrame(ReceivedFrame &frame) :
-        ConnectionFrame(frame)
+        Codec(frame)
     {}
 
     /**
      *  construct a channelcloseokframe object
      */
     ConnectionCloseOKFrame() :
-        ConnectionFrame(0)
-    {}
+        Codec(0)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
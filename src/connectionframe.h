@@ -18,12 +18,13 @@ protected:
     /**
      *  Constructor for a connectionFrame
      *  
-     *  A connection frame never has a channel identifier, so this is passed
-     *  as zero to the base constructor
+     *  A connection frame never has a channel identifier, so the channel
+     *  should always be zero
      * 
+     *  @param  channel     channel identifier (always zero)
      *  @param  size        size of the frame
      */
-    ConnectionFrame(uint32_t size) : MethodFrame(0, size) {}
+    ConnectionFrame(uint16_t channel, uint32_t size) : MethodFrame(channel, size) {}
 
     /**
      *  Constructor based on a received frame
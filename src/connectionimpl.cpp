@@ -9,15 +9,36 @@
 #include "protocolheaderframe.h"
 #include "connectioncloseokframe.h"
 #include "connectioncloseframe.h"
-#include "reducedbuffer.h"
 #include "passthroughbuffer.h"
 #include "heartbeatframe.h"
+#include <time.h>
 
 /**
  *  set namespace
  */
 namespace AMQP {
 
+/**
+ *  The current time, used for the last-sent and last-received timestamps. These
+ *  are updated for every frame, and are only used for heartbeats, so we use the
+ *  coarse clock when it exists: it is a lot cheaper, and precise enough
+ *  @return std::chrono::steady_clock::time_point
+ */
+static std::chrono::steady_clock::time_point now()
+{
+#ifdef CLOCK_MONOTONIC_COARSE
+    // read the coarse clock (same epoch as the steady clock on linux)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+
+    // convert to a time point
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+#else
+    // use the regular clock
+    return std::chrono::steady_clock::now();
+#endif
+}
+
 /**
  *  Construct an AMQP object based on full login data
  *
@@ -104,39 +125,51 @@ void ConnectionImpl::remove(const ChannelImpl *channel)
  *  later call.
  *
  *  @param  buffer      buffer to decode
+ *  @param  data        the same data in contiguous memory (or nullptr if the buffer is not contiguous)
  *  @return             number of bytes that were processed
  */
-uint64_t ConnectionImpl::parse(const Buffer &buffer)
+uint64_t ConnectionImpl::parse(const Buffer &buffer, const char *data)
 {
     // do not parse if already in an error state
     if (_state == state_closed) return 0;
 
-    // number of bytes processed
-    uint64_t processed = 0;
+    // the server is still alive
+    _received = now();
+
+    // number of bytes processed, and the number of bytes available
+    uint64_t processed = 0, size = buffer.size();
 
     // create a monitor object that checks if the connection still exists
     Monitor monitor(this);
 
     // keep looping until we have processed all bytes, and the monitor still
-    // indicates that the connection is in a valid state
-    while (processed < buffer.size() && monitor.valid())
+    // indicates that the connection is in a valid state (and was not paused)
+    while (processed < size && monitor.valid() && _paused == 0)
     {
         // prevent protocol exceptions
         try
         {
-            // try to recognize the frame
-            ReducedBuffer reduced_buf(buffer, (size_t)processed);
-            ReceivedFrame receivedFrame(reduced_buf, _maxFrame);
+            // try to recognize the frame (straight from memory if the data is contiguous)
+            ReceivedFrame receivedFrame = data ? ReceivedFrame(data + processed, size - processed, _maxFrame) : ReceivedFrame(buffer, processed, _maxFrame);
             
             // do we have the full frame?
             if (receivedFrame.complete())
             {
+                // count the frame (before it is processed, because that could destruct us)
+                if (_stats || _channelStats) count(receivedFrame);
+
+                // trace the frame
+                AMQP_CPP_TRACE(received, receivedFrame.channel(), receivedFrame.totalSize());
+
                 // process the frame
                 receivedFrame.process(this);
 
                 // number of bytes processed
                 uint64_t bytes = receivedFrame.totalSize();
 
+                // trace the frame (the channel and the size are still available, even if we were destructed)
+                AMQP_CPP_TRACE(dispatched, receivedFrame.channel(), bytes);
+
                 // add bytes
                 processed += bytes;
             }
@@ -165,6 +198,9 @@ uint64_t ConnectionImpl::parse(const Buffer &buffer)
     // leap out if the connection object no longer exists
     if (!monitor.valid()) return processed;
 
+    // if we were paused, the rest of the buffer is processed by a later call
+    if (processed < size) return processed;
+
     // the entire buffer has been processed, the next call to parse() should at least
     // contain the size of the frame header to be meaningful for the amqp-cpp library
     _expected = 7;
@@ -180,6 +216,221 @@ uint64_t ConnectionImpl::parse(const Buffer &buffer)
     return processed;
 }
 
+/**
+ *  Stop processing incoming data. The frame that is being processed is
+ *  finished, but the parse() method does not process any further frames
+ *  until resume() has been called as many times as pause().
+ */
+void ConnectionImpl::pause()
+{
+    // only the first call has to be passed to the handler
+    if (_paused++ > 0) return;
+
+    // tell the handler, so that it can stop reading from the socket
+    _handler->onPaused(_parent);
+}
+
+/**
+ *  Resume processing incoming data
+ */
+void ConnectionImpl::resume()
+{
+    // leap out if we were not paused, or if there are more pauses
+    if (_paused == 0 || --_paused > 0) return;
+
+    // we did not read for a while, but the server was alive
+    _received = now();
+
+    // tell the handler, so that it can process the rest of the data
+    _handler->onResumed(_parent);
+}
+
+/**
+ *  Called by a channel that has body frames to produce. The handler is told
+ *  about it, unless it already knows that frames are waiting.
+ */
+void ConnectionImpl::producing()
+{
+    // leap out if the handler is already producing
+    if (_producing) return;
+
+    // the handler is going to be told
+    _producing = true;
+
+    // the handler could destruct us
+    Monitor monitor(this);
+
+    // does the handler call produce() when it has room for more data?
+    if (_handler->onProducing(_parent)) return;
+
+    // if not, all frames are produced right away
+    while (monitor.valid() && produce()) {}
+}
+
+/**
+ *  Produce the next body frames of the messages that are published from a
+ *  producer. The channels take turns, so that they all make progress.
+ *  @return bool            are there more frames to produce?
+ */
+bool ConnectionImpl::produce()
+{
+    // the channels and the producers can destruct us
+    Monitor monitor(this);
+
+    // the number of bytes that we are going to produce (about four frames)
+    size_t window = 4 * (size_t)_maxFrame;
+
+    // keep going until the window is full
+    while (window > 0)
+    {
+        // the channels that have frames to produce (with a reference, so that
+        // they stay alive while their producers are called)
+        std::vector<std::shared_ptr<ChannelImpl>> channels;
+        for (const auto &iter : _channels) if (iter.second->producing()) channels.push_back(iter.second);
+
+        // if there are no such channels, we are done
+        if (channels.empty()) return _producing = false;
+
+        // let each channel produce a frame
+        for (const auto &channel : channels)
+        {
+            // produce a frame
+            size_t bytes = channel->produce();
+
+            // leap out if we no longer exist
+            if (!monitor.valid()) return false;
+
+            // update the window
+            window -= std::min(bytes, window);
+        }
+    }
+
+    // there may be more to produce
+    return true;
+}
+
+/**
+ *  Are there channels with body frames to produce?
+ *  @return bool
+ */
+bool ConnectionImpl::producers() const
+{
+    // check all channels
+    for (const auto &iter : _channels) if (iter.second->producing()) return true;
+
+    // no producers found
+    return false;
+}
+
+/**
+ *  Set the watermarks for the data that is waiting to be sent
+ *  @param  high            number of bytes at which backpressure starts (0 to disable)
+ *  @param  low             number of bytes at which it ends
+ */
+void ConnectionImpl::watermarks(size_t high, size_t low)
+{
+    // store the watermarks (the low one can not be above the high one)
+    _highWatermark = high;
+    _lowWatermark = std::min(low, high);
+
+    // the current number of bytes may already be over (or under) them
+    checkBackpressure();
+}
+
+/**
+ *  Tell the handler when the bytes waiting to be sent cross a watermark
+ */
+void ConnectionImpl::checkBackpressure()
+{
+    // the number of bytes waiting to be sent
+    size_t bytes = _queuedBytes + _bufferedBytes;
+
+    // backpressure starts at the high watermark, and ends at the low watermark
+    bool active = _highWatermark > 0 && (_backpressure ? bytes > _lowWatermark : bytes >= _highWatermark);
+
+    // leap out if nothing changed
+    if (active == _backpressure) return;
+
+    // remember the new situation
+    _backpressure = active;
+
+    // tell the handler
+    _handler->onBackpressure(_parent, active);
+}
+
+/**
+ *  Should published messages be held back while the connection is blocked?
+ *  @param  enabled
+ */
+void ConnectionImpl::gated(bool enabled)
+{
+    // were messages held back?
+    bool holding = this->holding();
+
+    // store the setting
+    _gated = enabled;
+
+    // the messages that were held back can be sent now
+    if (holding && !enabled) release();
+}
+
+/**
+ *  Report that the server blocked the connection
+ *  @param  reason          why the connection is blocked
+ */
+void ConnectionImpl::reportBlocked(const char *reason)
+{
+    // from now on, published messages can be held back
+    _blocked = true;
+
+    // inform the handler
+    _handler->onBlocked(_parent, reason);
+}
+
+/**
+ *  Report that the server no longer blocks the connection
+ */
+void ConnectionImpl::reportUnblocked()
+{
+    // were messages held back?
+    bool holding = this->holding();
+
+    // the server accepts messages again
+    _blocked = false;
+
+    // the handler could destruct us
+    Monitor monitor(this);
+
+    // inform the handler (messages that it publishes are queued behind the ones that were held back)
+    _handler->onUnblocked(_parent);
+
+    // send the messages that were held back
+    if (monitor.valid() && holding) release();
+}
+
+/**
+ *  Let the channels send the messages that they held back
+ */
+void ConnectionImpl::release()
+{
+    // the channels could destruct us
+    Monitor monitor(this);
+
+    // we need a copy of the channels, because they could remove themselves
+    std::vector<std::shared_ptr<ChannelImpl>> channels;
+    for (const auto &iter : _channels) channels.push_back(iter.second);
+
+    // let each channel send its queue
+    for (const auto &channel : channels)
+    {
+        // send the frames that were held back
+        channel->reportUnblocked();
+
+        // leap out if we no longer exist
+        if (!monitor.valid()) return;
+    }
+}
+
 /**
  *  Fail all open channels, helper method
  *  @param  monitor     object to check if object still exists
@@ -216,7 +467,125 @@ bool ConnectionImpl::fail(const char *message)
     _state = state_closed;
 
     // monitor because every callback could invalidate the connection
-    fail(Monitor(this), message);
+    Monitor monitor(this);
+
+    // channels of a recoverable connection are suspended, the others report the error
+    if (_recoverable) suspend(monitor, message);
+    else fail(monitor, message);
+
+    // done
+    return true;
+}
+
+/**
+ *  Suspend all channels that can be recovered, helper method
+ *  @param  monitor     object to check if object still exists
+ *  @param  message     error message
+ *  @return bool        does the object still exist?
+ */
+bool ConnectionImpl::suspend(const Monitor &monitor, const char *message)
+{
+    // we need a copy of the channels, because the map is modified when channels fail
+    std::vector<std::shared_ptr<ChannelImpl>> channels;
+
+    // copy the channels
+    for (const auto &iter : _channels) channels.push_back(iter.second);
+
+    // loop through the channels
+    for (const auto &channel : channels)
+    {
+        // channels that are usable are suspended, the others (that were already 
+        // closing down) fail, and channels that are already suspended stay that way
+        if (channel->usable()) channel->suspend(message);
+        else if (!channel->recovering()) channel->reportError(message);
+
+        // leap out if no longer valid
+        if (!monitor.valid()) return false;
+    }
+
+    // done
+    return true;
+}
+
+/**
+ *  Make the connection recoverable (or not)
+ *  @param  enabled
+ */
+void ConnectionImpl::recoverable(bool enabled)
+{
+    // store the setting
+    _recoverable = enabled;
+
+    // if the connection is recoverable, or still alive, there is nothing else to do
+    if (_recoverable || _state != state_closed) return;
+
+    // the suspended channels are never going to be recovered
+    fail(Monitor(this), "connection could not be recovered");
+}
+
+/**
+ *  Restart a recoverable connection that was lost, this resets the 
+ *  connection to its initial state and re-opens all suspended channels
+ *  @param  login       login data for the new connection
+ *  @param  vhost       vhost for the new connection
+ *  @return bool
+ */
+bool ConnectionImpl::recover(const Login &login, const std::string &vhost)
+{
+    // only lost connections can be recovered
+    if (!_recoverable || _state != state_closed || _closed) return false;
+
+    // start all over again
+    _state = state_protocol;
+    _maxChannels = 0;
+    _maxFrame = 4096;
+    _expected = 7;
+    _paused = 0;
+    _producing = false;
+    _blocked = false;
+    _login = login;
+    _vhost = vhost;
+
+    // the new connection has not yet been silent for any time
+    _received = now();
+
+    // data that was not sent to the previous connection is discarded
+    _queue = std::queue<CopiedBuffer>();
+    _queuedBytes = _bufferedBytes = 0;
+
+    // the queue is empty now
+    if (_stats) _stats->_connectionQueue.set(0);
+
+    // sending data could destruct us
+    Monitor monitor(this);
+
+    // the data that was discarded no longer holds back the application
+    checkBackpressure();
+
+    // leap out if the object was destructed
+    if (!monitor.valid()) return false;
+
+    // we need to send a protocol header
+    send(ProtocolHeaderFrame());
+
+    // leap out if the object was destructed
+    if (!monitor.valid()) return false;
+
+    // we need a copy of the channels, because channels that can not be re-opened remove themselves
+    std::vector<std::shared_ptr<ChannelImpl>> channels;
+
+    // copy the channels
+    for (const auto &iter : _channels) channels.push_back(iter.second);
+
+    // re-open the channels (they are queued until the handshake is complete)
+    for (const auto &channel : channels)
+    {
+        // recover the channel
+        channel->recover();
+
+        // leap out if no longer valid
+        if (!monitor.valid()) return false;
+    }
 
     // done
     return true;
@@ -231,8 +600,8 @@ void ConnectionImpl::reportError(const char *message)
     // monitor because every callback could invalidate the connection
     Monitor monitor(this);
 
-    // fail all operations
-    if (!fail(monitor, message)) return;
+    // fail all operations (or suspend the channels if they can be recovered)
+    if (!(_recoverable ? suspend(monitor, message) : fail(monitor, message))) return;
 
     // inform handler
     _handler->onError(_parent, message);
@@ -254,6 +623,17 @@ bool ConnectionImpl::close()
     // after the send operation the object could be dead
     Monitor monitor(this);
 
+    // the answers to the close frames have to be read, so we can no longer be paused
+    if (_paused > 0)
+    {
+        // forget all pauses
+        _paused = 1;
+        resume();
+
+        // the handler could have destructed us
+        if (!monitor.valid()) return true;
+    }
+
     // number of channels that are waiting for an answer and that have further data
     int waiters = 0;
 
@@ -334,9 +714,19 @@ void ConnectionImpl::setReady()
         if (!monitor.valid()) return;
 
         // remove it from the queue
+        _queuedBytes -= buffer.size();
         _queue.pop();
+
+        // one frame less in the queue
+        if (_stats) _stats->_connectionQueue.decrement();
     }
 
+    // the queue is empty now
+    checkBackpressure();
+
+    // the handler could have destructed us
+    if (!monitor.valid()) return;
+
     // if the close method was called before, and no channel is waiting
     // for an answer, we can now safely send out the close frame
     if (_closed && _state == state_connected && !waiting()) sendClose();
@@ -391,9 +781,16 @@ bool ConnectionImpl::send(const Frame &frame)
     // it is impossible to send out this frame successfully
     if (frame.totalSize() > _maxFrame) return false;
 
+    // count and trace the frame
+    if (_stats) _stats->sent(frame.type(), frame.totalSize());
+    AMQP_CPP_TRACE(sent, frame.channel(), frame.totalSize());
+
     // are we still setting up the connection?
     if ((_state == state_connected && _queue.empty()) || frame.partOfHandshake())
     {
+        // remember when data was last sent
+        _sent = now();
+
         // we need an output buffer (this will immediately send the data)
         PassthroughBuffer buffer(_parent, _handler, frame);
     }
@@ -401,6 +798,13 @@ bool ConnectionImpl::send(const Frame &frame)
     {
         // the connection is still being set up, so we need to delay the message sending
         _queue.emplace(frame);
+        _queuedBytes += frame.totalSize();
+
+        // one frame more in the queue
+        if (_stats) _stats->_connectionQueue.increment();
+
+        // the queue may have grown over the high watermark
+        checkBackpressure();
     }
 
     // done
@@ -417,22 +821,55 @@ bool ConnectionImpl::send(CopiedBuffer &&buffer)
     // this only works when we are already connected
     if (_state != state_connected) return false;
 
+    // count and trace the frame (the first byte holds the type, followed by the channel)
+    if (_stats) _stats->sent(buffer.data()[0], buffer.size());
+    AMQP_CPP_TRACE(sent, (uint8_t)buffer.data()[1] << 8 | (uint8_t)buffer.data()[2], buffer.size());
+
     // are we waiting for other frames to be sent before us?
     if (_queue.empty())
     {
+        // remember when data was last sent
+        _sent = now();
+
         // send it directly
         _handler->onData(_parent, buffer.data(), buffer.size());
     }
     else
     {
         // add to the list of waiting buffers
+        _queuedBytes += buffer.size();
         _queue.emplace(std::move(buffer));
+
+        // one frame more in the queue
+        if (_stats) _stats->_connectionQueue.increment();
+
+        // the queue may have grown over the high watermark
+        checkBackpressure();
     }
 
     // done
     return true;
 }
 
+/**
+ *  Count a received frame in the statistics of the connection and its channel
+ *  @param  frame
+ */
+void ConnectionImpl::count(const ReceivedFrame &frame)
+{
+    // count it for the connection
+    if (_stats) _stats->received(frame.type(), frame.totalSize());
+
+    // frames for channel zero belong to the connection only
+    if (!_channelStats || frame.channel() == 0) return;
+
+    // look up the channel
+    auto iter = _channels.find(frame.channel());
+
+    // count it for the channel too
+    if (iter != _channels.end() && iter->second->stats()) iter->second->stats()->received(frame.type(), frame.totalSize());
+}
+
 /**
  *  Send a ping / heartbeat frame to keep the connection alive
  *  @return bool
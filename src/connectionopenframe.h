@@ -15,7 +15,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ConnectionOpenFrame : public ConnectionFrame
+class ConnectionOpenFrame : public MethodCodec<ConnectionOpenFrame, ConnectionFrame>
 {
 private:
     /**
@@ -38,21 +38,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ConnectionFrame::fill(buffer);
-
-        // encode fields
-        _vhost.fill(buffer);
-        _deprecatedCapabilities.fill(buffer);
-        _deprecatedInsist.fill(buffer);
+        visitor(self._vhost, self._deprecatedCapabilities, self._deprecatedInsist);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Open a virtual host
@@ -60,11 +60,14 @@ public:
      *  @param  vhost   name of virtual host to open
      */
     ConnectionOpenFrame(const std::string &vhost) :
-        ConnectionFrame((uint32_t)(vhost.length() + 3)), // length of vhost + byte to encode this length + deprecated shortstring size + deprecated bool
+        Codec(0),
         _vhost(vhost),
         _deprecatedCapabilities(""),
         _deprecatedInsist()
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
      /**
      *  Constructor based on a received frame
@@ -72,11 +75,11 @@ public:
      *  @param  frame   received frame
      */
     ConnectionOpenFrame(ReceivedFrame &frame) :
-        ConnectionFrame(frame),
-        _vhost(frame),
-        _deprecatedCapabilities(frame),
-        _deprecatedInsist(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -15,7 +15,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ConnectionOpenOKFrame : public ConnectionFrame
+class ConnectionOpenOKFrame : public MethodCodec<ConnectionOpenOKFrame, ConnectionFrame>
 {
 private:
     /**
@@ -26,18 +26,20 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ConnectionFrame::fill(buffer);
-
-        // add deprecaed field
-        _deprecatedKnownHosts.fill(buffer);
+        visitor(self._deprecatedKnownHosts);
     }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
 public:
     /**
      *  Construct a connectionopenokframe from a received frame
@@ -45,18 +47,23 @@ public:
      *  @param  frame   received frame
      */
     ConnectionOpenOKFrame(ReceivedFrame &frame) :
-        ConnectionFrame(frame),
-        _deprecatedKnownHosts(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Construct a connectionopenokframe
      *
      */
     ConnectionOpenOKFrame() :
-        ConnectionFrame(1), // for the deprecated shortstring
+        Codec(0),
         _deprecatedKnownHosts("")
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
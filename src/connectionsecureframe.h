@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ConnectionSecureFrame : public ConnectionFrame
+class ConnectionSecureFrame : public MethodCodec<ConnectionSecureFrame, ConnectionFrame>
 {
 private:
     /**
@@ -23,19 +23,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ConnectionFrame::fill(buffer);
-
-        // encode fields
-        _challenge.fill(buffer);
+        visitor(self._challenge);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a connection security challenge frame
@@ -43,9 +45,12 @@ public:
      *  @param  challenge   the challenge
      */
     ConnectionSecureFrame(const std::string& challenge) :
-        ConnectionFrame((uint32_t)(challenge.length() + 4)), // 4 for the length of the challenge (uint32_t)
+        Codec(0),
         _challenge(challenge)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct a connection secure frame from a received frame
@@ -53,9 +58,11 @@ public:
      *  @param  frame   received frame
      */
     ConnectionSecureFrame(ReceivedFrame &frame) :
-        ConnectionFrame(frame),
-        _challenge(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ConnectionSecureOKFrame : public ConnectionFrame
+class ConnectionSecureOKFrame : public MethodCodec<ConnectionSecureOKFrame, ConnectionFrame>
 {
 private:
     /**
@@ -23,19 +23,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ConnectionFrame::fill(buffer);
-
-        // add fields
-        _response.fill(buffer);
+        visitor(self._response);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a connection security challenge response frame
@@ -43,9 +45,12 @@ public:
      *  @param  response    the challenge response
      */
     ConnectionSecureOKFrame(const std::string& response) :
-        ConnectionFrame((uint32_t)(response.length() + 4)), //response length + uint32_t for encoding the length
+        Codec(0),
         _response(response)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct a connection security challenge response frame from a received frame
@@ -53,9 +58,11 @@ public:
      *  @param  frame   received frame
      */
     ConnectionSecureOKFrame(ReceivedFrame &frame) :
-        ConnectionFrame(frame),
-        _response(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -16,7 +16,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ConnectionStartFrame : public ConnectionFrame
+class ConnectionStartFrame : public MethodCodec<ConnectionStartFrame, ConnectionFrame>
 {
 private:
     /**
@@ -53,23 +53,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ConnectionFrame::fill(buffer);
-
-        // encode all fields
-        buffer.add(_major);
-        buffer.add(_minor);
-        _properties.fill(buffer);
-        _mechanisms.fill(buffer);
-        _locales.fill(buffer);
+        visitor(self._major, self._minor, self._properties, self._mechanisms, self._locales);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Client-side constructer for a connection start frame
@@ -81,13 +79,16 @@ public:
      *  @param  locales     available locales
      */
     ConnectionStartFrame(uint8_t major, uint8_t minor, const Table& properties, const std::string& mechanisms, const std::string& locales) :
-        ConnectionFrame((uint32_t)(properties.size() + mechanisms.length() + locales.length() + 10)), // 4 for each longstring (size-uint32), 2 major/minor
+        Codec(0),
         _major(major),
         _minor(minor),
         _properties(properties),
         _mechanisms(mechanisms),
         _locales(locales)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct a connection start frame from a received frame
@@ -95,13 +96,11 @@ public:
      *  @param  frame   received frame
      */
     ConnectionStartFrame(ReceivedFrame &frame) :
-        ConnectionFrame(frame),
-        _major(frame.nextUint8()),
-        _minor(frame.nextUint8()),
-        _properties(frame),
-        _mechanisms(frame),
-        _locales(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -194,6 +193,9 @@ public:
         
         // we want a special treatment for authentication failures
         capabilities["authentication_failure_close"] = true;
+
+        // we want to be told when the server blocks the connection
+        capabilities["connection.blocked"] = true;
         
         // fill the peer properties
         if (!properties.contains("product")) properties["product"] = "Copernica AMQP library";
@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ConnectionStartOKFrame : public ConnectionFrame
+class ConnectionStartOKFrame : public MethodCodec<ConnectionStartOKFrame, ConnectionFrame>
 {
 private:
     /**
@@ -43,22 +43,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ConnectionFrame::fill(buffer);
-
-        // add fields
-        _properties.fill(buffer);
-        _mechanism.fill(buffer);
-        _response.fill(buffer);
-        _locale.fill(buffer);
+        visitor(self._properties, self._mechanism, self._response, self._locale);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a connection start ok frame from a received frame
@@ -66,12 +65,11 @@ public:
      *  @param  frame   received frame
      */
     ConnectionStartOKFrame(ReceivedFrame &frame) :
-        ConnectionFrame(frame),
-        _properties(frame),
-        _mechanism(frame),
-        _response(frame),
-        _locale(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /** 
      *  Construct a connection start ok frame
@@ -82,12 +80,15 @@ public:
      *  @param  locale      selected locale.
      */
     ConnectionStartOKFrame(const Table& properties, const std::string& mechanism, const std::string& response, const std::string& locale) :
-        ConnectionFrame((uint32_t)(properties.size() + mechanism.length() + response.length() + locale.length() + 6)), // 1 byte extra per shortstring, 4 per longstring
+        Codec(0),
         _properties(properties),
         _mechanism(mechanism),
         _response(response),
         _locale(locale)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
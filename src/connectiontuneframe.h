@@ -19,7 +19,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ConnectionTuneFrame : public ConnectionFrame
+class ConnectionTuneFrame : public MethodCodec<ConnectionTuneFrame, ConnectionFrame>
 {
 private:
     /**
@@ -42,20 +42,20 @@ private:
     
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ConnectionFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_channels);
-        buffer.add(_frameMax);
-        buffer.add(_heartbeat);
+        visitor(self._channels, self._frameMax, self._heartbeat);
     }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
 public:
     /**
      *  Construct a connection tuning frame
@@ -65,11 +65,14 @@ public:
      *  @param  heartbeat   desired heartbeat delay
      */
     ConnectionTuneFrame(uint16_t channels, uint32_t frameMax, uint16_t heartbeat) : 
-        ConnectionFrame(8), // 2x uint16_t, 1x uint32_t
+        Codec(0),
         _channels(channels),
         _frameMax(frameMax),
         _heartbeat(heartbeat)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct a connection tune frame from a received frame
@@ -77,11 +80,11 @@ public:
      *  @param  frame   received frame
      */
     ConnectionTuneFrame(ReceivedFrame &frame) :
-        ConnectionFrame(frame),
-        _channels(frame.nextUint16()),
-        _frameMax(frame.nextUint32()),
-        _heartbeat(frame.nextUint16())
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -0,0 +1,90 @@
+/**
+ *  Class describing a connection unblocked frame
+ *
+ *  The server sends this frame when it accepts published messages again,
+ *  after it blocked the connection. This is a RabbitMQ extension to the protocol.
+ *
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class implementation
+ */
+class ConnectionUnblockedFrame : public MethodCodec<ConnectionUnblockedFrame, ConnectionFrame>
+{
+protected:
+    /**
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
+     */
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
+    {
+        visitor();
+    }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
+public:
+    /**
+     *  Construct a connection unblocked frame from a received frame
+     *
+     *  @param frame    received frame
+     */
+    ConnectionUnblockedFrame(ReceivedFrame &frame) :
+        Codec(frame)
+    {}
+
+    /**
+     *  Construct a connection unblocked frame
+     */
+    ConnectionUnblockedFrame() :
+        Codec(0)
+    {
+        // calculate the size
+        measure();
+    }
+
+    /**
+     *  Destructor
+     */
+    virtual ~ConnectionUnblockedFrame() {}
+
+    /**
+     *  Method id
+     *  @return uint16_t
+     */
+    virtual uint16_t methodID() const override
+    {
+        return 61;
+    }
+
+    /**
+     *  Process the frame
+     *  @param  connection      The connection over which it was received
+     *  @return bool            Was it succesfully processed?
+     */
+    virtual bool process(ConnectionImpl *connection) override
+    {
+        // report to the connection
+        connection->reportUnblocked();
+
+        // done
+        return true;
+    }
+};
+
+/**
+ *  end namespace
+ */
+}
+
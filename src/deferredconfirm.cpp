@@ -22,7 +22,7 @@ namespace AMQP {
  */
 void DeferredConfirm::process(BasicAckFrame &frame)
 {
-    if (_ackCallback) _ackCallback(frame.deliveryTag(), frame.multiple());
+    if (_ackCallback) _ackCallback(frame.deliveryTag() + _offset, frame.multiple());
 }
 
 /**
@@ -32,7 +32,24 @@ void DeferredConfirm::process(BasicAckFrame &frame)
  */
 void DeferredConfirm::process(BasicNackFrame &frame)
 {
-    if (_nackCallback) _nackCallback(frame.deliveryTag(), frame.multiple(), frame.requeue());
+    if (_nackCallback) _nackCallback(frame.deliveryTag() + _offset, frame.multiple(), frame.requeue());
+}
+
+/**
+ *  Report that the connection was lost
+ *
+ *  @param  published   Total number of messages published in confirm mode
+ */
+void DeferredConfirm::reset(uint64_t published)
+{
+    // nothing was published since the previous reset
+    if (published <= _offset) return;
+
+    // messages published on the next connection are numbered after the ones published so far
+    _offset = published;
+
+    // all messages that were not yet confirmed are never going to be confirmed
+    if (_nackCallback) _nackCallback(published, true, false);
 }
 
 /**
@@ -24,7 +24,7 @@ void DeferredConsumer::process(BasicDeliverFrame &frame)
     _channel->install(shared_from_this());
     
     // retrieve the delivery tag and whether we were redelivered
-    _deliveryTag = frame.deliveryTag();
+    _deliveryTag = _channel->deliveryTag(frame.deliveryTag());
     _redelivered = frame.redelivered();
 
     // initialize the object for the next message
@@ -12,6 +12,7 @@
  */
 #include "amqpcpp/deferredextreceiver.h"
 #include "amqpcpp/channelimpl.h"
+#include "amqpcpp/tracer.h"
  
 /**
  *  Begin of namespace
@@ -23,13 +24,16 @@ namespace AMQP {
  *  @param  exchange            the exchange to which the message was published
  *  @param  routingkey          the routing key that was used to publish the message
  */
-void DeferredExtReceiver::initialize(const std::string &exchange, const std::string &routingkey)
+void DeferredExtReceiver::initialize(const StringView &exchange, const StringView &routingkey)
 {
     // call base
     DeferredReceiver::initialize(exchange, routingkey);
     
     // do we have anybody interested in messages? in that case we construct the message
     if (_messageCallback) _message.construct(exchange, routingkey);
+
+    // the same for messages that are streamed
+    if (_streamCallback) _stream.construct(exchange, routingkey, _deliveryTag, _redelivered);
 }
 
 /**
@@ -40,14 +44,24 @@ void DeferredExtReceiver::complete()
     // also monitor the channel
     Monitor monitor(_channel);
 
+    // trace the call to user space
+    AMQP_CPP_TRACE(enter, _channel->id(), _deliveryTag);
+
     // do we have a message?
     if (_message) _messageCallback(*_message, _deliveryTag, _redelivered);
 
+    // or a stream that is now complete?
+    if (_stream) _stream->complete();
+
     // do we have to inform anyone about completion?
     if (_deliveredCallback) _deliveredCallback(_deliveryTag, _redelivered);
+
+    // user space is done with the message (and could have destructed the channel)
+    AMQP_CPP_TRACE(leave, monitor.valid() ? _channel->id() : 0, _deliveryTag);
     
     // for the next iteration we want a new message
     _message.reset();
+    _stream.reset();
 
     // do we still have a valid channel
     if (!monitor.valid()) return;
@@ -29,7 +29,7 @@ const std::shared_ptr<Deferred> &DeferredGet::reportSuccess(uint32_t messagecoun
     _channel->install(shared_from_this());
     
     // store delivery tag and redelivery status
-    _deliveryTag = deliveryTag;
+    _deliveryTag = _channel->deliveryTag(deliveryTag);
     _redelivered = redelivered;
 
     // report the size (note that this is the size _minus_ the message that is retrieved
@@ -56,18 +56,6 @@ const std::shared_ptr<Deferred> &DeferredGet::reportSuccess() const
     return _next;
 }
 
-/**
- *  Extended implementation of the complete method that is called when a message was fully received
- */
-void DeferredGet::complete()
-{
-    // the channel is now synchronized, delayed frames may now be sent
-    _channel->flush();
-    
-    // pass on to normal implementation
-    DeferredExtReceiver::complete();
-}
-
 /**
  *  End of namespace
  */
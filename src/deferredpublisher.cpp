@@ -26,7 +26,7 @@ void DeferredPublisher::process(BasicReturnFrame &frame)
 
     // retrieve the delivery tag and whether we were redelivered
     _code = frame.replyCode();
-    _description = frame.replyText();
+    _description = frame.replyText().str();
     
     // notify user space of the begin of the returned message
     if (_beginCallback) _beginCallback(_code, _description);
@@ -25,7 +25,7 @@ namespace AMQP {
  *  @param  exchange
  *  @param  routingkey
  */
-void DeferredReceiver::initialize(const std::string &exchange, const std::string &routingkey)
+void DeferredReceiver::initialize(const StringView &exchange, const StringView &routingkey)
 {
     // anybody interested in the new message?
     if (_startCallback) _startCallback(exchange, routingkey);
@@ -58,6 +58,16 @@ void DeferredReceiver::process(BasicHeaderFrame &frame)
     // anybody interested in the headers?
     if (_headerCallback) _headerCallback(frame.metaData());
 
+    // do we stream the message? then it can be passed to user space now
+    if (_stream)
+    {
+        // store the metadata and body size
+        _stream->set(frame.metaData(), _bodySize);
+
+        // user space can now install its callbacks
+        _streamCallback(*_stream);
+    }
+
     // no body data expected? then we are now complete
     if (_bodySize == 0) complete();
 }
@@ -81,6 +91,9 @@ void DeferredReceiver::process(BodyFrame &frame)
     // do we have a message? then append the data
     if (_message) _message->append(frame.payload(), frame.payloadSize());
 
+    // or do we stream it? then pass the data straight from the frame
+    if (_stream) _stream->process(frame.payload(), frame.payloadSize());
+
     // if all bytes were received we are now complete
     if (_bodySize == 0) complete();
 }
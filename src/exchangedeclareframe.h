@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ExchangeDeclareFrame : public ExchangeFrame
+class ExchangeDeclareFrame : public MethodCodec<ExchangeDeclareFrame, ExchangeFrame>
 {
 private:
     /**
@@ -51,23 +51,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ExchangeFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_deprecated);
-        _name.fill(buffer);
-        _type.fill(buffer);
-        _bools.fill(buffer);
-        _arguments.fill(buffer);
+        visitor(self._deprecated, self._name, self._type, self._bools, self._arguments);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a exchange declare frame (client side)
@@ -83,24 +81,26 @@ public:
      *  @param  arguments   additional arguments
      */
     ExchangeDeclareFrame(uint16_t channel, const std::string& name, const char *type, bool passive, bool durable, bool autodelete, bool internal, bool nowait, const Table& arguments) :
-        ExchangeFrame(channel, (uint32_t)(name.length() + strlen(type) + arguments.size() + 5)), // size of name, type and arguments + 1 (all booleans are stored in 1 byte) + 2 (deprecated short) + 2 (string sizes)
+        Codec(channel),
         _name(name),
         _type(type),
         _bools(passive, durable, autodelete, internal, nowait),
-        _arguments(arguments) {}
+        _arguments(arguments)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Construct parsing a declare frame from a received frame
      *  @param  frame           The received frame
      */
     ExchangeDeclareFrame(ReceivedFrame &frame) : 
-        ExchangeFrame(frame),
-        _deprecated(frame.nextUint16()),
-        _name(frame),
-        _type(frame),
-        _bools(frame),
-        _arguments(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -119,6 +119,18 @@ public:
         return !noWait();
     }
 
+    /**
+     *  Can this frame be pipelined?
+     *
+     *  In pipelined mode, a channel does not wait for the -ok frame of
+     *  a pipelinable frame before it sends out the next one
+     */
+    bool pipelinable() const override
+    {
+        // declaring, binding and deleting can be done back-to-back
+        return true;
+    }
+
     /**
      *  Method id
      *  @return uint16_t
@@ -12,26 +12,35 @@ namespace AMQP{
 /**
  * Class implementation
  */
-class ExchangeDeclareOKFrame : public ExchangeFrame
+class ExchangeDeclareOKFrame : public MethodCodec<ExchangeDeclareOKFrame, ExchangeFrame>
 {
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ExchangeFrame::fill(buffer);
+        visitor();
     }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
 public:
     /**
      *  Construct an exchange declare ok frame
      *
      *  @param  channel     channel we're working on
      */
-    ExchangeDeclareOKFrame(uint16_t channel) : ExchangeFrame(channel, 0) {}
+    ExchangeDeclareOKFrame(uint16_t channel) : Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Decode an exchange declare acknowledgement frame
@@ -39,7 +48,7 @@ public:
      *  @param  frame   received frame to decode
      */
     ExchangeDeclareOKFrame(ReceivedFrame &frame) :
-        ExchangeFrame(frame)
+        Codec(frame)
     {}
 
     /**
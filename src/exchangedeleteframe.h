@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ExchangeDeleteFrame : public ExchangeFrame
+class ExchangeDeleteFrame : public MethodCodec<ExchangeDeleteFrame, ExchangeFrame>
 {
 private:
     /**
@@ -37,20 +37,20 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ExchangeFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_deprecated);
-        _name.fill(buffer);
-        _bools.fill(buffer);
+        visitor(self._deprecated, self._name, self._bools);
     }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
 public:
     /**
      *  constructor based on incoming data
@@ -58,11 +58,11 @@ public:
      *  @param  frame   received frame
      */
     ExchangeDeleteFrame(ReceivedFrame &frame) : 
-        ExchangeFrame(frame),
-        _deprecated(frame.nextUint16()),
-        _name(frame),
-        _bools(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  construct a exchangedeleteframe
@@ -73,10 +73,13 @@ public:
      *  @param  bool noWait     Do not wait for a response
      */
     ExchangeDeleteFrame(uint16_t channel, const std::string& name, bool ifUnused = false, bool noWait = false) :
-        ExchangeFrame(channel, (uint32_t)(name.length() + 4)), // length of the name, 1 byte for encoding this length, 1 for bools, 2 for deprecated short
+        Codec(channel),
         _name(name),
         _bools(ifUnused, noWait)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
@@ -95,6 +98,18 @@ public:
         return !noWait();
     }
 
+    /**
+     *  Can this frame be pipelined?
+     *
+     *  In pipelined mode, a channel does not wait for the -ok frame of
+     *  a pipelinable frame before it sends out the next one
+     */
+    bool pipelinable() const override
+    {
+        // declaring, binding and deleting can be done back-to-back
+        return true;
+    }
+
     /**
      *  returns the method id
      *  @return uint16_t
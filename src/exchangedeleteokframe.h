@@ -12,20 +12,25 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class ExchangeDeleteOKFrame : public ExchangeFrame
+class ExchangeDeleteOKFrame : public MethodCodec<ExchangeDeleteOKFrame, ExchangeFrame>
 {
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ExchangeFrame::fill(buffer);
+        visitor();
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct an exchange delete ok frame
@@ -33,7 +38,7 @@ public:
      *  @param  frame   received frame
      */
     ExchangeDeleteOKFrame(ReceivedFrame &frame) :
-        ExchangeFrame(frame)
+        Codec(frame)
     {}
 
     /**
@@ -41,7 +46,11 @@ public:
      *
      *  @param  channel     channel we're working on
      */
-    ExchangeDeleteOKFrame(uint16_t channel) : ExchangeFrame(channel, 0) {}
+    ExchangeDeleteOKFrame(uint16_t channel) : Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
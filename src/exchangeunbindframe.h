@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class definition
  */
-class ExchangeUnbindFrame : public ExchangeFrame
+class ExchangeUnbindFrame : public MethodCodec<ExchangeUnbindFrame, ExchangeFrame>
 {
 private:
     /**
@@ -53,23 +53,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ExchangeFrame::fill(buffer);
-
-        buffer.add(_reserved);
-        _destination.fill(buffer);
-        _source.fill(buffer);
-        _routingKey.fill(buffer);
-        _bools.fill(buffer);
-        _arguments.fill(buffer);
+        visitor(self._reserved, self._destination, self._source, self._routingKey, self._bools, self._arguments);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Constructor based on incoming data
@@ -77,14 +75,11 @@ public:
      *  @param  frame   received frame to decode
      */
     ExchangeUnbindFrame(ReceivedFrame &frame) :
-        ExchangeFrame(frame),
-        _reserved(frame.nextUint16()),
-        _destination(frame),
-        _source(frame),
-        _routingKey(frame),
-        _bools(frame),
-        _arguments(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Constructor for an exchangebindframe
@@ -95,13 +90,16 @@ public:
      *  @param  arguments
      */
     ExchangeUnbindFrame(uint16_t channel, const std::string &destination, const std::string &source, const std::string &routingKey, bool noWait, const Table &arguments) :
-        ExchangeFrame(channel, (uint32_t)(destination.length() + source.length() + routingKey.length() + arguments.size() + 6)), // 1 for each string, 1 for booleanset, 2 for deprecated field
+        Codec(channel),
         _destination(destination),
         _source(source),
         _routingKey(routingKey),
         _bools(noWait),
         _arguments(arguments)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Is this a synchronous frame?
@@ -115,6 +113,18 @@ public:
         return !noWait();
     }
 
+    /**
+     *  Can this frame be pipelined?
+     *
+     *  In pipelined mode, a channel does not wait for the -ok frame of
+     *  a pipelinable frame before it sends out the next one
+     */
+    bool pipelinable() const override
+    {
+        // unbinding can be done back-to-back, just like declaring, binding and deleting
+        return true;
+    }
+
     /**
      *  Get the destination exchange
      *  @return string
@@ -13,20 +13,25 @@ namespace AMQP {
 /**
  *  Class definition
  */
-class ExchangeUnbindOKFrame : public ExchangeFrame
+class ExchangeUnbindOKFrame : public MethodCodec<ExchangeUnbindOKFrame, ExchangeFrame>
 {
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        ExchangeFrame::fill(buffer);
+        visitor();
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Constructor based on incoming data
@@ -34,7 +39,7 @@ public:
      *  @param  frame   received frame to decode
      */
     ExchangeUnbindOKFrame(ReceivedFrame &frame) :
-        ExchangeFrame(frame)
+        Codec(frame)
     {}
 
     /**
@@ -46,8 +51,11 @@ public:
      *  @param  arguments
      */
     ExchangeUnbindOKFrame(uint16_t channel) :
-        ExchangeFrame(channel, 0)
-    {}
+        Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     virtual uint16_t methodID() const override
     {
@@ -94,7 +94,7 @@ public:
     /**
      *  The channel this message was sent on
      */
-    uint16_t channel() const
+    virtual uint16_t channel() const override
     {
         return _channel;
     }
@@ -141,7 +141,7 @@ public:
     /**
      *  Get the message type
      */
-    virtual uint8_t type() const = 0;
+    virtual uint8_t type() const override = 0;
 
     /**
      *  Process the frame
@@ -46,21 +46,27 @@
 #include "amqpcpp/copiedbuffer.h"
 #include "amqpcpp/watchable.h"
 #include "amqpcpp/monitor.h"
+#include "amqpcpp/stats.h"
+#include "amqpcpp/tracer.h"
 
 // amqp types
 #include "amqpcpp/field.h"
 #include "amqpcpp/numericfield.h"
 #include "amqpcpp/decimalfield.h"
+#include "amqpcpp/stringview.h"
 #include "amqpcpp/stringfield.h"
 #include "amqpcpp/booleanset.h"
 #include "amqpcpp/fieldproxy.h"
 #include "amqpcpp/table.h"
 #include "amqpcpp/array.h"
+#include "amqpcpp/fieldview.h"
+#include "amqpcpp/tableencoder.h"
 
 // envelope for publishing and consuming
 #include "amqpcpp/metadata.h"
 #include "amqpcpp/envelope.h"
 #include "amqpcpp/message.h"
+#include "amqpcpp/messagestream.h"
 
 // mid level includes
 #include "amqpcpp/exchangetype.h"
@@ -78,6 +84,7 @@
 #include "amqpcpp/channel.h"
 #include "amqpcpp/login.h"
 #include "amqpcpp/address.h"
+#include "amqpcpp/addresses.h"
 #include "amqpcpp/connectionhandler.h"
 #include "amqpcpp/connectionimpl.h"
 #include "amqpcpp/connection.h"
@@ -88,6 +95,7 @@
 #include "amqpcpp/frame.h"
 #include "extframe.h"
 #include "methodframe.h"
+#include "methodcodec.h"
 #include "headerframe.h"
 #include "connectionframe.h"
 #include "channelframe.h"
@@ -0,0 +1,48 @@
+/**
+ *  Backoff.cpp
+ *
+ *  Implementation file for the reconnect policy
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Dependencies
+ */
+#include "includes.h"
+#include <random>
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  The delay before a certain attempt
+ *  @param  attempt     the attempt number, the first attempt has number 1
+ *  @return uint32_t    delay in milliseconds
+ */
+uint32_t Backoff::delay(size_t attempt) const
+{
+    // every thread has its own generator, so that no locking is needed
+    static thread_local std::mt19937 generator(std::random_device{}());
+
+    // the delay doubles with every attempt (we stop doubling in time to prevent an overflow)
+    uint64_t delay = _initial;
+    for (size_t i = 1; i < attempt && delay < _maximum; ++i) delay *= 2;
+
+    // apply the upper limit
+    delay = std::min(delay, uint64_t(_maximum));
+
+    // pick a value between half the delay and the full delay
+    std::uniform_int_distribution<uint64_t> jitter(0, delay / 2);
+
+    // done
+    return uint32_t(delay - delay / 2 + jitter(generator));
+}
+
+/**
+ *  End of namespace
+ */
+}
@@ -0,0 +1,34 @@
+/**
+ *  DnsCache.cpp
+ *
+ *  Implementation file for the dnscache.h header file
+ *
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Dependencies
+ */
+#include "includes.h"
+#include "dnscache.h"
+#include "amqpcpp/linux_tcp/dnscache.h"
+
+/**
+ *  Just the AMQP namespace
+ */
+namespace AMQP {
+
+/**
+ *  Function to change the time-to-live of cached lookups
+ *  @param  seconds
+ */
+void dnscache(uint32_t seconds)
+{
+    // pass on to the cache
+    DnsCache::instance().ttl(seconds);
+}
+
+/**
+ *  End of namespace
+ */
+}
@@ -0,0 +1,412 @@
+/**
+ *  DnsCache.h
+ *
+ *  Process-wide cache of resolved hostnames. All TcpConnection objects
+ *  share this cache, so that a burst of connections (or reconnects) to
+ *  the same broker results in a single getaddrinfo() call. Lookups for a
+ *  hostname that is already being resolved by an other thread wait for
+ *  that lookup instead of starting their own. The cache also remembers
+ *  the last address to which a connection succeeded, and returns that
+ *  address first on subsequent lookups.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <netinet/in.h>
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class DnsCache
+{
+public:
+    /**
+     *  A single resolved address (a copy of the relevant addrinfo members,
+     *  because the original addrinfo structure is freed after the lookup)
+     */
+    class Record
+    {
+    private:
+        /**
+         *  The socket address
+         *  @var struct sockaddr_storage
+         */
+        struct sockaddr_storage _address;
+
+        /**
+         *  Size of the address
+         *  @var socklen_t
+         */
+        socklen_t _size;
+
+        /**
+         *  Arguments for the socket() call
+         *  @var int
+         */
+        int _family;
+        int _socktype;
+        int _protocol;
+
+    public:
+        /**
+         *  Constructor
+         *  @param  info        the addrinfo struct to copy
+         */
+        Record(const struct addrinfo *info) :
+            _size(info->ai_addrlen),
+            _family(info->ai_family),
+            _socktype(info->ai_socktype),
+            _protocol(info->ai_protocol)
+        {
+            // copy the address
+            memcpy(&_address, info->ai_addr, std::min(sizeof(_address), size_t(info->ai_addrlen)));
+        }
+
+        /**
+         *  Compare with a different address
+         *  @param  that
+         *  @return bool
+         */
+        bool operator==(const Record &that) const
+        {
+            // compare the address
+            return _size == that._size && memcmp(&_address, &that._address, _size) == 0;
+        }
+
+        /**
+         *  Arguments for the socket() call
+         *  @return int
+         */
+        int family() const { return _family; }
+        int socktype() const { return _socktype; }
+        int protocol() const { return _protocol; }
+
+        /**
+         *  The address for the connect() call
+         *  @return struct sockaddr *
+         */
+        const struct sockaddr *address() const { return (const struct sockaddr *)&_address; }
+
+        /**
+         *  Size of the address
+         *  @return socklen_t
+         */
+        socklen_t size() const { return _size; }
+    };
+
+    /**
+     *  Type for the list of resolved addresses
+     *  @var std::vector<Record>
+     */
+    using Records = std::vector<Record>;
+
+private:
+    /**
+     *  A lookup that is in progress, shared by all threads that wait for it
+     */
+    struct Pending
+    {
+        /**
+         *  Is the lookup complete?
+         *  @var bool
+         */
+        bool done = false;
+
+        /**
+         *  The result of the lookup
+         *  @var Records
+         */
+        Records records;
+
+        /**
+         *  Error message in case the lookup failed
+         *  @var std::string
+         */
+        std::string error;
+    };
+
+    /**
+     *  Cached data for a single hostname and port
+     */
+    struct Entry
+    {
+        /**
+         *  The resolved addresses
+         *  @var Records
+         */
+        Records records;
+
+        /**
+         *  Until when are the records valid?
+         *  @var std::chrono::steady_clock::time_point
+         */
+        std::chrono::steady_clock::time_point expires;
+
+        /**
+         *  The lookup that is in progress (if any)
+         *  @var std::shared_ptr<Pending>
+         */
+        std::shared_ptr<Pending> pending;
+    };
+
+    /**
+     *  Mutex to protect all members
+     *  @var std::mutex
+     */
+    std::mutex _mutex;
+
+    /**
+     *  Condition variable that is notified when a lookup completes
+     *  @var std::condition_variable
+     */
+    std::condition_variable _condition;
+
+    /**
+     *  The cached entries, indexed by "hostname:port"
+     *  @var std::unordered_map<std::string,Entry>
+     */
+    std::unordered_map<std::string,Entry> _entries;
+
+    /**
+     *  The addresses to which the last connection succeeded, also indexed by "hostname:port"
+     *  @var std::unordered_map<std::string,Record>
+     */
+    std::unordered_map<std::string,Record> _preferred;
+
+    /**
+     *  Number of seconds that a lookup remains valid
+     *  @var uint32_t
+     */
+    uint32_t _ttl = 60;
+
+    /**
+     *  Construct the key for a hostname and port
+     *  @param  hostname
+     *  @param  port
+     *  @return std::string
+     */
+    static std::string key(const std::string &hostname, uint16_t port)
+    {
+        // combine the two
+        return hostname + ":" + std::to_string(port);
+    }
+
+    /**
+     *  Move the preferred address (if any) to the front of the list
+     *  This method must be called while holding the lock
+     *  @param  key         the cache key
+     *  @param  records     the records to re-order
+     *  @return Records
+     */
+    Records prefer(const std::string &key, Records records) const
+    {
+        // do we have a preferred address?
+        auto iter = _preferred.find(key);
+        if (iter == _preferred.end()) return records;
+
+        // look it up in the list of records
+        auto found = std::find(records.begin(), records.end(), iter->second);
+
+        // move it to the front (keeping the order of the others intact)
+        if (found != records.end()) std::rotate(records.begin(), found, found + 1);
+
+        // done
+        return records;
+    }
+
+    /**
+     *  Private constructor, there is only one instance
+     */
+    DnsCache() = default;
+
+public:
+    /**
+     *  The one and only instance
+     *  @return DnsCache
+     */
+    static DnsCache &instance()
+    {
+        // construct on first use
+        static DnsCache cache;
+
+        // expose it
+        return cache;
+    }
+
+    /**
+     *  Change the time-to-live of the cached lookups, this also empties the cache
+     *  @param  seconds     new time-to-live, zero to turn off caching
+     */
+    void ttl(uint32_t seconds)
+    {
+        // lock the cache
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // store the setting
+        _ttl = seconds;
+
+        // forget everything that we have (lookups that are in progress are not removed,
+        // because other threads are waiting for them)
+        for (auto iter = _entries.begin(); iter != _entries.end(); )
+        {
+            // keep the in-progress lookups
+            if (iter->second.pending) (iter++)->second.records.clear();
+            else iter = _entries.erase(iter);
+        }
+
+        // the preferred addresses are forgotten too
+        _preferred.clear();
+    }
+
+    /**
+     *  Resolve a hostname, this is a blocking call that should be made from
+     *  the resolver thread. If the hostname is already being resolved by an
+     *  other thread, this method waits for the result of that lookup.
+     *  @param  hostname
+     *  @param  port
+     *  @return Records
+     *  @throws std::runtime_error
+     */
+    Records resolve(const std::string &hostname, uint16_t port)
+    {
+        // construct the key
+        auto index = key(hostname, port);
+
+        // lock the cache
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        // the lookup that is already in progress, or that we're going to start ourselves
+        auto &entry = _entries[index];
+
+        // do we have valid records? then we can use them
+        if (!entry.records.empty() && std::chrono::steady_clock::now() < entry.expires) return prefer(index, entry.records);
+
+        // is an other thread already doing the lookup?
+        if (entry.pending)
+        {
+            // take a reference to the lookup (the entry could be removed while we wait)
+            auto pending = entry.pending;
+
+            // wait for the other thread to complete
+            _condition.wait(lock, [pending]() { return pending->done; });
+
+            // report the failure of the other thread as our own
+            if (pending->records.empty()) throw std::runtime_error(pending->error);
+
+            // use the result of the other thread
+            return prefer(index, pending->records);
+        }
+
+        // we're going to do the lookup ourselves
+        auto pending = std::make_shared<Pending>();
+
+        // register it so that other threads can find it
+        entry.pending = pending;
+
+        // the lookup is done without holding the lock
+        lock.unlock();
+
+        // prevent exceptions
+        try
+        {
+            // do the actual lookup
+            AddressInfo addresses(hostname.data(), port);
+
+            // copy the addresses
+            for (size_t i = 0; i < addresses.size(); ++i) pending->records.emplace_back(addresses[i]);
+        }
+        catch (const std::runtime_error &error)
+        {
+            // remember the error for the threads that are waiting
+            pending->error = error.what();
+        }
+
+        // lock the cache again (the entry might have been removed in the meantime)
+        lock.lock();
+
+        // the lookup is complete
+        pending->done = true;
+
+        // store the result in the cache
+        auto &result = _entries[index];
+        result.pending = nullptr;
+        result.records = _ttl > 0 ? pending->records : Records();
+        result.expires = std::chrono::steady_clock::now() + std::chrono::seconds(_ttl);
+
+        // wake up the threads that are waiting for us
+        _condition.notify_all();
+
+        // was there an error?
+        if (pending->records.empty()) throw std::runtime_error(pending->error.empty() ? "no addresses found" : pending->error);
+
+        // done
+        return prefer(index, pending->records);
+    }
+
+    /**
+     *  Remember the address to which a connection was successfully established,
+     *  so that it is tried first on the next lookup
+     *  @param  hostname
+     *  @param  port
+     *  @param  record
+     */
+    void succeeded(const std::string &hostname, uint16_t port, const Record &record)
+    {
+        // lock the cache
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // store the address (it can not be assigned, so we remove the old one first)
+        auto index = key(hostname, port);
+        _preferred.erase(index);
+        _preferred.emplace(index, record);
+    }
+
+    /**
+     *  Report that a connection could not be made to any of the resolved
+     *  addresses, the entry is then removed so that the next attempt does
+     *  a fresh lookup
+     *  @param  hostname
+     *  @param  port
+     */
+    void failed(const std::string &hostname, uint16_t port)
+    {
+        // lock the cache
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // construct the key
+        auto index = key(hostname, port);
+
+        // the preferred address apparently is no longer valid
+        _preferred.erase(index);
+
+        // look up the entry
+        auto iter = _entries.find(index);
+        if (iter == _entries.end()) return;
+
+        // lookups that are in progress must be kept
+        if (iter->second.pending) iter->second.records.clear();
+        else _entries.erase(iter);
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
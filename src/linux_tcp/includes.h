@@ -21,6 +21,7 @@
 
 // mid level includes
 #include "amqpcpp/linux_tcp/tcpparent.h"
+#include "amqpcpp/linux_tcp/backoff.h"
 #include "amqpcpp/linux_tcp/tcphandler.h"
 #include "amqpcpp/linux_tcp/tcpconnection.h"
 
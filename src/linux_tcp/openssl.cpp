@@ -327,6 +327,158 @@ long SSL_CTX_ctrl(SSL_CTX *ctx, int cmd, long larg, void *parg)
     return func(ctx, cmd, larg, parg);
 }
 
+/**
+ *  Get the BIO that is used for writing
+ *  @param  ssl     ssl structure
+ *  @return BIO*
+ */
+BIO *SSL_get_wbio(const SSL *ssl)
+{
+    // create a function
+    static Function<decltype(::SSL_get_wbio)> func(handle, "SSL_get_wbio");
+    
+    // call the openssl function
+    return func(ssl);
+}
+
+/**
+ *  Internal handling function for a BIO
+ *  @param  bio     the BIO
+ *  @param  cmd     command
+ *  @param  larg    first arg
+ *  @param  parg    second arg
+ *  @return long
+ */
+long BIO_ctrl(BIO *bio, int cmd, long larg, void *parg)
+{
+    // create a function
+    static Function<decltype(::BIO_ctrl)> func(handle, "BIO_ctrl");
+    
+    // call the openssl function
+    return func(bio, cmd, larg, parg);
+}
+
+/**
+ *  Get the context that was used to create a SSL structure
+ *  @param  ssl     ssl structure
+ *  @return SSL_CTX*
+ */
+SSL_CTX *SSL_get_SSL_CTX(const SSL *ssl)
+{
+    // create a function
+    static Function<decltype(::SSL_get_SSL_CTX)> func(handle, "SSL_get_SSL_CTX");
+    
+    // call the openssl function
+    return func(ssl);
+}
+
+/**
+ *  Set the session to resume
+ *  @param  ssl     ssl structure
+ *  @param  session the session
+ *  @return int
+ */
+int SSL_set_session(SSL *ssl, SSL_SESSION *session)
+{
+    // create a function
+    static Function<decltype(::SSL_set_session)> func(handle, "SSL_set_session");
+    
+    // call the openssl function
+    return func(ssl, session);
+}
+
+/**
+ *  Was the session resumed during the handshake?
+ *  @param  ssl     ssl structure
+ *  @return int
+ */
+int SSL_session_reused(const SSL *ssl)
+{
+    // create a function
+    static Function<decltype(::SSL_session_reused)> func(handle, "SSL_session_reused");
+    
+    // call the openssl function
+    return func(ssl);
+}
+
+/**
+ *  Free a session (this decrements the refcount)
+ *  @param  session the session
+ */
+void SSL_SESSION_free(SSL_SESSION *session)
+{
+    // create a function
+    static Function<decltype(::SSL_SESSION_free)> func(handle, "SSL_SESSION_free");
+    
+    // call the openssl function
+    return func(session);
+}
+
+/**
+ *  Install the callback that is called when a new session is created
+ *  @param  ctx     ssl context
+ *  @param  callback
+ */
+void SSL_CTX_sess_set_new_cb(SSL_CTX *ctx, int (*callback)(SSL *ssl, SSL_SESSION *session))
+{
+    // create a function
+    static Function<decltype(::SSL_CTX_sess_set_new_cb)> func(handle, "SSL_CTX_sess_set_new_cb");
+    
+    // call the openssl function
+    return func(ctx, callback);
+}
+
+/**
+ *  Store application data in a context
+ *  @param  ctx     ssl context
+ *  @param  idx     index of the data
+ *  @param  data    the data
+ *  @return int
+ */
+int SSL_CTX_set_ex_data(SSL_CTX *ctx, int idx, void *data)
+{
+    // create a function
+    static Function<decltype(::SSL_CTX_set_ex_data)> func(handle, "SSL_CTX_set_ex_data");
+    
+    // call the openssl function
+    return func(ctx, idx, data);
+}
+
+/**
+ *  Retrieve application data from a context
+ *  @param  ctx     ssl context
+ *  @param  idx     index of the data
+ *  @return void*
+ */
+void *SSL_CTX_get_ex_data(const SSL_CTX *ctx, int idx)
+{
+    // create a function
+    static Function<decltype(::SSL_CTX_get_ex_data)> func(handle, "SSL_CTX_get_ex_data");
+    
+    // call the openssl function
+    return func(ctx, idx);
+}
+
+/**
+ *  Allocate a new index for application data (SSL_CTX_get_ex_new_index() is
+ *  a macro that expands to this function)
+ *  @param  class_index the type of object to allocate the index for
+ *  @param  argl        argument passed to the callbacks
+ *  @param  argp        argument passed to the callbacks
+ *  @param  new_func    callback for new objects
+ *  @param  dup_func    callback for copied objects
+ *  @param  free_func   callback for destructed objects
+ *  @return int         the index, or -1 on failure
+ */
+int CRYPTO_get_ex_new_index(int class_index, long argl, void *argp, CRYPTO_EX_new *new_func, CRYPTO_EX_dup *dup_func, CRYPTO_EX_free *free_func)
+{
+    // create a function
+    static Function<decltype(::CRYPTO_get_ex_new_index)> func(handle, "CRYPTO_get_ex_new_index");
+    
+    // call the openssl function
+    return func(class_index, argl, argp, new_func, dup_func, free_func);
+}
+
 /**
  *  Clear the SSL error queue
  *  @return void
@@ -51,6 +51,16 @@ void     SSL_CTX_free(SSL_CTX *ctx);
 void     SSL_free(SSL *ssl);
 long     SSL_ctrl(SSL *ssl, int cmd, long larg, void *parg);
 long     SSL_CTX_ctrl(SSL_CTX *ctx, int cmd, long larg, void *parg);
+BIO     *SSL_get_wbio(const SSL *ssl);
+SSL_CTX *SSL_get_SSL_CTX(const SSL *ssl);
+int      SSL_set_session(SSL *ssl, SSL_SESSION *session);
+int      SSL_session_reused(const SSL *ssl);
+void     SSL_SESSION_free(SSL_SESSION *session);
+void     SSL_CTX_sess_set_new_cb(SSL_CTX *ctx, int (*callback)(SSL *ssl, SSL_SESSION *session));
+int      SSL_CTX_set_ex_data(SSL_CTX *ctx, int idx, void *data);
+void    *SSL_CTX_get_ex_data(const SSL_CTX *ctx, int idx);
+int      CRYPTO_get_ex_new_index(int class_index, long argl, void *argp, CRYPTO_EX_new *new_func, CRYPTO_EX_dup *dup_func, CRYPTO_EX_free *free_func);
+long     BIO_ctrl(BIO *bio, int cmd, long larg, void *parg);
 void     ERR_clear_error(void);
 
 /**
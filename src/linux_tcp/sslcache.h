@@ -0,0 +1,171 @@
+/**
+ *  SslCache.h
+ *
+ *  Process-wide cache of ssl contexts. All secure TcpConnection objects
+ *  of the same TcpHandler to the same hostname and port share a single
+ *  context, so that the context is set up only once (including loading
+ *  certificates and configuring the ciphers in TcpHandler::onContext()),
+ *  and so that reconnects (for example when many connections fail over
+ *  at the same time) can resume the previous session instead of doing a
+ *  full handshake. Connections of other handlers never see the context,
+ *  because they may use different certificates or verification rules.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include "sslcontext.h"
+#include <mutex>
+#include <functional>
+#include <tuple>
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class SslCache
+{
+private:
+    /**
+     *  An entry in the cache, with its own lock so that user space can
+     *  configure a new context without holding up connections to other servers
+     */
+    struct Entry
+    {
+        /**
+         *  Lock to protect the context
+         *  @var std::mutex
+         */
+        std::mutex mutex;
+        
+        /**
+         *  The context (it is owned by the connections that use it)
+         *  @var std::weak_ptr
+         */
+        std::weak_ptr<SslContext> context;
+    };
+    
+    /**
+     *  The key of an entry: the handler, hostname and port
+     *  @var std::tuple
+     */
+    using Key = std::tuple<const TcpHandler *,std::string,uint16_t>;
+
+    /**
+     *  Lock to protect the entries
+     *  @var std::mutex
+     */
+    std::mutex _mutex;
+
+    /**
+     *  The entries, indexed by handler, hostname and port
+     *  @var std::map
+     */
+    std::map<Key,std::shared_ptr<Entry>> _entries;
+
+
+    /**
+     *  Private constructor, there is only one instance
+     */
+    SslCache() = default;
+
+    /**
+     *  Get the entry for a handler, hostname and port
+     *  @param  handler
+     *  @param  hostname
+     *  @param  port
+     *  @return std::shared_ptr<Entry>
+     */
+    std::shared_ptr<Entry> entry(const TcpHandler *handler, const std::string &hostname, uint16_t port)
+    {
+        // the entries are shared between threads
+        std::lock_guard<std::mutex> lock(_mutex);
+        
+        // forget the entries that are no longer used by any connection (entries are
+        // only handed out while holding the lock, so no other thread can pick them up)
+        for (auto iter = _entries.begin(); iter != _entries.end(); )
+        {
+            // check if it is still in use
+            if (iter->second.use_count() == 1 && iter->second->context.expired()) iter = _entries.erase(iter);
+            else ++iter;
+        }
+        
+        // look up the entry
+        auto &entry = _entries[Key(handler, hostname, port)];
+        
+        // construct it if it does not yet exist
+        if (!entry) entry = std::make_shared<Entry>();
+        
+        // expose the entry
+        return entry;
+    }
+
+public:
+    /**
+     *  The one and only instance
+     *  @return SslCache
+     */
+    static SslCache &instance()
+    {
+        // the cache is constructed on first use
+        static SslCache cache;
+
+        // expose it
+        return cache;
+    }
+
+    /**
+     *  Get the context for a handler, hostname and port. If it does not yet exist,
+     *  it is constructed and passed to the initialize function, which returns
+     *  false if the context should not be used
+     *  @param  handler     the handler of the connection
+     *  @param  hostname
+     *  @param  port
+     *  @param  initialize  function to configure a new context
+     *  @return std::shared_ptr<SslContext>     nullptr if the context was rejected
+     *  @throws std::runtime_error
+     */
+    std::shared_ptr<SslContext> context(const TcpHandler *handler, const std::string &hostname, uint16_t port, const std::function<bool(SSL_CTX *)> &initialize)
+    {
+        // find the entry (the global lock is released after this call)
+        auto entry = this->entry(handler, hostname, port);
+
+        // lock the entry, so that other connections do not use the context before it has been initialized
+        std::lock_guard<std::mutex> lock(entry->mutex);
+
+        // the context could already be in use by other connections
+        auto context = entry->context.lock();
+
+        // if it already exists we can use it right away
+        if (context) return context;
+
+        // construct a new context
+        context = std::make_shared<SslContext>(OpenSSL::TLS_client_method());
+
+        // let it be configured, and only store it if that worked out
+        if (!initialize(*context)) return nullptr;
+
+        // store it for other connections
+        entry->context = context;
+        
+        // expose the context
+        return context;
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
@@ -72,6 +72,54 @@ private:
      */
     size_t _reallocate = 0;
     
+    /**
+     *  Is the encryption of outgoing data done by the kernel (kTLS)?
+     *  @var bool
+     */
+    bool _offloaded;
+
+    /**
+     *  Was reading paused? And was there still data to process when reading was resumed?
+     *  @var bool
+     */
+    bool _paused = false;
+    bool _backlog = false;
+
+    /**
+     *  Are there body frames to produce when the outgoing buffer is empty?
+     *  @var bool
+     */
+    bool _producing = false;
+    
+
+    /**
+     *  Check if the kernel encrypts outgoing data, which is the case if kTLS was
+     *  enabled (see TcpHandler::onSecuring()) and supported by kernel and openssl
+     *  @param  ssl         The SSL structure
+     *  @return bool
+     */
+    static bool offloaded(SSL *ssl)
+    {
+#ifdef BIO_CTRL_GET_KTLS_SEND
+        // ask the bio that is used for writing
+        return OpenSSL::BIO_ctrl(OpenSSL::SSL_get_wbio(ssl), BIO_CTRL_GET_KTLS_SEND, 0, nullptr) > 0;
+#else
+        // openssl does not support kernel tls
+        (void) ssl;
+        return false;
+#endif
+    }
+
+    /**
+     *  The events that should be monitored, we do not check for readability
+     *  when reading is paused
+     *  @param  events
+     *  @return int
+     */
+    int events(int events) const
+    {
+        return _paused ? events & ~readable : events;
+    }
 
     /**
      *  Proceed with the next operation after the previous operation was
@@ -80,11 +128,12 @@ private:
      */
     TcpState *proceed()
     {
-        // if we still have an outgoing buffer we want to send out data
-        if (_out)
+        // if we still have an outgoing buffer we want to send out data (or if there is
+        // data left to process or to produce, then we want the event loop to call us right away)
+        if (_out || _backlog || _producing)
         {
             // let's wait until the socket becomes writable
-            _parent->onIdle(this, _socket, readable | writable);
+            _parent->onIdle(this, _socket, events(readable | writable));
         }
         else if (_closed)
         {
@@ -94,7 +143,7 @@ private:
         else
         {
             // let's wait until the socket becomes readable
-            _parent->onIdle(this, _socket, readable);
+            _parent->onIdle(this, _socket, events(readable));
         }
         
         // done
@@ -145,7 +194,7 @@ private:
             _state = state;
             
             // wait until socket becomes writable again
-            _parent->onIdle(this, _socket, readable | writable);
+            _parent->onIdle(this, _socket, events(readable | writable));
 
             // we are done
             return true;
@@ -156,8 +205,8 @@ private:
             // we're ready for the next instruction from userspace
             _state = state_idle;
             
-            // if we still have an outgoing buffer we want to send out data, otherwise we just read
-            _parent->onIdle(this, _socket, _out ? readable | writable : readable);
+            // if we still have an outgoing buffer (or data to produce) we want to send out data, otherwise we just read
+            _parent->onIdle(this, _socket, events(_out || _producing ? readable | writable : readable));
 
             // nothing is wrong, we are done
             return true;
@@ -244,6 +293,9 @@ private:
      */
     TcpState *write(const Monitor &monitor)
     {
+        // if the kernel encrypts the data, we can write plain data to the socket
+        if (_offloaded) return flush(monitor);
+        
         // assume default state
         _state = state_idle;
         
@@ -264,10 +316,50 @@ private:
             // the operation failed, we may have to repeat our call
             return repeat(monitor, state_sending, error);
         }
-        while (_out && !isReadable());
+        while (_out && (_paused || !isReadable()));
         
         // proceed with the read operation or the event loop
-        return isReadable() ? receive(monitor) : proceed();
+        return !_paused && isReadable() ? receive(monitor) : proceed();
+    }
+
+    /**
+     *  Perform a write operation directly to the socket, which is possible if 
+     *  the kernel takes care of the encryption, so that all buffers can be passed
+     *  to the kernel with a single sendmsg() call, just like a regular connection
+     *  @param  monitor         object to check the existance of the connection object
+     *  @return TcpState*
+     */
+    TcpState *flush(const Monitor &monitor)
+    {
+        // assume default state
+        _state = state_idle;
+        
+        // write until the buffer is empty (unless there is data to read first)
+        do
+        {
+            // try to send more data from the outgoing buffer
+            auto result = _out.sendto(_socket);
+            
+            // leap out if the socket is not writable right now
+            if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) break;
+            
+            // the operation failed, the connection is lost
+            if (result <= 0) 
+            {
+                // we are now in an error state
+                _state = state_error;
+                
+                // report an error to user-space
+                _parent->onError(this, "connection lost");
+                
+                // the connection is unusable
+                return monitor.valid() ? new TcpClosed(this) : nullptr;
+            }
+        }
+        while (_out && (_paused || !isReadable()));
+        
+        // proceed with the read operation or the event loop
+        return !_paused && isReadable() ? receive(monitor) : proceed();
     }
 
     /**
@@ -277,6 +369,9 @@ private:
      */
     TcpState *receive(const Monitor &monitor)
     {
+        // all data that is available is going to be processed
+        _backlog = false;
+
         // we are going to check for errors after the openssl operations, so we make 
         // sure that the error queue is currently completely empty
         OpenSSL::ERR_clear_error();
@@ -299,13 +394,49 @@ private:
             // leap out if we moved to a different state
             if (nextstate != this) return nextstate;
         }
-        while (OpenSSL::SSL_pending(_ssl) > 0);
+        while (OpenSSL::SSL_pending(_ssl) > 0 && !_paused);
         
         // proceed with the write operation or the event loop
         return _out && isWritable() ? write(monitor) : proceed();
     }
 
-    
+    /**
+     *  Produce the next body frames, now that the outgoing buffer is empty
+     *  @param  monitor         object to check the existance of the connection object
+     *  @return TcpState
+     */
+    TcpState *produce(const Monitor &monitor)
+    {
+        // produce the frames (they are passed to our send() method)
+        _producing = !_closed && _parent->onProduce(this);
+
+        // the producers could have destructed us
+        if (!monitor.valid()) return nullptr;
+
+        // write the frames, or go back to the event loop
+        return _out ? write(monitor) : proceed();
+    }
+
+    /**
+     *  Process the data that was left behind when reading was paused
+     *  @param  monitor         object to check the existance of the connection object
+     *  @return TcpState
+     */
+    TcpState *backlog(const Monitor &monitor)
+    {
+        // the backlog is going to be processed
+        _backlog = false;
+
+        // process the data that was already read
+        auto *nextstate = _in.size() > 0 ? parse(monitor, _in.size()) : this;
+
+        // leap out if we moved to a different state
+        if (nextstate != this) return nextstate;
+
+        // openssl may have decrypted more data than we have read
+        return !_paused && OpenSSL::SSL_pending(_ssl) > 0 ? receive(monitor) : proceed();
+    }
+
 public:
     /**
      *  Constructor
@@ -318,10 +449,17 @@ public:
         _ssl(std::move(ssl)),
         _out(std::move(buffer)),
         _in(4096),
-        _state(_out ? state_sending : state_idle)
+        _state(_out ? state_sending : state_idle),
+        _offloaded(offloaded(_ssl))
     {
-        // tell the handler to monitor the socket if there is an out
-        _parent->onIdle(this, _socket, _state == state_sending ? readable | writable : readable); 
+        // messages may have been published from a producer before we were connected
+        _producing = _parent->producing();
+        
+        // the connection may have been paused before we were connected
+        _paused = _parent->paused();
+        
+        // tell the handler to monitor the socket if there is an out (or something to produce)
+        _parent->onIdle(this, _socket, events(_state == state_sending || _producing ? readable | writable : readable)); 
     }
     
     /**
@@ -356,11 +494,17 @@ public:
         // if we are in an error state, we close the tcp connection
         if (_state == state_error) return new TcpClosed(this);
         
-        // if the socket is readable, we are going to receive data
-        if (flags & readable) return receive(monitor);
+        // data that was left behind when reading was paused should be processed first
+        if (_backlog) return backlog(monitor);
+
+        // if the socket is readable, we are going to receive data (an event could still come in after we were paused)
+        if ((flags & readable) && !_paused) return receive(monitor);
         
         // socket is not readable (so it must be writable), do we have data to write?
         if (_out) return write(monitor);
+
+        // the buffer is empty, so the next body frames can be produced
+        if (_producing) return produce(monitor);
         
         // the only scenario in which we can end up here is the socket should be
         // closed, but instead of moving to the shutdown-state right, we call proceed()
@@ -377,33 +521,20 @@ public:
     {
         // do nothing if already busy closing
         if (_closed) return;
-        
-        // if we're not idle, we can just add bytes to the buffer and we're done
-        if (_state != state_idle) return _out.add(buffer, size);
 
-        // clear ssl-level error
-        OpenSSL::ERR_clear_error();
-
-        // get the result
-        int result = OpenSSL::SSL_write(_ssl, buffer, size);  
-
-        // if the result is larger than zero, we are successful
-        if (result > 0) return; 
-            
-        // check for error
-        auto error = OpenSSL::SSL_get_error(_ssl, result);
-
-        // put the data in the outgoing buffer
+        // was there already data waiting to be sent?
+        bool waiting = _out;
+        
+        // we do not write right away, because every SSL_write() call produces at least 
+        // one record, and frames are usually much smaller than that: the data is buffered
+        // and combined with all other frames that are sent before the socket is writable
         _out.add(buffer, size);
 
-        // the operation failed, we may have to repeat our call. this may detect that
-        // ssl is in an error state, however that is ok because it will set an internal 
-        // state to the error state so that on the next calls to state-changing objects, 
-        // the tcp socket will be torn down
-        if (repeat(state_sending, error)) return;
+        // if we're not idle, or already waiting for the socket, we're done
+        if (_state != state_idle || waiting) return;
 
-        // the repeat call failed, so we are going to find out with a readable file descriptor
-        _parent->onIdle(this, _socket, readable);
+        // let's wait until the socket becomes writable
+        _parent->onIdle(this, _socket, events(readable | writable));
     }
 
     /**
@@ -418,7 +549,61 @@ public:
         if (_state != state_idle) return;
         
         // let's wait until the socket becomes writable (because then we can start the shutdown)
-        _parent->onIdle(this, _socket, readable | writable);
+        _parent->onIdle(this, _socket, events(readable | writable));
+    }
+
+    /**
+     *  Stop reading from the socket
+     */
+    virtual void pause() override
+    {
+        // remember that we are paused
+        _paused = true;
+
+        // if an operation is in progress, the monitored events are updated when it is done
+        if (_state != state_idle) return;
+
+        // no longer check for readability
+        _parent->onIdle(this, _socket, events(_out || _producing ? readable | writable : readable));
+    }
+
+    /**
+     *  Start reading from the socket again
+     */
+    virtual void resume() override
+    {
+        // no longer paused
+        _paused = false;
+
+        // data that was already read (by us or by openssl) can not be processed right away,
+        // because we could be called from anywhere, so we wait for the event loop to report
+        // writability (the buffer is empty while it is being parsed, the parser then just continues)
+        _backlog = _in.size() > 0 || OpenSSL::SSL_pending(_ssl) > 0;
+
+        // if an operation is in progress, the monitored events are updated when it is done
+        if (_state != state_idle) return;
+
+        // monitor the socket again
+        _parent->onIdle(this, _socket, _out || _backlog || _producing ? readable | writable : readable);
+    }
+
+    /**
+     *  Start producing body frames whenever the outgoing buffer is empty
+     *  @return bool
+     */
+    virtual bool produce() override
+    {
+        // remember that there are frames to produce
+        _producing = true;
+
+        // if an operation is in progress, the monitored events are updated when it is done
+        if (_state != state_idle) return true;
+
+        // let's wait until the socket becomes writable
+        _parent->onIdle(this, _socket, events(readable | writable));
+
+        // the frames are produced from the event loop
+        return true;
     }
 
     /**
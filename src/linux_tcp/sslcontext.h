@@ -1,10 +1,12 @@
 /**
  *  SslContext.h
  *
- *  Class to create and maintain a tcp ssl context
+ *  Class to create and maintain a tcp ssl context. The context also
+ *  remembers the most recent session that the server handed out, so
+ *  that the next connection that uses the context can resume it.
  *
  *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
- *  @copyright 2018 Copernica BV
+ *  @copyright 2018 - 2020 Copernica BV
  */
 
 /**
@@ -12,6 +14,11 @@
  */
 #pragma once
 
+/**
+ *  Dependencies
+ */
+#include <mutex>
+
 /**
  *  Begin of namespace
  */
@@ -28,6 +35,61 @@ private:
      *  @var SSL_CTX
      */
     SSL_CTX *_ctx;
+    
+    /**
+     *  Lock to protect the session (the context is shared between threads)
+     *  @var std::mutex
+     */
+    std::mutex _mutex;
+    
+    /**
+     *  The most recent session
+     *  @var SSL_SESSION
+     */
+    SSL_SESSION *_session = nullptr;
+    
+    
+    /**
+     *  The private index under which the context object is stored in the
+     *  SSL_CTX (index 0 is used by SSL_CTX_set_app_data(), so it belongs to
+     *  user space that may configure the context in onContext())
+     *  @return int
+     */
+    static int index()
+    {
+        // allocate the index only once
+        static int index = OpenSSL::SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+        
+        // expose the index
+        return index;
+    }
+    
+    /**
+     *  Callback that is called by openssl when the server hands out a new session
+     *  @param  ssl         the connection that received the session
+     *  @param  session     the new session
+     *  @return int         1 when we hold on to the session
+     */
+    static int onSession(SSL *ssl, SSL_SESSION *session)
+    {
+        // find the context object
+        auto *context = (SslContext *)OpenSSL::SSL_CTX_get_ex_data(OpenSSL::SSL_get_SSL_CTX(ssl), index());
+        
+        // if the object is not there, we do not hold on to the session
+        if (context == nullptr) return 0;
+        
+        // the session is going to be replaced
+        std::lock_guard<std::mutex> lock(context->_mutex);
+        
+        // forget the previous session
+        if (context->_session) OpenSSL::SSL_SESSION_free(context->_session);
+        
+        // store the new one (we now own the reference)
+        context->_session = session;
+        
+        // tell openssl that we hold on to the session
+        return 1;
+    }
 
 public:
     /**
@@ -43,6 +105,15 @@ public:
         // set the context to accept a moving write buffer. note that SSL_CTX_set_mode is a macro
         // that expands to SSL_CTX_ctrl, so that is the real function that is used
         OpenSSL::SSL_CTX_set_mode(_ctx, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+        
+        // we keep track of the sessions ourselves (openssl has no client side lookup)
+        OpenSSL::SSL_CTX_set_session_cache_mode(_ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        
+        // without a private index we cannot find this object back, and sessions are not resumed
+        if (index() < 0 || OpenSSL::SSL_CTX_set_ex_data(_ctx, index(), this) != 1) return;
+        
+        // we want to be notified about new sessions
+        OpenSSL::SSL_CTX_sess_set_new_cb(_ctx, &SslContext::onSession);
     }
     
     /**
@@ -57,6 +128,9 @@ public:
      */
     virtual ~SslContext()
     {
+        // forget the session
+        if (_session) OpenSSL::SSL_SESSION_free(_session);
+        
         // free resource (this updates the refcount -1, and may destruct it)
         OpenSSL::SSL_CTX_free(_ctx);
     }
@@ -66,6 +140,22 @@ public:
      *  @return SSL_CTX *
      */
     operator SSL_CTX * () { return _ctx; }
+    
+    /**
+     *  Prepare a connection to resume the most recent session (if there is one)
+     *  @param  ssl         the connection that is about to start the handshake
+     */
+    void resume(SSL *ssl)
+    {
+        // the session could be replaced by an other thread
+        std::lock_guard<std::mutex> lock(_mutex);
+        
+        // nothing to resume if no session was handed out yet
+        if (_session == nullptr) return;
+        
+        // install the session (this increments its refcount)
+        OpenSSL::SSL_set_session(ssl, _session);
+    }
 };
 
 /**
@@ -19,7 +19,7 @@
 #include "sslconnected.h"
 #include "poll.h"
 #include "sslwrapper.h"
-#include "sslcontext.h"
+#include "sslcache.h"
 
 /**
  *  Set up namespace
@@ -33,7 +33,15 @@ class SslHandshake : public TcpExtState
 {
 private:
     /**
-     *  SSL structure
+     *  The hostname and port that we are connected to
+     *  @var std::string
+     *  @var uint16_t
+     */
+    std::string _hostname;
+    uint16_t _port;
+
+    /**
+     *  SSL structure (constructed right before the handshake starts)
      *  @var SslWrapper
      */
     SslWrapper _ssl;
@@ -44,6 +52,12 @@ private:
      */
     TcpOutBuffer _out;
     
+    /**
+     *  Was user space already given the opportunity to configure the connection?
+     *  @var bool
+     */
+    bool _prepared = false;
+    
     
     /**
      *  Report a new state
@@ -71,6 +85,91 @@ private:
         return new SslShutdown(this, std::move(_ssl));
     }
     
+    /**
+     *  Construct the SSL structure
+     *  @param  context     The context to use
+     *  @throws std::runtime_error
+     */
+    void setup(const std::shared_ptr<SslContext> &context)
+    {
+        // construct the structure
+        _ssl = SslWrapper(context);
+        
+        // we will be using the ssl context as a client
+        OpenSSL::SSL_set_connect_state(_ssl);
+        
+        // associate domain name with the connection
+        OpenSSL::SSL_ctrl(_ssl, SSL_CTRL_SET_TLSEXT_HOSTNAME, TLSEXT_NAMETYPE_host_name, (void *)_hostname.data());
+
+        // the output buffer combines frames into records, and may write them partially or move them around
+        OpenSSL::SSL_ctrl(_ssl, SSL_CTRL_MODE, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER, nullptr);
+        
+        // associate the ssl context with the socket filedescriptor
+        if (OpenSSL::SSL_set_fd(_ssl, _socket) == 0) throw std::runtime_error("failed to associate filedescriptor with ssl socket");
+        
+        // try to resume the previous session to the same server (to skip the expensive key exchange)
+        context->resume(_ssl);
+    }
+    
+    /**
+     *  Let user space configure the context and the connection before the handshake starts
+     *  @param  monitor
+     *  @return TcpState*
+     */
+    TcpState *prepare(const Monitor &monitor)
+    {
+        // this only has to happen once
+        _prepared = true;
+        
+        // the context that is shared with the other connections of the same handler to the same server
+        std::shared_ptr<SslContext> context;
+        
+        // prevent exceptions
+        try
+        {
+            // get the context, user space may configure it if it is new
+            context = _parent->onContext(this, _hostname, _port);
+        }
+        catch (const std::runtime_error &)
+        {
+            // the context could not be constructed
+            return reportError(monitor);
+        }
+        
+        // leap out if the user space function destructed the object
+        if (!monitor.valid()) return nullptr;
+        
+        // prevent exceptions
+        try
+        {
+            // construct the ssl structure (if the context was not rejected)
+            if (context) setup(context);
+        }
+        catch (const std::runtime_error &)
+        {
+            // the structure could not be constructed
+            return reportError(monitor);
+        }
+        
+        // check if the handler allows the connection
+        bool allowed = context && _parent->onSecuring(this, _ssl);
+        
+        // leap out if the user space function destructed the object
+        if (!monitor.valid()) return nullptr;
+        
+        // if connection is allowed, we can go on with the handshake
+        if (allowed) return this;
+        
+        // report that the connection is broken
+        _parent->onError(this, "TLS connection has been rejected");
+        
+        // the onError method could have destructed this object
+        if (!monitor.valid()) return nullptr;
+        
+        // close the tcp connection (there is nothing to shutdown yet)
+        return new TcpClosed(this);
+    }
+    
     /**
      *  Helper method to report an error
      *  @param  monitor
@@ -107,23 +206,18 @@ public:
      *  Constructor
      *  @param  state       Earlier state
      *  @param  hostname    The hostname to connect to
-     *  @param  context     SSL context
+     *  @param  port        The port to connect to
      *  @param  buffer      The buffer that was already built
-     *  @throws std::runtime_error
      */
-    SslHandshake(TcpExtState *state, const std::string &hostname, TcpOutBuffer &&buffer) : 
+    SslHandshake(TcpExtState *state, const std::string &hostname, uint16_t port, TcpOutBuffer &&buffer) : 
         TcpExtState(state),
-        _ssl(SslContext(OpenSSL::TLS_client_method())),
+        _hostname(hostname),
+        _port(port),
         _out(std::move(buffer))
     {
-        // we will be using the ssl context as a client
-        OpenSSL::SSL_set_connect_state(_ssl);
-        
-        // associate domain name with the connection
-        OpenSSL::SSL_ctrl(_ssl, SSL_CTRL_SET_TLSEXT_HOSTNAME, TLSEXT_NAMETYPE_host_name, (void *)hostname.data());
-        
-        // associate the ssl context with the socket filedescriptor
-        if (OpenSSL::SSL_set_fd(_ssl, _socket) == 0) throw std::runtime_error("failed to associate filedescriptor with ssl socket");
+        // the ssl structure is constructed when the socket is writable, because
+        // user space may want to configure it, and may destruct the connection
+        // while doing that, which is not possible inside this constructor
         
         // we are going to wait until the socket becomes writable before we start the handshake
         _parent->onIdle(this, _socket, writable);
@@ -151,6 +245,16 @@ public:
     {
         // must be the socket
         if (fd != _socket) return this;
+        
+        // user space should first get the opportunity to configure the connection
+        if (!_prepared)
+        {
+            // let user space do its thing
+            auto *state = prepare(monitor);
+            
+            // leap out if the connection was rejected
+            if (state != this) return state;
+        }
 
         // we are going to check for errors after the openssl operations, so we make 
         // sure that the error queue is currently completely empty
@@ -183,6 +287,17 @@ public:
         // the handshake is still busy, outgoing data must be cached
         _out.add(buffer, size); 
     }
+
+    /**
+     *  Start producing body frames whenever the outgoing buffer is empty
+     *  @return bool
+     */
+    virtual bool produce() override
+    {
+        // the frames should not pile up in the buffer before we are connected,
+        // the connected state picks up the producers when it is constructed
+        return true;
+    }
 };
     
 /**
@@ -12,6 +12,11 @@
  */
 #pragma once
 
+/**
+ *  Dependencies
+ */
+#include "sslcontext.h"
+
 /**
  *  Begin of namespace
  */
@@ -29,13 +34,23 @@ private:
      */
     SSL *_ssl;
     
+    /**
+     *  The context, which is shared with other connections
+     *  @var std::shared_ptr<SslContext>
+     */
+    std::shared_ptr<SslContext> _context;
+    
 public:
+    /**
+     *  Constructor for an empty object
+     */
+    SslWrapper() : _ssl(nullptr) {}
+    
     /**
      *  Constructor
-     *  @param  ctx
-     *  @param  file
+     *  @param  context
      */
-    SslWrapper(SSL_CTX *ctx) : _ssl(OpenSSL::SSL_new(ctx)) 
+    SslWrapper(const std::shared_ptr<SslContext> &context) : _ssl(OpenSSL::SSL_new(*context)), _context(context)
     {
         // report error
         if (_ssl == nullptr) throw std::runtime_error("failed to construct ssl structure");
@@ -54,10 +69,34 @@ public:
      *  Move constructor
      *  @param  that
      */
-    SslWrapper(SslWrapper &&that) : _ssl(that._ssl)
+    SslWrapper(SslWrapper &&that) : _ssl(that._ssl), _context(std::move(that._context))
+    {
+        // invalidate other object
+        that._ssl = nullptr;
+    }
+    
+    /**
+     *  Move assignment
+     *  @param  that
+     *  @return SslWrapper
+     */
+    SslWrapper &operator=(SslWrapper &&that)
     {
+        // skip self assignment
+        if (this == &that) return *this;
+        
+        // free the current object
+        if (_ssl) OpenSSL::SSL_free(_ssl);
+        
+        // take over the other object
+        _ssl = that._ssl;
+        _context = std::move(that._context);
+        
         // invalidate other object
         that._ssl = nullptr;
+        
+        // allow chaining
+        return *this;
     }
     
     /**
@@ -77,6 +116,7 @@ public:
      *  @return SSL *
      */
     operator SSL * () const { return _ssl; }
+    
 };
 
 /**
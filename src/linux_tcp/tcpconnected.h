@@ -56,6 +56,20 @@ private:
      */
     bool _closed = false;
 
+    /**
+     *  Was reading paused? And was there still data in the incoming buffer
+     *  when reading was resumed?
+     *  @var bool
+     */
+    bool _paused = false;
+    bool _backlog = false;
+
+    /**
+     *  Are there body frames to produce when the outgoing buffer is empty?
+     *  @var bool
+     */
+    bool _producing = false;
+
     
     /**
      *  Helper method to report an error
@@ -78,6 +92,54 @@ private:
         return true;
     }
     
+    /**
+     *  The events that should be monitored
+     *  @return int
+     */
+    int events() const
+    {
+        // we check for readability unless we are paused, and for writability if there
+        // is data to send or to produce (or data to process that is already in the
+        // incoming buffer, so that the event loop calls us right away)
+        return (_paused ? 0 : readable) | (_out || _backlog || _producing ? writable : 0);
+    }
+
+    /**
+     *  Parse the data in the incoming buffer
+     *  @param  monitor     Monitor to check if the object is still alive
+     *  @return TcpState*
+     */
+    TcpState *parse(const Monitor &monitor)
+    {
+        // the backlog is going to be processed
+        _backlog = false;
+
+        // we need a local copy of the buffer - because it is possible that "this"
+        // object gets destructed halfway through the call to the parse() method
+        TcpInBuffer buffer(std::move(_in));
+        
+        // parse the buffer
+        auto processed = _parent->onReceived(this, buffer);
+
+        // "this" could be removed by now, check this
+        if (!monitor.valid()) return nullptr;
+        
+        // shrink buffer
+        buffer.shrink(processed);
+        
+        // restore the buffer as member
+        _in = std::move(buffer);
+        
+        // do we have to reallocate?
+        if (_reallocate) _in.reallocate(_reallocate); 
+        
+        // we can remove the reallocate instruction
+        _reallocate = 0;
+
+        // keep same object
+        return this;
+    }
+
     /**
      *  Construct the final state
      *  @param  monitor     Object that monitors whether connection still exists
@@ -104,8 +166,14 @@ public:
         // if there is already an output buffer, we have to send out that first
         if (_out) _out.sendto(_socket);
         
+        // messages may have been published from a producer before we were connected
+        _producing = _parent->producing();
+        
+        // the connection may have been paused before we were connected
+        _paused = _parent->paused();
+        
         // tell the handler to monitor the socket, if there is an out
-        _parent->onIdle(this, _socket, _out ? readable | writable : readable);
+        _parent->onIdle(this, _socket, events());
     }
     
     /**
@@ -145,13 +213,30 @@ public:
             
             // if we do not expect to send more data, we can close the connection for writing
             if (_closed) shutdown(_socket, SHUT_WR);
+
+            // the buffer is empty, so the next body frames can be produced
+            if (_producing)
+            {
+                // produce the frames (they are passed to our send() method)
+                _producing = !_closed && _parent->onProduce(this);
+
+                // the producers could have destructed us
+                if (!monitor.valid()) return nullptr;
+            }
             
+            // the data left behind when we were paused is processed below
+            bool backlog = _backlog;
+            _backlog = false;
+
             // check for readability (to find more data, or to be notified that connection is gone)
-            _parent->onIdle(this, _socket, readable);
+            _parent->onIdle(this, _socket, events());
+
+            // process the data that was left behind
+            if (backlog) return _paused ? this : parse(monitor);
         }
         
-        // should we check for readability too?
-        if (flags & readable)
+        // should we check for readability too? (an event could still come in after we were paused)
+        if ((flags & readable) && !_paused)
         {
             // read data from buffer
             ssize_t result = _in.receivefrom(_socket, _parent->expected());
@@ -159,27 +244,8 @@ public:
             // did we encounter end-of-file or are we in an error state?
             if (reportError(result)) return finalState(monitor);
             
-            // we need a local copy of the buffer - because it is possible that "this"
-            // object gets destructed halfway through the call to the parse() method
-            TcpInBuffer buffer(std::move(_in));
-            
             // parse the buffer
-            auto processed = _parent->onReceived(this, buffer);
-
-            // "this" could be removed by now, check this
-            if (!monitor.valid()) return nullptr;
-            
-            // shrink buffer
-            buffer.shrink(processed);
-            
-            // restore the buffer as member
-            _in = std::move(buffer);
-            
-            // do we have to reallocate?
-            if (_reallocate) _in.reallocate(_reallocate); 
-            
-            // we can remove the reallocate instruction
-            _reallocate = 0;
+            return parse(monitor);
         }
         
         // keep same object
@@ -205,6 +271,9 @@ public:
         // number of bytes sent
         size_t bytes = result < 0 ? 0 : result;
 
+        // trace the operation
+        if (bytes > 0) AMQP_CPP_TRACE(written, 0, bytes);
+
         // ok if all data was sent
         if (bytes >= size) return;
     
@@ -212,7 +281,7 @@ public:
         _out.add(buffer + bytes, size - bytes);
         
         // start monitoring the socket to find out when it is writable
-        _parent->onIdle(this, _socket, readable | writable);
+        _parent->onIdle(this, _socket, events());
     }
     
     /**
@@ -235,7 +304,53 @@ public:
         
         // we still monitor the socket for readability to see if our close call was
         // confirmed by the peer
-        _parent->onIdle(this, _socket, readable);
+        _parent->onIdle(this, _socket, events());
+    }
+
+    /**
+     *  Stop reading from the socket
+     */
+    virtual void pause() override
+    {
+        // remember that we are paused
+        _paused = true;
+
+        // no longer check for readability
+        _parent->onIdle(this, _socket, events());
+    }
+
+    /**
+     *  Start reading from the socket again
+     */
+    virtual void resume() override
+    {
+        // no longer paused
+        _paused = false;
+
+        // data that was already read can not be parsed right away, because we could be
+        // called from anywhere, so we wait for the event loop to report writability
+        // (the buffer is empty while it is being parsed, the parser then just continues)
+        _backlog = _in.size() > 0;
+
+        // monitor the socket again
+        _parent->onIdle(this, _socket, events());
+    }
+
+    /**
+     *  Start producing body frames whenever the outgoing buffer is empty
+     *  @return bool
+     */
+    virtual bool produce() override
+    {
+        // remember that there are frames to produce
+        _producing = true;
+
+        // the event loop tells us when the socket is writable (even when the
+        // buffer is empty, so that the first frames are produced right away)
+        _parent->onIdle(this, _socket, events());
+
+        // the frames are produced from the event loop
+        return true;
     }
 
     /**
@@ -33,6 +33,29 @@ TcpConnection::TcpConnection(TcpHandler *handler, const Address &address) :
     _handler->onAttached(this);
 }
 
+/**
+ *  Constructor for a recoverable connection
+ *  @param  handler         User implemented handler object
+ *  @param  addresses       The addresses to connect to
+ *  @param  backoff         The reconnect policy
+ */
+TcpConnection::TcpConnection(TcpHandler *handler, const Addresses &addresses, const Backoff &backoff) :
+    _handler(handler),
+    _state(new TcpResolver(this, addresses[0].hostname(), addresses[0].port(), addresses[0].secure())),
+    _connection(this, addresses[0].login(), addresses[0].vhost()),
+    _backoff(backoff),
+    _recover(true)
+{
+    // copy the addresses
+    for (size_t i = 0; i < addresses.size(); ++i) _addresses.push_back(addresses[i]);
+
+    // the channels should survive a lost connection
+    _connection.recoverable(true);
+
+    // tell the handler
+    _handler->onAttached(this);
+}
+
 /**
  *  Destructor
  */
@@ -101,20 +124,110 @@ void TcpConnection::process(int fd, int flags)
     // pass on the the state, that returns a new impl
     auto *newstate = _state->process(monitor, fd, flags);
 
+    // the outgoing buffer may have been flushed
+    if (newstate == oldstate)
+    {
+        // record its size
+        if (_connection.stats()) _connection.stats()->_outputBuffer.set(_state->queued());
+
+        // it may have drained to the low watermark (this could destruct us)
+        _connection.buffered(_state->queued());
+    }
+
     // if the state did not change, we do not have to update a member,
     // when the newstate is nullptr, the object is (being) destructed
     // and we do not have to do anything else either
     if (newstate == nullptr || newstate == oldstate) return;
 
+    // switch to the new state
+    replace(newstate);
+}
+
+/**
+ *  Replace the current state, and start a new attempt to connect if the
+ *  old state reported that the connection was lost
+ *  @param  state           the new state
+ */
+void TcpConnection::replace(TcpState *state)
+{
+    // the old state could report to user space, which could destruct us
+    Monitor monitor(this);
+
     // wrap the new state in a unique-ptr so that so that the old state
     // is not destructed before the new one is assigned
-    std::unique_ptr<TcpState> ptr(newstate);
+    std::unique_ptr<TcpState> ptr(state);
     
-    // swap the two pointers (this ensures that the last operation of this
-    // method is to destruct the old state, which possible results in calls
-    // to user-space and the destruction of "this"
+    // swap the two pointers (the old state is destructed right after, which 
+    // possibly results in calls to user-space and the destruction of "this")
     _state.swap(ptr);
 
+    // destruct the old state
+    ptr.reset();
+
+    // leap out if the object was destructed, or if no new attempt has to be made
+    if (!monitor.valid() || !_reconnect) return;
+
+    // the attempt is going to be started (unless the connection was closed in the meantime)
+    _reconnect = false;
+
+    // start the next attempt, or give up
+    if (_recover) reconnect(); else detach();
+}
+
+/**
+ *  Start a new attempt to connect to the next address
+ */
+void TcpConnection::reconnect()
+{
+    // move on to the next address
+    _current = (_current + 1) % _addresses.size();
+
+    // the address to connect to
+    const auto &address = _addresses[_current];
+
+    // start resolving (after a delay), the old state has no socket so nothing is reported
+    _state.reset(new TcpResolver(this, address.hostname(), address.port(), address.secure(), _backoff.delay(_attempts)));
+
+    // remember that the upcoming handshake is a recovery
+    _recovering = true;
+
+    // restart the amqp connection, the protocol header and channel-open frames are buffered by the resolver
+    _connection.recover(address.login(), address.vhost());
+}
+
+/**
+ *  Helper method that is called when no further events are going to be fired
+ *  for the current tcp connection, to find out if a new one should be set up
+ */
+void TcpConnection::detach()
+{
+    // monitor to check if "this" is destructed
+    Monitor monitor(this);
+
+    // is a new attempt allowed?
+    if (_recover && (_backoff.attempts() == 0 || _attempts < _backoff.attempts()))
+    {
+        // ask user-space whether we should make a new attempt
+        bool recover = _handler->onRecovering(this, ++_attempts);
+
+        // leap out if object was destructed
+        if (!monitor.valid()) return;
+
+        // the attempt is started as soon as the old state has been cleaned up
+        if (recover && _recover) { _reconnect = true; return; }
+    }
+
+    // the connection is not going to be recovered
+    _recover = _recovering = false;
+
+    // the suspended channels can now report their failure
+    _connection.recoverable(false);
+
+    // leap out if object was destructed
+    if (!monitor.valid() || _handler == nullptr) return;
+
+    // tell the handler that no further events will be fired
+    _handler->onDetached(this);
 }
 
 /**
@@ -123,8 +236,15 @@ void TcpConnection::process(int fd, int flags)
  */
 bool TcpConnection::close(bool immediate)
 {
+    // a closed connection is never recovered
+    _recover = false;
+
+    // channels that are waiting for the connection to be recovered are going to fail
+    _connection.recoverable(false);
+
     // if no immediate disconnect is needed, we can simply start the closing handshake
-    if (!immediate) return _connection.close();
+    // (but a recovery that did not yet complete is simply aborted)
+    if (!immediate && !_recovering) return _connection.close();
 
     // failing the connection could destruct "this"
     Monitor monitor(this);
@@ -148,6 +268,84 @@ bool TcpConnection::close(bool immediate)
     return true;
 }
 
+/**
+ *  Drop the TCP connection because the server no longer responds
+ *  @param  message         the error message to report
+ *  @return bool
+ */
+bool TcpConnection::fail(const char *message)
+{
+    // leap out if there is no socket to drop (not yet connected, or already closed)
+    if (_state->closed() || _state->fileno() < 0) return false;
+
+    // failing the connection could destruct "this"
+    Monitor monitor(this);
+
+    // pending operations fail (or the channels are suspended if the connection is recoverable)
+    bool failed = _connection.fail(message);
+
+    // stop if object was destructed
+    if (!monitor.valid()) return true;
+
+    // tell the handler
+    if (failed && _handler) _handler->onError(this, message);
+
+    // stop if object was destructed
+    if (!monitor.valid()) return true;
+
+    // the old state closes the socket and reports that the connection was lost,
+    // which starts a new attempt if the connection is recoverable
+    replace(new TcpClosed(this));
+
+    // done
+    return true;
+}
+
+/**
+ *  Method that is called when a TLS context is needed
+ *  @param  state
+ *  @param  hostname
+ *  @param  port
+ *  @return std::shared_ptr<SslContext>
+ *  @throws std::runtime_error
+ */
+std::shared_ptr<SslContext> TcpConnection::onContext(TcpState *state, const std::string &hostname, uint16_t port)
+{
+    // without a handler there is nobody to configure the context
+    if (_handler == nullptr) return nullptr;
+
+    // user space could destruct us
+    Monitor monitor(this);
+
+    // the context is shared with the other connections of the same handler, user space configures it if it is new
+    auto context = SslCache::instance().context(_handler, hostname, port, [this](SSL_CTX *context) -> bool {
+        
+        // pass on to user-space
+        return _handler->onContext(this, context);
+    });
+    
+    // remember the context for the next attempt
+    if (monitor.valid()) _context = context;
+    
+    // expose the context
+    return context;
+}
+
+/**
+ *  Method that is called when the connection is secured
+ *  @param  state
+ *  @param  ssl
+ *  @return bool
+ */
+bool TcpConnection::onSecured(TcpState *state, const SSL *ssl)
+{
+    // count the handshake
+    if (_connection.stats()) (OpenSSL::SSL_session_reused(ssl) ? _connection.stats()->_resumed : _connection.stats()->_handshakes).add();
+
+    // pass on to user-space
+    return _handler && _handler->onSecured(this, ssl);
+}
+
 /**
  *  Method that is called when the RabbitMQ server and your client application  
  *  exchange some properties that describe their identity.
@@ -186,6 +384,12 @@ void TcpConnection::onData(Connection *connection, const char *buffer, size_t si
 {
     // send the data over the connection
     _state->send(buffer, size);
+
+    // data that could not be sent right away ends up in the outgoing buffer
+    if (_connection.stats()) _connection.stats()->_outputBuffer.set(_state->queued());
+
+    // which may have grown over the high watermark
+    _connection.buffered(_state->queued());
 }
 
 /**
@@ -208,6 +412,58 @@ void TcpConnection::onError(Connection *connection, const char *message)
     _state->close();
 }
 
+/**
+ *  Method that is called when the AMQP connection is established
+ *  @param  connection      The connection that can now be used
+ */
+void TcpConnection::onReady(Connection *connection)
+{
+    // if user-space is no longer interested in this object, the rest of the code is pointless here
+    if (_handler == nullptr) return;
+
+    // was this the first connection? then we pass it on to the handler
+    if (!_recovering) return _handler->onReady(this);
+
+    // the recovery is complete
+    _recovering = false;
+    _attempts = 0;
+
+    // tell the handler
+    _handler->onRecovered(this);
+}
+
+/**
+ *  Method that is called when the processing of incoming data was paused
+ *  @param  connection      The connection that was paused
+ */
+void TcpConnection::onPaused(Connection *connection)
+{
+    // stop reading from the socket
+    _state->pause();
+}
+
+/**
+ *  Method that is called when the processing of incoming data is resumed
+ *  @param  connection      The connection that was resumed
+ */
+void TcpConnection::onResumed(Connection *connection)
+{
+    // start reading again, data that was already read is processed from the event loop
+    _state->resume();
+}
+
+/**
+ *  Method that is called when there are body frames to produce
+ *  @param  connection      The connection that has frames to produce
+ *  @return bool
+ */
+bool TcpConnection::onProducing(Connection *connection)
+{
+    // the frames are produced every time the outgoing buffer is empty (if the
+    // socket is not connected, they are produced right away and buffered)
+    return _state->produce();
+}
+
 /**
  *  Method that is called when the connection was closed.
  *  @param  connection      The connection that was closed and that is now unusable
@@ -248,8 +504,8 @@ void TcpConnection::onError(TcpState *state, const char *message, bool connected
     // we wait for the subsequent call to the onLost() method
     if (connected || !monitor.valid()) return;
     
-    // tell the handler that no further events will be fired
-    _handler->onDetached(this);
+    // tell the handler that no further events will be fired (or start a new attempt)
+    detach();
 }
 
 /**
@@ -270,8 +526,8 @@ void TcpConnection::onLost(TcpState *state)
     // leap out if object was destructed
     if (!monitor.valid()) return;
     
-    // tell the handler that no further events will be fired
-    _handler->onDetached(this);
+    // tell the handler that no further events will be fired (or start a new attempt)
+    detach();
 }
 
 /**
@@ -4,7 +4,7 @@
  *  Implementation of byte byte-buffer used for incoming frames
  *
  *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
- *  @copyright 2016 Copernica BV
+ *  @copyright 2016 - 2020 Copernica BV
  */
 
 /**
@@ -27,13 +27,30 @@ namespace AMQP {
  */
 class TcpInBuffer : public ByteBuffer
 {
+private:
+    /**
+     *  Number of bytes allocated
+     *  @var size_t
+     */
+    size_t _capacity;
+
+    /**
+     *  Make sure that the buffer has room for at least a number of bytes
+     *  @param  size
+     */
+    void reserve(size_t size)
+    {
+        // reallocate if the buffer is too small
+        if (_capacity < size) reallocate(size);
+    }
+
 public:
     /**
      *  Constructor
      *  Note that we pass 0 to the constructor because the buffer seems to be empty
      *  @param  size        initial size to allocated
      */
-    TcpInBuffer(size_t size) : ByteBuffer((char *)malloc(size), 0) {}
+    TcpInBuffer(size_t size) : ByteBuffer((char *)malloc(size), 0), _capacity(size) {}
     
     /**
      *  No copy'ing
@@ -45,7 +62,11 @@ public:
      *  Move constructor
      *  @param  that
      */
-    TcpInBuffer(TcpInBuffer &&that) : ByteBuffer(std::move(that)) {}
+    TcpInBuffer(TcpInBuffer &&that) : ByteBuffer(std::move(that)), _capacity(that._capacity)
+    {
+        // the other object no longer has a buffer
+        that._capacity = 0;
+    }
     
     /**
      *  Destructor
@@ -65,8 +86,15 @@ public:
         // skip self-assignment
         if (this == &that) return *this;
         
+        // free our own memory
+        if (_data) free((void *)_data);
+
         // call base
         ByteBuffer::operator=(std::move(that));
+
+        // take over the capacity
+        _capacity = that._capacity;
+        that._capacity = 0;
         
         // done
         return *this;
@@ -78,41 +106,43 @@ public:
      */
     void reallocate(size_t size)
     {
+        // the buffer may still hold the start of the next frame, which should be kept
+        _capacity = std::max(size, _size);
+
         // update data
-        _data = (char *)realloc((void *)_data, size);
-   }
+        _data = (char *)realloc((void *)_data, _capacity);
+    }
     
     /**
      *  Receive data from a socket
+     *
+     *  We read as much as fits in the buffer (and not just the bytes of the next
+     *  frame), so that a burst of small frames is processed with a single system
+     *  call, and all frames in it are parsed in one go
+     *
      *  @param  socket          socket to read from
      *  @param  expected        number of bytes that the library expects
      *  @return ssize_t
      */
     ssize_t receivefrom(int socket, uint32_t expected)
     {
-        // find out how many bytes are available
-        uint32_t available = 0;
-        
-        // check the number of bytes that are available
-        if (ioctl(socket, FIONREAD, &available) != 0) return -1;
-        
-        // if no bytes are available, it could mean that the connection was closed
-        // by the remote client, so we do have to call read() anyway, assume a default buffer
-        if (available == 0) available = 1;
-        
-        // number of bytes to read
-        size_t bytes = std::min((uint32_t)(expected - _size), available);
-        
+        // the expected bytes must fit, and there must be room for at least one more 
+        // byte, because reading zero bytes would look like the connection was closed
+        reserve(std::max(size_t(expected), _size + 1));
+
         // read data into the buffer
-        auto result = read(socket, (void *)(_data + _size), bytes);
+        auto result = read(socket, (void *)(_data + _size), _capacity - _size);
         
         // update total buffer size
         if (result > 0) _size += result;
+
+        // trace the operation
+        if (result > 0) AMQP_CPP_TRACE(read, 0, result);
         
         // done
         return result;
     }
-
+    
     /**
      *  Receive data from a socket
      *  @param  ssl             ssl wrapped socket to read from
@@ -121,27 +151,34 @@ public:
      */
     ssize_t receivefrom(SSL *ssl, uint32_t expected)
     {
-        // number of bytes to that still fit in the buffer
-        size_t bytes = expected - _size;
-        
-        // read data
-        auto result = OpenSSL::SSL_read(ssl, (void *)(_data + _size), bytes);
+        // the expected bytes must fit, and there must be room for at least one more byte
+        reserve(std::max(size_t(expected), _size + 1));
+
+        // read data (as much as fits in the buffer)
+        auto result = OpenSSL::SSL_read(ssl, (void *)(_data + _size), _capacity - _size);
         
         // update total buffer size on success
         if (result > 0) _size += result;
         
+        // trace the operation
+        if (result > 0) AMQP_CPP_TRACE(read, 0, result);
+
         // done
         return result;
     }
-    
+
     /**
-     *  Shrink the buffer (in practice this is always called with the full buffer size)
-     *  @param  size
+     *  Shrink the buffer, the bytes that were not processed (the start of the
+     *  next frame) are moved to the front
+     *  @param  size        number of bytes that were processed
      */
     void shrink(size_t size)
     {
         // update size
         _size -= size;
+
+        // move the remaining bytes to the front
+        if (_size > 0 && size > 0) memmove((void *)_data, _data + size, _size);
     }
 };
 
@@ -56,7 +56,25 @@ private:
      */
     size_t _size = 0;
 
+    /**
+     *  Number of bytes passed to the previous SSL_write() call that failed, 
+     *  openssl requires that the call is repeated with exactly the same data
+     *  @var size_t
+     */
+    size_t _retry = 0;
+
+    /**
+     *  Buffer in which small buffers are combined into a single TLS record
+     *  @var std::vector<char>
+     */
+    std::vector<char> _record;
+
 public:
+    /**
+     *  Max number of bytes in a TLS record
+     */
+    static const size_t recordsize = 16384;
+
     /**
      *  Regular constructor
      */
@@ -75,11 +93,13 @@ public:
     TcpOutBuffer(TcpOutBuffer &&that) : 
         _buffers(std::move(that._buffers)), 
         _skip(that._skip), 
-        _size(that._size)
+        _size(that._size),
+        _retry(that._retry)
     {
         // reset other object
         that._skip = 0;
         that._size = 0;
+        that._retry = 0;
     }
     
     /**
@@ -97,6 +117,7 @@ public:
         // swap integers
         std::swap(_skip, that._skip);
         std::swap(_size, that._size);
+        std::swap(_retry, that._retry);
         
         // done
         return *this;
@@ -144,6 +165,9 @@ public:
     
         // update total size
         _size += size;
+
+        // trace the operation
+        AMQP_CPP_TRACE(buffered, 0, size);
     }
     
     /**
@@ -205,7 +229,7 @@ public:
         _buffers.clear();
         
         // reset members
-        _skip = _size = 0;
+        _skip = _size = _retry = 0;
     }
     
     /**
@@ -269,6 +293,9 @@ public:
             // skip on error, or when nothing was written
             if (result <= 0) return total > 0 ? total : result;
 
+            // trace the operation
+            AMQP_CPP_TRACE(written, 0, result);
+
             // shrink the buffer
             shrink(result);
 
@@ -282,28 +309,77 @@ public:
     
     /**
      *  Send the buffer to an SSL connection
+     *
+     *  Small buffers are combined into a single write of (at most) one TLS record,
+     *  so that we do not pay the overhead of a record for every frame. The ssl
+     *  object should be in SSL_MODE_ENABLE_PARTIAL_WRITE and SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER
+     *  mode, because the combined data is copied again when a write has to be repeated.
+     *
      *  @param  ssl         the ssl context to send data to
      *  @return ssize_t     number of bytes sent, or the return value of ssl_write
      */
     ssize_t sendto(SSL *ssl)
     {
-        // we're going to fill a lot of buffers (for ssl only one buffer at a time can be sent)
-        struct iovec buffer[1];
-        
-        // fill the buffers, and leap out if there is no data
-        auto buffers = fill(buffer, 1);
-        
-        // just to be sure we do this check
-        if (buffers == 0) return 0;
+        // leap out if there is no data
+        if (_size == 0) return 0;
+
+        // the first buffer
+        const auto &first = _buffers.front();
+
+        // by default we write the first buffer
+        const char *data = first.data() + _skip;
+        size_t bytes = first.size() - _skip;
+
+        // should small buffers be combined? (or is this a repeated write of combined buffers)
+        if (_retry > bytes || (_retry == 0 && bytes < recordsize && _size > bytes))
+        {
+            // the number of bytes to combine
+            size_t total = _retry > 0 ? _retry : std::min(_size, size_t(recordsize));
+
+            // make sure the record buffer is big enough
+            if (_record.size() < total) _record.resize(std::max(total, size_t(recordsize)));
+
+            // number of bytes copied so far
+            size_t copied = 0;
+
+            // copy the buffers into the record
+            for (const auto &buffer : _buffers)
+            {
+                // the data in this buffer (the first one is partially sent already)
+                const char *begin = copied == 0 ? buffer.data() + _skip : buffer.data();
+                size_t size = std::min(size_t(buffer.data() + buffer.size() - begin), total - copied);
+
+                // copy it
+                memcpy(_record.data() + copied, begin, size);
+
+                // stop when the record is full
+                if ((copied += size) >= total) break;
+            }
+
+            // write the record
+            data = _record.data();
+            bytes = total;
+        }
+        else if (_retry > 0)
+        {
+            // repeat the write of (the start of) the first buffer
+            bytes = _retry;
+        }
         
         // make sure that the error queue is currently completely empty, so the error queue can be checked
         OpenSSL::ERR_clear_error();
 
         // send the data
-        auto result = OpenSSL::SSL_write(ssl, buffer[0].iov_base, buffer[0].iov_len);
+        auto result = OpenSSL::SSL_write(ssl, data, (int)bytes);
+
+        // if the write failed, it has to be repeated with the same data
+        _retry = result > 0 ? 0 : bytes;
         
         // on success we shrink the buffer
         if (result > 0) shrink(result);
+
+        // trace the operation
+        if (result > 0) AMQP_CPP_TRACE(written, 0, result);
         
         // done
         return result;
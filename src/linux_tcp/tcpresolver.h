@@ -22,7 +22,10 @@
 #include "tcpconnected.h"
 #include "openssl.h"
 #include "sslhandshake.h"
+#include "dnscache.h"
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <netinet/in.h>
 
 /**
@@ -78,32 +81,72 @@ private:
      */
     std::thread _thread;
 
+    /**
+     *  Number of milliseconds to wait before the lookup is started
+     *  @var uint32_t
+     */
+    uint32_t _delay;
+
+    /**
+     *  Mutex and condition variable to interrupt the delay
+     *  @var std::mutex
+     *  @var std::condition_variable
+     */
+    std::mutex _mutex;
+    std::condition_variable _condition;
+
+    /**
+     *  Was the resolver destructed before the thread finished?
+     *  @var bool
+     */
+    bool _cancelled = false;
+
 
     /**
      *  Run the thread
      */
     void run()
     {
+        // wait for the delay to expire (when reconnecting)
+        if (_delay > 0)
+        {
+            // lock the mutex
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            // wait for the delay, or until we're cancelled
+            _condition.wait_for(lock, std::chrono::milliseconds(_delay), [this]() { return _cancelled; });
+
+            // there is no need to do the lookup if the connection is no longer interested
+            if (_cancelled) return;
+        }
+
         // prevent exceptions
         try
         {
             // check if we support openssl in the first place
             if (_secure && !OpenSSL::valid()) throw std::runtime_error("Secure connection cannot be established: libssl.so cannot be loaded");
             
-            // get address info
-            AddressInfo addresses(_hostname.data(), _port);
+            // get address info (this could come from the cache, or wait for a lookup by an other connection)
+            auto addresses = DnsCache::instance().resolve(_hostname, _port);
     
             // iterate over the addresses
-            for (size_t i = 0; i < addresses.size(); ++i)
+            for (const auto &address : addresses)
             {
                 // create the socket
-                _socket = socket(addresses[i]->ai_family, addresses[i]->ai_socktype, addresses[i]->ai_protocol);
+                _socket = socket(address.family(), address.socktype(), address.protocol());
                 
                 // move on on failure
                 if (_socket < 0) continue;
                 
                 // connect to the socket
-                if (connect(_socket, addresses[i]->ai_addr, addresses[i]->ai_addrlen) == 0) break;
+                if (connect(_socket, address.address(), address.size()) == 0)
+                {
+                    // remember this address, so that the next connection tries it first
+                    DnsCache::instance().succeeded(_hostname, _port, address);
+                    
+                    // we're connected
+                    break;
+                }
                 
                 // log the error for the time being
                 _error = strerror(errno);
@@ -115,6 +158,9 @@ private:
                 _socket = -1;
             }
             
+            // if none of the addresses could be used, the cached lookup is probably outdated
+            if (_socket < 0) DnsCache::instance().failed(_hostname, _port);
+            
             // connection succeeded, mark socket as non-blocking
             if (_socket >= 0) 
             {
@@ -152,12 +198,14 @@ public:
      *  @param  hostname    The hostname for the lookup
      *  @param  portnumber  The portnumber for the lookup
      *  @param  secure      Do we need a secure tls connection when ready?
+     *  @param  delay       Number of milliseconds to wait before the lookup is started
      */
-    TcpResolver(TcpParent *parent, std::string hostname, uint16_t port, bool secure) : 
+    TcpResolver(TcpParent *parent, std::string hostname, uint16_t port, bool secure, uint32_t delay = 0) : 
         TcpExtState(parent), 
         _hostname(std::move(hostname)),
         _secure(secure),
-        _port(port)
+        _port(port),
+        _delay(delay)
     {
         // tell the event loop to monitor the filedescriptor of the pipe
         parent->onIdle(this, _pipe.in(), readable);
@@ -177,6 +225,18 @@ public:
         // stop monitoring the pipe filedescriptor
         _parent->onIdle(this, _pipe.in(), 0);
 
+        // interrupt the delay (if the thread is still waiting)
+        {
+            // lock the mutex
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            // the thread can stop
+            _cancelled = true;
+        }
+
+        // wake up the thread
+        _condition.notify_one();
+
         // wait for the thread to be ready
         _thread.join();
     }
@@ -206,7 +266,7 @@ public:
             if (!monitor.valid()) return nullptr;
             
             // if we need a secure connection, we move to the tls handshake (this could throw)
-            if (_secure) return new SslHandshake(this, std::move(_hostname), std::move(_buffer));
+            if (_secure) return new SslHandshake(this, _hostname, _port, std::move(_buffer));
             
             // otherwise we have a valid regular tcp connection
             else return new TcpConnected(this, std::move(_buffer));
@@ -250,6 +310,17 @@ public:
         // add data to buffer
         _buffer.add(buffer, size);
     }
+
+    /**
+     *  Start producing body frames whenever the outgoing buffer is empty
+     *  @return bool
+     */
+    virtual bool produce() override
+    {
+        // the frames should not pile up in the buffer before we are connected,
+        // the connected state picks up the producers when it is constructed
+        return true;
+    }
 };
 
 /**
@@ -103,6 +103,22 @@ public:
      */
     virtual void close() {}
 
+    /**
+     *  Stop reading from the socket
+     */
+    virtual void pause() {}
+
+    /**
+     *  Start reading from the socket again
+     */
+    virtual void resume() {}
+
+    /**
+     *  Start producing body frames whenever the outgoing buffer is empty
+     *  @return bool        will the parent's onProduce() method be called?
+     */
+    virtual bool produce() { return false; }
+
     /**
      *  Install max-frame size
      *  @param  heartbeat   suggested heartbeat
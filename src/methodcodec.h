@@ -0,0 +1,390 @@
+/**
+ *  MethodCodec.h
+ *
+ *  Base class for method frames that generates the encoding, decoding and
+ *  size computation from a single description of the fields. Derived classes
+ *  only have to list their members (in the order in which they appear on the
+ *  wire) in a static fields() method:
+ *
+ *      template <typename Self, typename Visitor>
+ *      static void fields(Self &self, Visitor &visitor)
+ *      {
+ *          visitor(self._deprecated, self._exchange, self._routingKey, self._bools);
+ *      }
+ *
+ *  The same list is used to calculate the size, to fill an output buffer and
+ *  to parse a received frame, so these can no longer get out of sync.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <type_traits>
+#include "amqpcpp/outbuffer.h"
+#include "amqpcpp/receivedframe.h"
+#include "amqpcpp/stringfield.h"
+#include "amqpcpp/booleanset.h"
+#include "amqpcpp/table.h"
+#include "stringfieldview.h"
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class that writes fields to an output buffer
+ */
+class MethodEncoder
+{
+private:
+    /**
+     *  The buffer to write to
+     *  @var OutBuffer
+     */
+    OutBuffer &_buffer;
+
+public:
+    /**
+     *  Constructor
+     *  @param  buffer
+     */
+    MethodEncoder(OutBuffer &buffer) : _buffer(buffer) {}
+
+    /**
+     *  No copying
+     *  @param  that
+     */
+    MethodEncoder(const MethodEncoder &that) = delete;
+
+    /**
+     *  Add numeric values
+     *  @param  value
+     */
+    void add(uint8_t value) { _buffer.add(value); }
+    void add(int8_t value) { _buffer.add(value); }
+    void add(uint16_t value) { _buffer.add(value); }
+    void add(int16_t value) { _buffer.add(value); }
+    void add(uint32_t value) { _buffer.add(value); }
+    void add(int32_t value) { _buffer.add(value); }
+    void add(uint64_t value) { _buffer.add(value); }
+    void add(int64_t value) { _buffer.add(value); }
+
+    /**
+     *  Add a string, prefixed with its size
+     *  @param  value
+     */
+    template <typename T, char F>
+    void add(const StringField<T,F> &value)
+    {
+        // the string data
+        const std::string &data = value;
+
+        // first the size, then the data
+        _buffer.add((typename T::Type)data.size());
+        _buffer.add(data.data(), (uint32_t)data.size());
+    }
+
+    /**
+     *  Add a string view, prefixed with its size
+     *  @param  value
+     */
+    template <typename T>
+    void add(const StringFieldView<T> &value)
+    {
+        // the string data
+        const StringView &data = value;
+
+        // first the size, then the data
+        _buffer.add((typename T::Type)data.size());
+        _buffer.add(data.data(), (uint32_t)data.size());
+    }
+
+    /**
+     *  Add a set of booleans
+     *  @param  value
+     */
+    void add(const BooleanSet &value) { value.fill(_buffer); }
+
+    /**
+     *  Add a table
+     *  @param  value
+     */
+    void add(const Table &value) { value.fill(_buffer); }
+
+    /**
+     *  Add all fields
+     *  @param  fields
+     */
+    template <typename... Fields>
+    void operator()(const Fields &...fields)
+    {
+        // add the fields one by one (a braced list is evaluated in order)
+        int dummy[] = { 0, (add(fields), 0)... };
+
+        // avoid a warning
+        (void)dummy;
+    }
+};
+
+/**
+ *  Class that reads fields from a received frame
+ */
+class MethodDecoder
+{
+private:
+    /**
+     *  The frame to read from
+     *  @var ReceivedFrame
+     */
+    ReceivedFrame &_frame;
+
+public:
+    /**
+     *  Constructor
+     *  @param  frame
+     */
+    MethodDecoder(ReceivedFrame &frame) : _frame(frame) {}
+
+    /**
+     *  Read numeric values
+     *  @param  value
+     */
+    void read(uint8_t &value) { value = _frame.nextUint8(); }
+    void read(int8_t &value) { value = _frame.nextInt8(); }
+    void read(uint16_t &value) { value = _frame.nextUint16(); }
+    void read(int16_t &value) { value = _frame.nextInt16(); }
+    void read(uint32_t &value) { value = _frame.nextUint32(); }
+    void read(int32_t &value) { value = _frame.nextInt32(); }
+    void read(uint64_t &value) { value = _frame.nextUint64(); }
+    void read(int64_t &value) { value = _frame.nextInt64(); }
+
+    /**
+     *  Read a string that is prefixed with its size
+     *  @param  value
+     */
+    template <typename T, char F>
+    void read(StringField<T,F> &value)
+    {
+        // get the size
+        typename T::Type size = T(_frame).value();
+
+        // get the data
+        value = std::string(_frame.nextData(size), size);
+    }
+
+    /**
+     *  Read a string view that is prefixed with its size
+     *  @param  value
+     */
+    template <typename T>
+    void read(StringFieldView<T> &value)
+    {
+        // get the size
+        typename T::Type size = T(_frame).value();
+
+        // get the data
+        const char *data = _frame.nextData(size);
+
+        // in contiguous memory we can refer to the data, otherwise we need a copy
+        if (_frame.contiguous()) value.refer(data, size);
+        else value.assign(data, size);
+    }
+
+    /**
+     *  Read a set of booleans
+     *  @param  value
+     */
+    void read(BooleanSet &value) { value = BooleanSet(_frame); }
+
+    /**
+     *  Read a table
+     *  @param  value
+     */
+    void read(Table &value) { value = Table(_frame); }
+
+    /**
+     *  Read all fields
+     *  @param  fields
+     */
+    template <typename... Fields>
+    void operator()(Fields &...fields)
+    {
+        // read the fields one by one (a braced list is evaluated in order)
+        int dummy[] = { 0, (read(fields), 0)... };
+
+        // avoid a warning
+        (void)dummy;
+    }
+};
+
+/**
+ *  Class that calculates the encoded size of fields
+ */
+class MethodMeasurer
+{
+private:
+    /**
+     *  The size so far
+     *  @var size_t
+     */
+    size_t _size = 0;
+
+public:
+    /**
+     *  Size of numeric values
+     *  @param  value
+     *  @return size_t
+     */
+    template <typename T>
+    static typename std::enable_if<std::is_arithmetic<T>::value, size_t>::type size(T value) { return sizeof(T); }
+
+    /**
+     *  Size of a string, including the size prefix
+     *  @param  value
+     *  @return size_t
+     */
+    template <typename T, char F>
+    static size_t size(const StringField<T,F> &value) { return sizeof(typename T::Type) + value.value().size(); }
+
+    /**
+     *  Size of a string view, including the size prefix
+     *  @param  value
+     *  @return size_t
+     */
+    template <typename T>
+    static size_t size(const StringFieldView<T> &value) { return sizeof(typename T::Type) + value.value().size(); }
+
+    /**
+     *  Size of a set of booleans
+     *  @param  value
+     *  @return size_t
+     */
+    static size_t size(const BooleanSet &value) { return 1; }
+
+    /**
+     *  Size of a table
+     *  @param  value
+     *  @return size_t
+     */
+    static size_t size(const Table &value) { return value.size(); }
+
+    /**
+     *  Measure all fields
+     *  @param  fields
+     */
+    template <typename... Fields>
+    void operator()(const Fields &...fields)
+    {
+        // add the sizes one by one
+        int dummy[] = { 0, (_size += size(fields), 0)... };
+
+        // avoid a warning
+        (void)dummy;
+    }
+
+    /**
+     *  The total size
+     *  @return size_t
+     */
+    size_t result() const { return _size; }
+};
+
+/**
+ *  Class definition
+ */
+template <typename Derived, typename Base>
+class MethodCodec : public Base
+{
+protected:
+    /**
+     *  Shorter name for this class (derived classes declare it as friend,
+     *  so that we can access the fields)
+     */
+    using Codec = MethodCodec;
+
+    /**
+     *  Constructor for a frame that is going to be sent, the derived class
+     *  should call measure() once its fields are set
+     *  @param  channel     channel we're working on
+     */
+    MethodCodec(uint16_t channel) : Base(channel, 0) {}
+
+    /**
+     *  Constructor for a frame that was received, the derived class
+     *  should call decode() to read the fields
+     *  @param  frame       received frame
+     */
+    MethodCodec(ReceivedFrame &frame) : Base(frame) {}
+
+    /**
+     *  Read the fields from a received frame
+     *  @param  frame
+     */
+    void decode(ReceivedFrame &frame)
+    {
+        // the object to read the fields
+        MethodDecoder decoder(frame);
+
+        // read them
+        Derived::fields(static_cast<Derived&>(*this), decoder);
+    }
+
+    /**
+     *  Calculate the size of the payload from the fields of a frame that
+     *  is going to be sent
+     */
+    void measure()
+    {
+        // the object to measure the fields
+        MethodMeasurer measurer;
+
+        // measure them
+        Derived::fields(static_cast<const Derived&>(*this), measurer);
+
+        // store the size, including the class and method ids
+        this->_size = (uint32_t)measurer.result() + 4;
+    }
+
+    /**
+     *  Fill an output buffer
+     *  @param  buffer
+     */
+    virtual void fill(OutBuffer &buffer) const override
+    {
+        // the derived object (its methods are called directly instead of virtually)
+        const Derived &self = static_cast<const Derived&>(*this);
+
+        // the object to write the fields
+        MethodEncoder encoder(buffer);
+
+        // add type, channel id, size, class id and method id
+        encoder.add(self.Derived::type());
+        encoder.add(this->_channel);
+        encoder.add(this->_size);
+        encoder.add(self.Derived::classID());
+        encoder.add(self.Derived::methodID());
+
+        // add the fields
+        Derived::fields(self, encoder);
+    }
+
+public:
+    /**
+     *  Destructor
+     */
+    virtual ~MethodCodec() {}
+};
+
+/**
+ *  End of namespace
+ */
+}
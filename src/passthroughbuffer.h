@@ -36,12 +36,6 @@ private:
      */
     char _buffer[4096];
 
-    /**
-     *  Current size of the buffer
-     *  @var size_t
-     */
-    size_t _size = 0;
-    
     /**
      *  Connection object (needs to be passed to the handler)
      *  @var Connection
@@ -61,10 +55,10 @@ private:
     void flush()
     {
         // notify the handler
-        _handler->onData(_connection, _buffer, _size);
+        _handler->onData(_connection, _buffer, _cursor - _buffer);
 
         // all data has been sent
-        _size = 0;
+        window(_buffer, _buffer + sizeof(_buffer));
     }
 
 protected:
@@ -75,17 +69,17 @@ protected:
      */
     virtual void append(const void *data, size_t size) override
     {
-        // flush existing buffers if data would not fit
-        if (_size > 0 && _size + size > 4096) flush();
-        
+        // the data did not fit, so we flush the buffer
+        if (_cursor > _buffer) flush();
+
         // if data would not fit anyway, we send it immediately
-        if (size > 4096) return _handler->onData(_connection, (const char *)data, size);
-        
+        if (size > sizeof(_buffer)) return _handler->onData(_connection, (const char *)data, size);
+
         // copy data into the buffer
-        memcpy(_buffer + _size, data, size);
-        
-        // update the size
-        _size += size;
+        memcpy(_cursor, data, size);
+
+        // update the cursor
+        _cursor += size;
     }
 
 public:
@@ -97,6 +91,9 @@ public:
      */
     PassthroughBuffer(Connection *connection, ConnectionHandler *handler, const Frame &frame) : _connection(connection), _handler(handler)
     {
+        // the frame is written straight into the buffer
+        window(_buffer, _buffer + sizeof(_buffer));
+
         // tell the frame to fill this buffer
         frame.fill(*this);
         
@@ -122,7 +119,7 @@ public:
     virtual ~PassthroughBuffer()
     {
         // pass data to the handler
-        if (_size > 0) flush();
+        if (_cursor > _buffer) flush();
     }
 };
 
@@ -0,0 +1,133 @@
+/**
+ *  PublishStream.h
+ *
+ *  A message that is published from a producer. The body is not passed to
+ *  the library in one piece, but it is produced frame by frame, while the
+ *  earlier frames are being sent. The producer writes each part of the body
+ *  into a buffer of the size of a single frame, which is then copied into
+ *  the body frame that is sent, so that no more than a single frame of the
+ *  body is held in memory.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include "amqpcpp/envelope.h"
+#include "amqpcpp/callbacks.h"
+#include <vector>
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class PublishStream
+{
+private:
+    /**
+     *  The properties and the size of the message (without a body)
+     *  @var Envelope
+     */
+    Envelope _envelope;
+
+    /**
+     *  The callback that produces the body
+     *  @var ProduceCallback
+     */
+    ProduceCallback _producer;
+
+    /**
+     *  Number of bytes of the body that still have to be produced
+     *  @var uint64_t
+     */
+    uint64_t _left;
+
+    /**
+     *  The buffer that the producer writes to (the data is copied from here
+     *  into the body frame)
+     *  @var std::vector<char>
+     */
+    std::vector<char> _buffer;
+
+public:
+    /**
+     *  Constructor
+     *  @param  metadata    the properties of the message
+     *  @param  size        size of the body
+     *  @param  producer    callback that produces the body
+     */
+    PublishStream(const MetaData &metadata, uint64_t size, const ProduceCallback &producer) :
+        _envelope(nullptr, size), _producer(producer), _left(size)
+    {
+        // copy the properties
+        _envelope.set(metadata);
+    }
+
+    /**
+     *  No copying
+     *  @param  that
+     */
+    PublishStream(const PublishStream &that) = delete;
+
+    /**
+     *  Destructor
+     */
+    virtual ~PublishStream() = default;
+
+    /**
+     *  The envelope to send in the header frame
+     *  @return Envelope
+     */
+    const Envelope &envelope() const { return _envelope; }
+
+    /**
+     *  Number of bytes of the body that still have to be produced
+     *  @return uint64_t
+     */
+    uint64_t left() const { return _left; }
+
+    /**
+     *  The data that was produced by the last call to produce()
+     *  @return const char *
+     */
+    const char *data() const { return _buffer.data(); }
+
+    /**
+     *  Let the producer write the next part of the body to the buffer
+     *  @param  maxpayload  max size of a body frame
+     *  @return size_t      number of bytes produced (zero on failure)
+     */
+    size_t produce(uint32_t maxpayload)
+    {
+        // size of the next part
+        size_t size = (size_t)std::min(static_cast<uint64_t>(maxpayload), _left);
+
+        // make sure the buffer is big enough
+        if (_buffer.size() < size) _buffer.resize(size);
+
+        // let the producer fill it (it may write less, but never more)
+        size_t result = std::min(_producer(_buffer.data(), size), size);
+
+        // update the administration
+        _left -= result;
+
+        // done
+        return result;
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
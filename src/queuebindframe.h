@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class definition
  */
-class QueueBindFrame : public QueueFrame
+class QueueBindFrame : public MethodCodec<QueueBindFrame, QueueFrame>
 {
 private:
     /**
@@ -53,23 +53,21 @@ private:
 
 protected:
     /**
-     *  Encode the frame into a buffer
-     *
-     *  @params buffer  buffer to encode frame in to
-     */ 
-    virtual void fill(OutBuffer& buffer) const override
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
+     */
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        QueueFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_deprecated);
-        _name.fill(buffer);
-        _exchange.fill(buffer);
-        _routingKey.fill(buffer);
-        _noWait.fill(buffer);
-        _arguments.fill(buffer);
+        visitor(self._deprecated, self._name, self._exchange, self._routingKey, self._noWait, self._arguments);
     }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Destructor
@@ -87,13 +85,16 @@ public:
      *  @param   Table arguments     additional arguments
      */
     QueueBindFrame(uint16_t channel, const std::string& name, const std::string& exchange, const std::string& routingKey = "", bool noWait = false, const Table& arguments = {}) :
-        QueueFrame(channel, (uint32_t)(name.length() + exchange.length() + routingKey.length() + arguments.size() + 6) ), // 3 extra per string, 1 for bools, 2 for deprecated field
+        Codec(channel),
         _name(name),
         _exchange(exchange),
         _routingKey(routingKey),
         _noWait(noWait),
         _arguments(arguments)
-    {}     
+    {
+        // calculate the size
+        measure();
+    }     
   
 
     /**
@@ -101,14 +102,11 @@ public:
      *  @param  frame   received frame
      */
     QueueBindFrame(ReceivedFrame &frame) :
-        QueueFrame(frame),
-        _deprecated(frame.nextUint16()),
-        _name(frame),
-        _exchange(frame),
-        _routingKey(frame),
-        _noWait(frame),
-        _arguments(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Is this a synchronous frame?
@@ -122,6 +120,18 @@ public:
         return !noWait();
     }
 
+    /**
+     *  Can this frame be pipelined?
+     *
+     *  In pipelined mode, a channel does not wait for the -ok frame of
+     *  a pipelinable frame before it sends out the next one
+     */
+    bool pipelinable() const override
+    {
+        // declaring, binding and deleting can be done back-to-back
+        return true;
+    }
+
     /**
      *  Returns the method id
      *  @return uint16_t
@@ -12,33 +12,43 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class QueueBindOKFrame : public QueueFrame
+class QueueBindOKFrame : public MethodCodec<QueueBindOKFrame, QueueFrame>
 {
 protected:
     /**
-     *  Fill output buffer
-     *  @param  buffer
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        QueueFrame::fill(buffer);
+        visitor();
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a queuebindokframe
      *
      *  @param  channel     channel identifier
      */
-    QueueBindOKFrame(uint16_t channel) : QueueFrame(channel, 0) {}
+    QueueBindOKFrame(uint16_t channel) : Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor based on incoming data
      *  @param  frame   received frame
      */
     QueueBindOKFrame(ReceivedFrame &frame) :
-        QueueFrame(frame)
+        Codec(frame)
     {}
 
     /**
@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class QueueDeclareFrame : public QueueFrame
+class QueueDeclareFrame : public MethodCodec<QueueDeclareFrame, QueueFrame>
 {
 private:
     /**
@@ -46,22 +46,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        QueueFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_deprecated);
-        _name.fill(buffer);
-        _bools.fill(buffer);
-        _arguments.fill(buffer);
+        visitor(self._deprecated, self._name, self._bools, self._arguments);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Destructor
@@ -80,23 +79,25 @@ public:
      *  @param  Table arguments     additional arguments, implementation dependent
      */
     QueueDeclareFrame(uint16_t channel, const std::string& name = "", bool passive = false, bool durable = false, bool exclusive = false, bool autoDelete = false, bool noWait = false, const Table& arguments = {}) :
-        QueueFrame(channel, (uint32_t)(name.length() + arguments.size() + 4 ) ), // 1 extra for string size, 1 for bools, 2 for deprecated value
+        Codec(channel),
         _name(name),
         _bools(passive, durable, exclusive, autoDelete, noWait),
         _arguments(arguments)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
     
     /**
      *  Constructor based on incoming data
      *  @param  frame   received frame
      */
     QueueDeclareFrame(ReceivedFrame &frame) :
-        QueueFrame(frame),
-        _deprecated(frame.nextInt16()),
-        _name(frame),
-        _bools(frame),
-        _arguments(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Is this a synchronous frame?
@@ -110,6 +111,18 @@ public:
         return !noWait();
     }
 
+    /**
+     *  Can this frame be pipelined?
+     *
+     *  In pipelined mode, a channel does not wait for the -ok frame of
+     *  a pipelinable frame before it sends out the next one
+     */
+    bool pipelinable() const override
+    {
+        // declaring, binding and deleting can be done back-to-back
+        return true;
+    }
+
     /**
      *  returns the method id
      *  @return string
@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class QueueDeclareOKFrame : public QueueFrame
+class QueueDeclareOKFrame : public MethodCodec<QueueDeclareOKFrame, QueueFrame>
 {
 private:
     /**
@@ -36,21 +36,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        QueueFrame::fill(buffer);
-
-        // add fields
-        _name.fill(buffer);
-        buffer.add(_messageCount);
-        buffer.add(_consumerCount);
+        visitor(self._name, self._messageCount, self._consumerCount);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a channel flow frame
@@ -62,22 +62,25 @@ public:
      *  @param  failingMethod   failing method id if applicable
      */
     QueueDeclareOKFrame(uint16_t channel, const std::string& name, int32_t messageCount, int32_t consumerCount) :
-        QueueFrame(channel, (uint32_t)(name.length() + 9)), // 4 per int, 1 for string size
+        Codec(channel),
         _name(name),
         _messageCount(messageCount),
         _consumerCount(consumerCount)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor based on incoming data
      *  @param  frame   received frame
      */
     QueueDeclareOKFrame(ReceivedFrame &frame) :
-        QueueFrame(frame),
-        _name(frame),
-        _messageCount(frame.nextInt32()),
-        _consumerCount(frame.nextInt32())
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -132,6 +135,9 @@ public:
         // what if channel doesn't exist?
         if (!channel) return false;
 
+        // the channel keeps track of declared queues
+        channel->reportDeclared(name());
+
         // report success
         channel->reportSuccess(name(), messageCount(), consumerCount());
 
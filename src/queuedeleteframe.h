@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class definition
  */
-class QueueDeleteFrame : public QueueFrame
+class QueueDeleteFrame : public MethodCodec<QueueDeleteFrame, QueueFrame>
 {
 private:
     /**
@@ -38,21 +38,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param   buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        QueueFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_deprecated);
-        _name.fill(buffer);
-        _bools.fill(buffer);
+        visitor(self._deprecated, self._name, self._bools);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Destructor
@@ -69,21 +69,24 @@ public:
      *  @param   noWait      do not wait on response
      */
     QueueDeleteFrame(uint16_t channel, const std::string& name, bool ifUnused = false, bool ifEmpty = false, bool noWait = false) :
-        QueueFrame(channel, (uint32_t)(name.length() + 4)), // 1 for string length, 1 for bools, 2 for deprecated field
+        Codec(channel),
         _name(name),
         _bools(ifUnused, ifEmpty, noWait)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
     
     /**
      *  Constructor based on received data
      *  @param  frame   received frame
      */
     QueueDeleteFrame(ReceivedFrame &frame) :
-        QueueFrame(frame),
-        _deprecated(frame.nextInt16()),
-        _name(frame),
-        _bools(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Is this a synchronous frame?
@@ -97,6 +100,18 @@ public:
         return !noWait();
     }
 
+    /**
+     *  Can this frame be pipelined?
+     *
+     *  In pipelined mode, a channel does not wait for the -ok frame of
+     *  a pipelinable frame before it sends out the next one
+     */
+    bool pipelinable() const override
+    {
+        // declaring, binding and deleting can be done back-to-back
+        return true;
+    }
+
     /**
      *  returns the method id
      *  @returns uint16_t
@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class definition
  */
-class QueueDeleteOKFrame : public QueueFrame
+class QueueDeleteOKFrame : public MethodCodec<QueueDeleteOKFrame, QueueFrame>
 {
 private:
     /**
@@ -23,19 +23,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        QueueFrame::fill(buffer);
-
-        // add field
-        buffer.add(_messageCount);
+        visitor(self._messageCount);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a queuedeleteokframe
@@ -44,18 +46,23 @@ public:
      *  @param  messageCount    number of messages
      */
     QueueDeleteOKFrame(uint16_t channel, int32_t messageCount) :
-        QueueFrame(channel, 4), // 4 for int32_t size
+        Codec(channel),
         _messageCount(messageCount)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor based on received data
      *  @param  frame   received frame
      */
     QueueDeleteOKFrame(ReceivedFrame &frame) :
-        QueueFrame(frame),
-        _messageCount(frame.nextInt32())
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Destructor
@@ -12,7 +12,8 @@ namespace AMQP {
 /**
  *  Class definition
  */
-class QueuePurgeFrame : public QueueFrame{
+class QueuePurgeFrame : public MethodCodec<QueuePurgeFrame, QueueFrame>
+{
 private:
     /**
      *  Field that is no longer in use
@@ -34,21 +35,21 @@ private:
 
 protected:
     /**
-     *  Encode the frame into a buffer
-     *
-     *  @param   buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        QueueFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_deprecated);
-        _name.fill(buffer);
-        _noWait.fill(buffer);
+        visitor(self._deprecated, self._name, self._noWait);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Destructor
@@ -65,21 +66,24 @@ public:
      *  @return  newly created Queuepurgeframe
      */
     QueuePurgeFrame(uint16_t channel, const std::string& name, bool noWait = false) :
-        QueueFrame(channel, (uint32_t)(name.length() + 4)), // 1 extra for string length, 1 for bool, 2 for deprecated field
+        Codec(channel),
         _name(name),
         _noWait(noWait)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor based on received data
      *  @param frame    received frame
      */
     QueuePurgeFrame(ReceivedFrame &frame) :
-        QueueFrame(frame),
-        _deprecated(frame.nextInt16()),
-        _name(frame),
-        _noWait(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
 
     /**
      *  Is this a synchronous frame?
@@ -93,6 +97,18 @@ public:
         return !noWait();
     }
 
+    /**
+     *  Can this frame be pipelined?
+     *
+     *  In pipelined mode, a channel does not wait for the -ok frame of
+     *  a pipelinable frame before it sends out the next one
+     */
+    bool pipelinable() const override
+    {
+        // purging can be done back-to-back, just like declaring, binding and deleting
+        return true;
+    }
+
     /**
      *  The method ID
      *  @return method id
@@ -12,7 +12,7 @@ namespace AMQP {
 /**
  *  Class definition
  */
-class QueueUnbindFrame : public QueueFrame
+class QueueUnbindFrame : public MethodCodec<QueueUnbindFrame, QueueFrame>
 {
 private:
     /**
@@ -47,23 +47,21 @@ private:
 
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param   buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        QueueFrame::fill(buffer);
-
-        // add fields
-        buffer.add(_deprecated);
-        _name.fill(buffer);
-        _exchange.fill(buffer);
-        _routingKey.fill(buffer);
-        _arguments.fill(buffer);
+        visitor(self._deprecated, self._name, self._exchange, self._routingKey, self._arguments);
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Destructor
@@ -80,12 +78,15 @@ public:
      *  @param   arguments   additional arguments, implementation dependant.
      */
     QueueUnbindFrame(uint16_t channel, const std::string& name, const std::string& exchange, const std::string& routingKey = "", const Table& arguments = {} ) :
-        QueueFrame(channel, (uint32_t)(name.length() + exchange.length() + routingKey.length() + arguments.size() + 5) ), // 1 per string, 2 for deprecated field
+        Codec(channel),
         _name(name),
         _exchange(exchange),
         _routingKey(routingKey),
         _arguments(arguments)
-    {}
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor based on incoming data
@@ -93,13 +94,35 @@ public:
      *  @param   frame       received frame to decode
      */
     QueueUnbindFrame(ReceivedFrame& frame) :
-        QueueFrame(frame),
-        _deprecated(frame.nextInt16()),
-        _name(frame),
-        _exchange(frame),
-        _routingKey(frame),
-        _arguments(frame)
-    {}
+        Codec(frame)
+    {
+        // read the fields
+        decode(frame);
+    }
+
+    /**
+     *  Is this a synchronous frame?
+     *
+     *  After a synchronous frame no more frames may be
+     *  sent until the accompanying -ok frame arrives
+     */
+    bool synchronous() const override
+    {
+        // there is no nowait option, so we always wait for the unbind-ok frame
+        return true;
+    }
+
+    /**
+     *  Can this frame be pipelined?
+     *
+     *  In pipelined mode, a channel does not wait for the -ok frame of
+     *  a pipelinable frame before it sends out the next one
+     */
+    bool pipelinable() const override
+    {
+        // unbinding can be done back-to-back, just like declaring, binding and deleting
+        return true;
+    }
 
     /**
      *  returns the method id
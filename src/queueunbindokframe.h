@@ -12,19 +12,24 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class QueueUnbindOKFrame : public QueueFrame
+class QueueUnbindOKFrame : public MethodCodec<QueueUnbindOKFrame, QueueFrame>
 {
 protected:
     /**
-     *  Encode a queueunbindokframe on a stringbuffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        QueueFrame::fill(buffer);
+        visitor();
     }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
 public:
     /**
      * Decode a queueunbindokframe from a received frame
@@ -33,7 +38,7 @@ public:
      * @return  shared pointer to created frame
      */
     QueueUnbindOKFrame(ReceivedFrame& frame) :
-        QueueFrame(frame)
+        Codec(frame)
     {}
 
     /**
@@ -42,8 +47,11 @@ public:
      * @param   channel     channel identifier
      */
     QueueUnbindOKFrame(uint16_t channel) :
-        QueueFrame(channel, 0)
-    {}
+        Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
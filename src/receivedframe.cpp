@@ -3,7 +3,7 @@
  *
  *  Implementation of the ReceivedFrame class
  *
- *  @copyright 2014 - 2017 Copernica BV
+ *  @copyright 2014 - 2020 Copernica BV
  */
 #include "includes.h"
 #include "heartbeatframe.h"
@@ -19,10 +19,12 @@
 #include "connectiontuneframe.h"
 #include "connectioncloseokframe.h"
 #include "connectioncloseframe.h"
+#include "connectionblockedframe.h"
+#include "connectionunblockedframe.h"
 #include "channelopenframe.h"
 #include "channelopenokframe.h"
-#include "channelflowframe.h"
 #include "channelflowokframe.h"
+#include "channelflowframe.h"
 #include "channelcloseokframe.h"
 #include "channelcloseframe.h"
 #include "exchangedeclareframe.h"
@@ -70,7 +72,6 @@
 #include "consumedmessage.h"
 #include "bodyframe.h"
 #include "basicheaderframe.h"
-#include "framecheck.h"
 
 #define TYPE_INVALID 0
 #define END_OF_FRAME 206
@@ -81,16 +82,15 @@
 namespace AMQP {
 
 /**
- *  Constructor
- *  @param  buffer      Binary buffer
+ *  Parse the frame header, and check the frame size and the end-of-frame marker
  *  @param  max         Max size for a frame
  */
-ReceivedFrame::ReceivedFrame(const Buffer &buffer, uint32_t max) : _buffer(buffer)
+void ReceivedFrame::initialize(uint32_t max)
 {
     // we need enough room for type, channel, the payload size, 
     // the the end-of-frame byte is not yet necessary
-    if (buffer.size() < 7) return;
-    
+    if (!header()) return;
+
     // get the information
     _type = nextUint8();
     _channel = nextUint16();
@@ -102,201 +102,27 @@ ReceivedFrame::ReceivedFrame(const Buffer &buffer, uint32_t max) : _buffer(buffe
     // check if the buffer is big enough to contain all data
     if (!complete()) return;
 
-    // buffer is big enough, check for a valid end-of-frame marker
-    if ((uint8_t)buffer.byte(_payloadSize+7) == END_OF_FRAME) return;
-
-    // the frame is invalid because it does not end with the expected char
-    throw ProtocolException("invalid end of frame marker");
-}
-
-/**
- *  Have we received the header of the frame
- *  @return bool
- */
-bool ReceivedFrame::header() const
-{
-    return _buffer.size() >= 7;
-}
-
-/**
- *  Is this a complete frame?
- *  @return integer
- */
-bool ReceivedFrame::complete() const
-{
-    return _buffer.size() >= _payloadSize + 8;
-}
-
-/**
- *  Read the next uint8 from the buffer
- *  
- *  @param  char* buffer    buffer to read from
- *  @return uint8_t         value read
- */
-uint8_t ReceivedFrame::nextUint8()
-{
-    // check if there is enough size
-    FrameCheck check(this, 1);
-    
-    // get a byte
-    return _buffer.byte(_skip);
-}
-
-/**
- *  Read the next int8 from the buffer
- *  
- *  @param  char* buffer    buffer to read from
- *  @return int8_t          value read
- */
-int8_t ReceivedFrame::nextInt8()
-{
-    // check if there is enough size
-    FrameCheck check(this, 1);
-    
-    // get a byte
-    return (int8_t)_buffer.byte(_skip);
-}
-
-/**
- *  Read the next uint16_t from the buffer
- *  
- *  @return uint16_t        value read
- */
-uint16_t ReceivedFrame::nextUint16()
-{
-    // check if there is enough size
-    FrameCheck check(this, sizeof(uint16_t));
-    
-    // get two bytes, and convert to host-byte-order
-    uint16_t value;
-    _buffer.copy(_skip, sizeof(uint16_t), &value);
-    return be16toh(value);
-}
-
-/**
- *  Read the next int16_t from the buffer
- *  
- *  @return int16_t     value read
- */
-int16_t ReceivedFrame::nextInt16()
-{
-    // check if there is enough size
-    FrameCheck check(this, sizeof(int16_t));
-    
-    // get two bytes, and convert to host-byte-order
-    int16_t value;
-    _buffer.copy(_skip, sizeof(int16_t), &value);
-    return be16toh(value);
-}
-
-/**
- *  Read the next uint32_t from the buffer
- *  
- *  @return uint32_t        value read
- */
-uint32_t ReceivedFrame::nextUint32()
-{
-    // check if there is enough size
-    FrameCheck check(this, sizeof(uint32_t));
-    
-    // get four bytes, and convert to host-byte-order
-    uint32_t value;
-    _buffer.copy(_skip, sizeof(uint32_t), &value);
-    return be32toh(value);
-}
-
-/**
- *  Read the next int32_t from the buffer
- *  
- *  @return uint32_t        value read
- */
-int32_t ReceivedFrame::nextInt32()
-{
-    // check if there is enough size
-    FrameCheck check(this, sizeof(int32_t));
-    
-    // get four bytes, and convert to host-byte-order
-    int32_t value;
-    _buffer.copy(_skip, sizeof(int32_t), &value);
-    return be32toh(value);
-}
-
-/**
- *  Read the next uint64_t from the buffer
- *  
- *  @return uint64_t        value read
- */
-uint64_t ReceivedFrame::nextUint64()
-{
-    // check if there is enough size
-    FrameCheck check(this, sizeof(uint64_t));
-    
-    // get eight bytes, and convert to host-byte-order
-    uint64_t value;
-    _buffer.copy(_skip, sizeof(uint64_t), &value);
-    return be64toh(value);
-}
+    // fields may not be read beyond the payload
+    _end = _payloadSize + 7;
 
-/**
- *  Read the next uint64_t from the buffer
- *  
- *  @return uint64_t        value read
- */
-int64_t ReceivedFrame::nextInt64()
-{
-    // check if there is enough size
-    FrameCheck check(this, sizeof(int64_t));
-    
-    // get eight bytes, and convert to host-byte-order
-    int64_t value;
-    _buffer.copy(_skip, sizeof(int64_t), &value);
-    return be64toh(value);
-}
+    // buffer is big enough, get the end-of-frame marker
+    uint8_t marker = _data ? _data[_end] : _buffer->byte(_offset + _end);
 
-/**
- *  Read a float from the buffer
- *
- *  @return float       float read from buffer. 
- */
-float ReceivedFrame::nextFloat()
-{
-    // check if there is enough size
-    FrameCheck check(this, sizeof(float));
-    
-    // get four bytes
-    float value;
-    _buffer.copy(_skip, sizeof(float), &value);
-    return value;
-}
+    // check for a valid end-of-frame marker
+    if (marker == END_OF_FRAME) return;
 
-/**
- *  Read a double from the buffer
- *
- *  @return double      double read from buffer
- */
-double ReceivedFrame::nextDouble()
-{
-    // check if there is enough size
-    FrameCheck check(this, sizeof(double));
-    
-    // get eight bytes, and convert to host-byte-order
-    double value;
-    _buffer.copy(_skip, sizeof(double), &value);
-    return value;
+    // the frame is invalid because it does not end with the expected char
+    throw ProtocolException("invalid end of frame marker");
 }
 
 /**
- *  Get a pointer to the next binary buffer of a certain size
- *  @param  size
- *  @return char*
+ *  Report that a field does not fit in the frame
+ *  @throws ProtocolException
  */
-const char * ReceivedFrame::nextData(uint32_t size)
+void ReceivedFrame::outOfRange()
 {
-    // check if there is enough size
-    FrameCheck check(this, size);
-    
-    // get the data
-    return _buffer.data(_skip, size);
+    // frame buffer is too small
+    throw ProtocolException("frame out of range");
 }
 
 /**
@@ -369,6 +195,8 @@ bool ReceivedFrame::processConnectionFrame(ConnectionImpl *connection)
         case 41:    return ConnectionOpenOKFrame(*this).process(connection);
         case 50:    return ConnectionCloseFrame(*this).process(connection);
         case 51:    return ConnectionCloseOKFrame(*this).process(connection);
+        case 60:    return ConnectionBlockedFrame(*this).process(connection);
+        case 61:    return ConnectionUnblockedFrame(*this).process(connection);
     }
 
     // this is a problem
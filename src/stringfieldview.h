@@ -0,0 +1,117 @@
+/**
+ *  StringFieldView.h
+ *
+ *  String member of a method frame that does not have to be copied when the
+ *  frame is received. The value then refers to the data in the received
+ *  frame, and is only converted into a std::string by the code that needs
+ *  one. Frames that are sent keep a copy of the string that was passed to
+ *  the constructor.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include "amqpcpp/stringview.h"
+#include "amqpcpp/numericfield.h"
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+template <typename T>
+class StringFieldView
+{
+private:
+    /**
+     *  Copy of the string (only used for frames that are sent)
+     *  @var std::string
+     */
+    std::string _string;
+
+    /**
+     *  The value
+     *  @var StringView
+     */
+    StringView _view;
+
+public:
+    /**
+     *  Constructor for an empty string
+     */
+    StringFieldView() = default;
+
+    /**
+     *  Constructor for a frame that is sent
+     *  @param  value
+     */
+    StringFieldView(const std::string &value) : _string(value), _view(_string) {}
+
+    /**
+     *  The view refers to the object itself, so it cannot be copied
+     *  @param  that
+     */
+    StringFieldView(const StringFieldView &that) = delete;
+
+    /**
+     *  Refer to data in a received frame
+     *  @param  data
+     *  @param  size
+     */
+    void refer(const char *data, size_t size)
+    {
+        // forget the copy
+        _string.clear();
+
+        // refer to the data
+        _view = StringView(data, size);
+    }
+
+    /**
+     *  Store a copy of data in a received frame
+     *  @param  data
+     *  @param  size
+     */
+    void assign(const char *data, size_t size)
+    {
+        // copy the data
+        _string.assign(data, size);
+
+        // refer to the copy
+        _view = StringView(_string);
+    }
+
+    /**
+     *  Get the value
+     *  @return StringView
+     */
+    const StringView &value() const { return _view; }
+
+    /**
+     *  Cast to the value
+     *  @return StringView
+     */
+    operator const StringView& () const { return _view; }
+};
+
+/**
+ *  Short and long strings
+ */
+typedef StringFieldView<UOctet> ShortStringView;
+typedef StringFieldView<ULong> LongStringView;
+
+/**
+ *  End of namespace
+ */
+}
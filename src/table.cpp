@@ -9,11 +9,16 @@ namespace AMQP {
  *
  *  @param  frame   received frame to decode
  */
-Table::Table(ReceivedFrame &frame)
-{
-    // table buffer begins with the number of bytes to read
-    uint32_t bytesToRead = frame.nextUint32();
+Table::Table(ReceivedFrame &frame) : Table(frame, frame.nextUint32()) {}
 
+/**
+ *  Decode fields with a known size
+ *
+ *  @param  frame   received frame to decode
+ *  @param  bytesToRead number of bytes in the encoded fields
+ */
+Table::Table(ReceivedFrame &frame, uint32_t bytesToRead)
+{
     // keep going until the correct number of bytes is read.
     while (bytesToRead > 0)
     {
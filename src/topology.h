@@ -0,0 +1,276 @@
+/**
+ *  Topology.h
+ *
+ *  The exchanges, queues, bindings, consumers and channel settings that
+ *  were declared on a channel. When a connection is recoverable, every
+ *  channel keeps such a record, so that everything can be re-declared
+ *  after the connection has been re-established.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Include guard
+ */
+#pragma once
+
+/**
+ *  Dependencies
+ */
+#include <list>
+#include <deque>
+
+/**
+ *  Set up namespace
+ */
+namespace AMQP {
+
+/**
+ *  Class definition
+ */
+class Topology
+{
+public:
+    /**
+     *  A declared exchange
+     */
+    struct Exchange
+    {
+        std::string name;
+        ExchangeType type;
+        int flags;
+        Table arguments;
+    };
+
+    /**
+     *  A declared queue
+     */
+    struct Queue
+    {
+        std::string name;
+        bool generated;
+        int flags;
+        Table arguments;
+    };
+
+    /**
+     *  A binding between an exchange and a queue or between two exchanges
+     */
+    struct Binding
+    {
+        std::string exchange;
+        std::string target;
+        std::string routingkey;
+        Table arguments;
+    };
+
+    /**
+     *  An active consumer (the deferred object is kept, so that the
+     *  callbacks that were installed by the user are preserved)
+     */
+    struct Consumer
+    {
+        std::string queue;
+        std::string tag;
+        int flags;
+        Table arguments;
+        std::shared_ptr<DeferredConsumer> deferred;
+    };
+
+    /**
+     *  The recorded objects, in the order in which they were declared
+     *  @var std::list
+     */
+    std::list<Exchange> exchanges;
+    std::list<std::shared_ptr<Queue>> queues;
+    std::list<Binding> exchangeBindings;
+    std::list<Binding> queueBindings;
+    std::list<Consumer> consumers;
+
+    /**
+     *  Queues for which the declare-ok frame is still expected, used to find out
+     *  the name of queues that got their name from the server
+     *  @var std::deque
+     */
+    std::deque<std::shared_ptr<Queue>> declaring;
+
+    /**
+     *  The prefetch counts, for the channel and for the connection (the
+     *  two can be set independently, and zero means: never set)
+     *  @var uint16_t
+     */
+    uint16_t prefetch = 0;
+    uint16_t globalPrefetch = 0;
+
+    /**
+     *  Was the channel put in confirm mode?
+     *  @var bool
+     */
+    bool confirm = false;
+
+private:
+    /**
+     *  Helper method to remove bindings that match a predicate
+     *  @param  bindings
+     *  @param  predicate
+     */
+    template <typename Predicate>
+    static void remove(std::list<Binding> &bindings, Predicate predicate)
+    {
+        // remove the matching bindings
+        bindings.remove_if(predicate);
+    }
+
+public:
+    /**
+     *  Record a declared exchange, a redeclaration replaces the earlier one
+     *  @param  name
+     *  @param  type
+     *  @param  flags
+     *  @param  arguments
+     */
+    void declareExchange(const std::string &name, ExchangeType type, int flags, const Table &arguments)
+    {
+        // forget an earlier declaration
+        exchanges.remove_if([&name](const Exchange &exchange) { return exchange.name == name; });
+
+        // store the exchange (nowait is not replayed, because we want to know about errors)
+        exchanges.push_back(Exchange{ name, type, flags & ~nowait, arguments });
+    }
+
+    /**
+     *  Forget about an exchange, together with the bindings that involve it
+     *  @param  name
+     */
+    void removeExchange(const std::string &name)
+    {
+        // forget the exchange itself
+        exchanges.remove_if([&name](const Exchange &exchange) { return exchange.name == name; });
+
+        // and all bindings to and from it
+        remove(exchangeBindings, [&name](const Binding &binding) { return binding.exchange == name || binding.target == name; });
+        remove(queueBindings, [&name](const Binding &binding) { return binding.exchange == name; });
+    }
+
+    /**
+     *  Record a declared queue
+     *  @param  name
+     *  @param  flags
+     *  @param  arguments
+     */
+    void declareQueue(const std::string &name, int flags, const Table &arguments)
+    {
+        // forget an earlier declaration of a named queue
+        if (!name.empty()) queues.remove_if([&name](const std::shared_ptr<Queue> &queue) { return queue->name == name; });
+
+        // create the record
+        auto queue = std::make_shared<Queue>(Queue{ name, name.empty(), flags, arguments });
+
+        // store it, and remember that we expect a declare-ok frame for it
+        queues.push_back(queue);
+        declaring.push_back(queue);
+    }
+
+    /**
+     *  Forget about a queue, together with the bindings and consumers that involve it
+     *  @param  name
+     */
+    void removeQueue(const std::string &name)
+    {
+        // forget the queue itself
+        queues.remove_if([&name](const std::shared_ptr<Queue> &queue) { return queue->name == name; });
+
+        // and all its bindings and consumers
+        remove(queueBindings, [&name](const Binding &binding) { return binding.target == name; });
+        consumers.remove_if([&name](const Consumer &consumer) { return consumer.queue == name; });
+    }
+
+    /**
+     *  Give a server-named queue a new name, after it was declared again
+     *  @param  oldname
+     *  @param  newname
+     */
+    void renameQueue(const std::string &oldname, const std::string &newname)
+    {
+        // update the queue, its bindings and consumers
+        for (auto &queue : queues) if (queue->name == oldname) queue->name = newname;
+        for (auto &binding : queueBindings) if (binding.target == oldname) binding.target = newname;
+        for (auto &consumer : consumers) if (consumer.queue == oldname) consumer.queue = newname;
+    }
+
+    /**
+     *  Is a queue declared with a name that was generated by the server?
+     *  @param  name
+     *  @return bool
+     */
+    bool generated(const std::string &name) const
+    {
+        // look for the queue
+        for (auto &queue : queues) if (queue->name == name) return queue->generated;
+
+        // not found
+        return false;
+    }
+
+    /**
+     *  Record a binding
+     *  @param  bindings    the list to which the binding should be added
+     *  @param  exchange    the source exchange
+     *  @param  target      the bound queue or exchange
+     *  @param  routingkey
+     *  @param  arguments
+     */
+    static void bind(std::list<Binding> &bindings, const std::string &exchange, const std::string &target, const std::string &routingkey, const Table &arguments)
+    {
+        // add to the list
+        bindings.push_back(Binding{ exchange, target, routingkey, arguments });
+    }
+
+    /**
+     *  Forget about a binding
+     *  @param  bindings    the list from which the binding should be removed
+     *  @param  exchange    the source exchange
+     *  @param  target      the bound queue or exchange
+     *  @param  routingkey
+     */
+    static void unbind(std::list<Binding> &bindings, const std::string &exchange, const std::string &target, const std::string &routingkey)
+    {
+        // remove from the list
+        remove(bindings, [&](const Binding &binding) {
+            return binding.exchange == exchange && binding.target == target && binding.routingkey == routingkey;
+        });
+    }
+
+    /**
+     *  Record a consumer
+     *  @param  queue
+     *  @param  tag
+     *  @param  flags
+     *  @param  arguments
+     *  @param  deferred
+     */
+    void consume(const std::string &queue, const std::string &tag, int flags, const Table &arguments, const std::shared_ptr<DeferredConsumer> &deferred)
+    {
+        // add to the list
+        consumers.push_back(Consumer{ queue, tag, flags, arguments, deferred });
+    }
+
+    /**
+     *  Forget about a consumer
+     *  @param  tag         the tag that is cancelled
+     *  @param  deferred    the consumer that is registered under that tag (if any)
+     */
+    void cancel(const std::string &tag, const DeferredConsumer *deferred)
+    {
+        // remove from the list (the tag could have been assigned by the server)
+        consumers.remove_if([&](const Consumer &consumer) {
+            return consumer.deferred.get() == deferred || (!tag.empty() && consumer.tag == tag);
+        });
+    }
+};
+
+/**
+ *  End of namespace
+ */
+}
@@ -12,8 +12,25 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class TransactionCommitFrame : public TransactionFrame
+class TransactionCommitFrame : public MethodCodec<TransactionCommitFrame, TransactionFrame>
 {
+protected:
+    /**
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
+     */
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
+    {
+        visitor();
+    }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Destructor
@@ -27,15 +44,18 @@ public:
      * @return  newly created transaction commit frame
      */
     TransactionCommitFrame(uint16_t channel) : 
-        TransactionFrame(channel, 0)
-    {}
+        Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor based on incoming data
      *  @param  frame   received frame
      */
     TransactionCommitFrame(ReceivedFrame &frame) :
-        TransactionFrame(frame)
+        Codec(frame)
     {}
 
     /**
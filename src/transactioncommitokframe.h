@@ -12,20 +12,25 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class TransactionCommitOKFrame : public TransactionFrame
+class TransactionCommitOKFrame : public MethodCodec<TransactionCommitOKFrame, TransactionFrame>
 {
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        TransactionFrame::fill(buffer);
+        visitor();
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Construct a transaction commit ok frame
@@ -34,8 +39,11 @@ public:
      *  @return  newly created transaction commit ok frame
      */
     TransactionCommitOKFrame(uint16_t channel) :
-        TransactionFrame(channel, 0)
-    {}
+        Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Constructor on incoming data
@@ -43,7 +51,7 @@ public:
      *  @param   frame   received frame to decode
      */
     TransactionCommitOKFrame(ReceivedFrame& frame) :
-        TransactionFrame(frame)
+        Codec(frame)
     {}
 
     /**
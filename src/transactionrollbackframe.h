@@ -12,8 +12,25 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class TransactionRollbackFrame : public TransactionFrame
+class TransactionRollbackFrame : public MethodCodec<TransactionRollbackFrame, TransactionFrame>
 {
+protected:
+    /**
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
+     */
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
+    {
+        visitor();
+    }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Destructor
@@ -26,7 +43,7 @@ public:
      *  @param   frame   received frame to decode
      */
     TransactionRollbackFrame(ReceivedFrame& frame) :
-        TransactionFrame(frame)
+        Codec(frame)
     {}
 
     /**
@@ -36,8 +53,11 @@ public:
      *  @return  newly created transaction rollback frame
      */
     TransactionRollbackFrame(uint16_t channel) :
-        TransactionFrame(channel, 0)
-    {}
+        Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  return the method id
@@ -12,20 +12,25 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class TransactionRollbackOKFrame : public TransactionFrame
+class TransactionRollbackOKFrame : public MethodCodec<TransactionRollbackOKFrame, TransactionFrame>
 {
 protected:
     /**
-     *  Encode a frame on a string buffer
-     *
-     *  @param  buffer  buffer to write frame to
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
      */
-    virtual void fill(OutBuffer& buffer) const override
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
     {
-        // call base
-        TransactionFrame::fill(buffer);
+        visitor();
     }
 
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Decode a transaction rollback ok frame from a received frame
@@ -33,7 +38,7 @@ public:
      *  @param   frame   received frame to decode
      */
     TransactionRollbackOKFrame(ReceivedFrame& frame) :
-        TransactionFrame(frame)
+        Codec(frame)
     {}
 
     /**
@@ -43,8 +48,11 @@ public:
      *  @return  newly created transaction rollback ok frame
      */
     TransactionRollbackOKFrame(uint16_t channel) :
-        TransactionFrame(channel, 0)
-    {}
+        Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
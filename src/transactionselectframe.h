@@ -12,8 +12,25 @@ namespace AMQP {
 /**
  *  Class implementation
  */
-class TransactionSelectFrame : public TransactionFrame
+class TransactionSelectFrame : public MethodCodec<TransactionSelectFrame, TransactionFrame>
 {
+protected:
+    /**
+     *  The fields of the frame, in the order in which they are encoded
+     *  @param  self        the frame
+     *  @param  visitor     object that is called with the fields
+     */
+    template <typename Self, typename Visitor>
+    static void fields(Self &self, Visitor &visitor)
+    {
+        visitor();
+    }
+
+    /**
+     *  The codec needs access to the fields
+     */
+    friend Codec;
+
 public:
     /**
      *  Decode a transaction select frame from a received frame
@@ -21,7 +38,7 @@ public:
      *  @param   frame   received frame to decode
      */
     TransactionSelectFrame(ReceivedFrame& frame) :
-        TransactionFrame(frame)
+        Codec(frame)
     {}
 
     /**
@@ -31,8 +48,11 @@ public:
      *  @return  newly created transaction select frame
      */
     TransactionSelectFrame(uint16_t channel) :
-        TransactionFrame(channel, 0)
-    {}
+        Codec(channel)
+    {
+        // calculate the size
+        measure();
+    }
 
     /**
      *  Destructor
@@ -0,0 +1,299 @@
+/**
+ *  MethodCodec.cpp
+ *
+ *  Test program that checks that the method frames are encoded exactly
+ *  like the hand-written frames that they replaced (the expected data was
+ *  produced by the old implementation), and that they can be decoded again
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Dependencies
+ */
+#include <amqpcpp.h>
+#include "includes.h"
+#include "confirmselectframe.h"
+#include "confirmselectokframe.h"
+#include "connectionstartokframe.h"
+#include "connectionstartframe.h"
+#include "connectionsecureframe.h"
+#include "connectionsecureokframe.h"
+#include "connectionopenokframe.h"
+#include "connectionopenframe.h"
+#include "connectiontuneokframe.h"
+#include "connectiontuneframe.h"
+#include "connectioncloseokframe.h"
+#include "connectioncloseframe.h"
+#include "connectionblockedframe.h"
+#include "connectionunblockedframe.h"
+#include "channelopenframe.h"
+#include "channelopenokframe.h"
+#include "channelflowokframe.h"
+#include "channelflowframe.h"
+#include "channelcloseokframe.h"
+#include "channelcloseframe.h"
+#include "exchangedeclareframe.h"
+#include "exchangedeclareokframe.h"
+#include "exchangedeleteframe.h"
+#include "exchangedeleteokframe.h"
+#include "exchangebindframe.h"
+#include "exchangebindokframe.h"
+#include "exchangeunbindframe.h"
+#include "exchangeunbindokframe.h"
+#include "queuedeclareframe.h"
+#include "queuedeclareokframe.h"
+#include "queuebindframe.h"
+#include "queuebindokframe.h"
+#include "queuepurgeframe.h"
+#include "queuepurgeokframe.h"
+#include "queuedeleteframe.h"
+#include "queuedeleteokframe.h"
+#include "queueunbindframe.h"
+#include "queueunbindokframe.h"
+#include "basicqosframe.h"
+#include "basicqosokframe.h"
+#include "basicconsumeframe.h"
+#include "basicconsumeokframe.h"
+#include "basiccancelframe.h"
+#include "basiccancelokframe.h"
+#include "basicpublishframe.h"
+#include "basicreturnframe.h"
+#include "basicdeliverframe.h"
+#include "basicgetframe.h"
+#include "basicgetokframe.h"
+#include "basicgetemptyframe.h"
+#include "basicackframe.h"
+#include "basicnackframe.h"
+#include "basicrejectframe.h"
+#include "basicrecoverasyncframe.h"
+#include "basicrecoverframe.h"
+#include "basicrecoverokframe.h"
+#include "transactionselectframe.h"
+#include "transactionselectokframe.h"
+#include "transactioncommitframe.h"
+#include "transactioncommitokframe.h"
+#include "transactionrollbackframe.h"
+#include "transactionrollbackokframe.h"
+#include <iostream>
+
+/**
+ *  Number of failed checks
+ *  @var int
+ */
+static int failures = 0;
+
+/**
+ *  Convert data to a hex string
+ *  @param  data
+ *  @param  size
+ *  @return std::string
+ */
+static std::string hex(const char *data, size_t size)
+{
+    // the result
+    std::string result;
+
+    // convert byte by byte
+    for (size_t i = 0; i < size; ++i)
+    {
+        // the digits
+        static const char *digits = "0123456789abcdef";
+
+        // add the two digits
+        result.push_back(digits[(uint8_t)data[i] >> 4]);
+        result.push_back(digits[(uint8_t)data[i] & 15]);
+    }
+
+    // done
+    return result;
+}
+
+/**
+ *  Check a frame
+ *  @param  frame       the frame to check
+ *  @param  expected    the expected encoding (in hex)
+ */
+template <typename Frame>
+static void check(const Frame &frame, const std::string &expected)
+{
+    // encode the frame
+    AMQP::CopiedBuffer buffer(frame);
+
+    // the data that was encoded
+    std::string encoded = hex(buffer.data(), buffer.size());
+
+    // the frame should report its size correctly, and be encoded as before
+    if (frame.totalSize() != buffer.size()) { failures++; std::cerr << expected << ": size " << frame.totalSize() << " instead of " << buffer.size() << std::endl; }
+    if (frame.payloadSize() + 8 != buffer.size()) { failures++; std::cerr << expected << ": payload size " << frame.payloadSize() << " instead of " << buffer.size() - 8 << std::endl; }
+    if (encoded != expected) { failures++; std::cerr << expected << ": encoded as " << encoded << std::endl; }
+
+    // parse the encoded frame (the frame itself reads the fields after the class and method id)
+    AMQP::ReceivedFrame received(buffer.data(), buffer.size(), buffer.size());
+    received.nextUint16();
+    received.nextUint16();
+
+    // decode it
+    Frame decoded(received);
+
+    // the decoded frame should have consumed the entire payload, so nothing can be read anymore
+    try { received.nextUint8(); failures++; std::cerr << expected << ": not all data was decoded" << std::endl; } catch (const AMQP::ProtocolException &) {}
+
+    // and it should be encoded the same
+    AMQP::CopiedBuffer copy(decoded);
+
+    // check the copy
+    if (hex(copy.data(), copy.size()) != expected) { failures++; std::cerr << expected << ": decoded frame is encoded as " << hex(copy.data(), copy.size()) << std::endl; }
+}
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // a table for the frames that hold arguments or properties
+    AMQP::Table t;
+    t["a"] = 1;
+    t["b"] = "str";
+
+    // a consumer tag
+    std::string tag("ctag");
+
+    // check all method frames
+    check(AMQP::BasicAckFrame(1, 0x0102030405060708ULL, true),
+          "0100010000000d003c0050010203040506070801ce");
+    check(AMQP::BasicCancelFrame(1, "ctag", true),
+          "0100010000000a003c001e046374616701ce");
+    check(AMQP::BasicCancelOKFrame(1, tag),
+          "01000100000009003c001f0463746167ce");
+    check(AMQP::BasicConsumeFrame(1, "q", "ctag", true, false, true, false, t),
+          "01000100000023003c001400000171046374616705000000110161490000000101625300000003737472ce");
+    check(AMQP::BasicConsumeOKFrame(1, "ctag"),
+          "01000100000009003c00150463746167ce");
+    check(AMQP::BasicDeliverFrame(1, "ctag", 42, true, "x", "rk"),
+          "01000100000017003c003c0463746167000000000000002a01017802726bce");
+    check(AMQP::BasicGetEmptyFrame(1),
+          "01000100000005003c004800ce");
+    check(AMQP::BasicGetFrame(1, "q", true),
+          "01000100000009003c00460000017101ce");
+    check(AMQP::BasicGetOKFrame(1, 42, false, "x", "rk", 7),
+          "01000100000016003c0047000000000000002a00017802726b00000007ce");
+    check(AMQP::BasicNackFrame(1, 42, true, false),
+          "0100010000000d003c0078000000000000002a01ce");
+    check(AMQP::BasicPublishFrame(1, "x", "rk", true, false),
+          "0100010000000c003c00280000017802726b01ce");
+    check(AMQP::BasicQosFrame(1, 100, true),
+          "0100010000000b003c000a00000000006401ce");
+    check(AMQP::BasicQosOKFrame(1),
+          "01000100000004003c000bce");
+    check(AMQP::BasicRecoverAsyncFrame(1, true),
+          "01000100000005003c006401ce");
+    check(AMQP::BasicRecoverFrame(1, true),
+          "01000100000005003c006e01ce");
+    check(AMQP::BasicRecoverOKFrame(1),
+          "01000100000004003c006fce");
+    check(AMQP::BasicRejectFrame(1, 42, false),
+          "0100010000000d003c005a000000000000002a00ce");
+    check(AMQP::BasicReturnFrame(1, 312, "NO_ROUTE", "x", "rk"),
+          "01000100000014003c00320138084e4f5f524f555445017802726bce");
+    check(AMQP::BasicQosOKFrame(2),
+          "01000200000004003c000bce");
+    check(AMQP::BasicRecoverOKFrame(2),
+          "01000200000004003c006fce");
+    check(AMQP::ChannelCloseFrame(3, 404, "not found", 50, 10),
+          "01000300000014001400280194096e6f7420666f756e640032000ace");
+    check(AMQP::ChannelCloseOKFrame(3),
+          "0100030000000400140029ce");
+    check(AMQP::ChannelFlowFrame(3, true),
+          "010003000000050014001401ce");
+    check(AMQP::ChannelFlowOKFrame(3, false),
+          "010003000000050014001500ce");
+    check(AMQP::ChannelOpenFrame(4),
+          "010004000000050014000a00ce");
+    check(AMQP::ChannelOpenOKFrame(4),
+          "010004000000080014000b00000000ce");
+    check(AMQP::ConfirmSelectFrame(5, true),
+          "010005000000050055000a01ce");
+    check(AMQP::ConfirmSelectOKFrame(5),
+          "010005000000040055000bce");
+    check(AMQP::ConnectionBlockedFrame("low mem"),
+          "0100000000000c000a003c076c6f77206d656dce");
+    check(AMQP::ConnectionUnblockedFrame(),
+          "01000000000004000a003dce");
+    check(AMQP::ConnectionCloseFrame(320, "bye", 1, 2),
+          "0100000000000e000a003201400362796500010002ce");
+    check(AMQP::ConnectionCloseOKFrame(),
+          "01000000000004000a0033ce");
+    check(AMQP::ConnectionOpenFrame("/vh"),
+          "0100000000000a000a0028032f76680000ce");
+    check(AMQP::ConnectionOpenOKFrame(),
+          "01000000000005000a002900ce");
+    check(AMQP::ConnectionSecureFrame("chal"),
+          "0100000000000c000a0014000000046368616cce");
+    check(AMQP::ConnectionSecureOKFrame("resp"),
+          "0100000000000c000a00150000000472657370ce");
+    check(AMQP::ConnectionStartFrame(0, 9, t, "PLAIN", "en_US"),
+          "0100000000002d000a000a000900000011016149000000010162530000000373747200000005504c41494e00000005656e5f5553ce");
+    check(AMQP::ConnectionStartOKFrame(t, "PLAIN", "resp", "en_US"),
+          "0100000000002d000a000b00000011016149000000010162530000000373747205504c41494e000000047265737005656e5f5553ce");
+    check(AMQP::ConnectionTuneFrame(10, 131072, 60),
+          "0100000000000c000a001e000a00020000003cce");
+    check(AMQP::ConnectionTuneOKFrame(10, 131072, 60),
+          "0100000000000c000a001f000a00020000003cce");
+    check(AMQP::ExchangeBindFrame(1, "d", "s", "rk", true, t),
+          "010001000000230028001e00000164017302726b01000000110161490000000101625300000003737472ce");
+    check(AMQP::ExchangeBindOKFrame(1),
+          "010001000000040028001fce");
+    check(AMQP::ExchangeDeclareFrame(1, "x", "topic", false, true, false, true, false, t),
+          "010001000000240028000a0000017805746f7069630a000000110161490000000101625300000003737472ce");
+    check(AMQP::ExchangeDeclareOKFrame(1),
+          "010001000000040028000bce");
+    check(AMQP::ExchangeDeleteFrame(1, "x", true, false),
+          "01000100000009002800140000017801ce");
+    check(AMQP::ExchangeDeleteOKFrame(1),
+          "0100010000000400280015ce");
+    check(AMQP::ExchangeUnbindFrame(1, "d", "s", "rk", false, t),
+          "010001000000230028002800000164017302726b00000000110161490000000101625300000003737472ce");
+    check(AMQP::ExchangeUnbindOKFrame(1),
+          "0100010000000400280033ce");
+    check(AMQP::QueueBindFrame(1, "q", "x", "rk", true, t),
+          "010001000000230032001400000171017802726b01000000110161490000000101625300000003737472ce");
+    check(AMQP::QueueBindOKFrame(1),
+          "0100010000000400320015ce");
+    check(AMQP::QueueDeclareFrame(1, "q", false, true, false, true, false, t),
+          "0100010000001e0032000a000001710a000000110161490000000101625300000003737472ce");
+    check(AMQP::QueueDeclareOKFrame(1, "q", 7, 8),
+          "0100010000000e0032000b01710000000700000008ce");
+    check(AMQP::QueueDeleteFrame(1, "q", true, false, true),
+          "01000100000009003200280000017105ce");
+    check(AMQP::QueueDeleteOKFrame(1, 9),
+          "010001000000080032002900000009ce");
+    check(AMQP::QueuePurgeFrame(1, "q", true),
+          "010001000000090032001e0000017101ce");
+    check(AMQP::QueuePurgeOKFrame(1, 9),
+          "010001000000080032001f00000009ce");
+    check(AMQP::QueueUnbindFrame(1, "q", "x", "rk", t),
+          "010001000000220032003200000171017802726b000000110161490000000101625300000003737472ce");
+    check(AMQP::QueueUnbindOKFrame(1),
+          "0100010000000400320033ce");
+    check(AMQP::TransactionCommitFrame(1),
+          "01000100000004005a0014ce");
+    check(AMQP::TransactionCommitOKFrame(1),
+          "01000100000004005a0015ce");
+    check(AMQP::TransactionRollbackFrame(1),
+          "01000100000004005a001ece");
+    check(AMQP::TransactionRollbackOKFrame(1),
+          "01000100000004005a001fce");
+    check(AMQP::TransactionSelectFrame(1),
+          "01000100000004005a000ace");
+    check(AMQP::TransactionSelectOKFrame(1),
+          "01000100000004005a000bce");
+
+    // report the result
+    std::cout << (failures ? "FAILED" : "OK") << std::endl;
+
+    // done
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,382 @@
+/**
+ *  FieldView.cpp
+ *
+ *  Test program for the FieldView and TableEncoder classes: tables with
+ *  all field types are encoded, and then processed with a FieldView and
+ *  decoded into a Table again. Malformed and truncated data should be
+ *  rejected.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Dependencies
+ */
+#include <amqpcpp.h>
+#include <iostream>
+#include <vector>
+#include <set>
+
+/**
+ *  Number of failed checks
+ *  @var int
+ */
+static int failures = 0;
+
+/**
+ *  Check a condition
+ *  @param  condition   the condition that should be true
+ *  @param  description description of the check
+ */
+static void check(bool condition, const std::string &description)
+{
+    // nothing to do if the check succeeded
+    if (condition) return;
+
+    // report the failure
+    std::cerr << "failed: " << description << std::endl;
+
+    // count it
+    failures++;
+}
+
+/**
+ *  Check whether processing encoded fields throws
+ *  @param  callback    function that processes the fields
+ *  @return bool
+ */
+static bool throws(const std::function<void()> &callback)
+{
+    // call the function
+    try { callback(); return false; } catch (const AMQP::ProtocolException &) { return true; }
+}
+
+/**
+ *  Process all fields of an encoded table, including the nested fields
+ *  @param  data        the encoded table
+ */
+static void process(const AMQP::StringView &data)
+{
+    // function that processes a field recursively
+    std::function<void(const AMQP::StringView &, const AMQP::FieldView &)> callback = [&callback](const AMQP::StringView &, const AMQP::FieldView &value) {
+
+        // descend into the nested tables and arrays
+        value.visit(callback);
+    };
+
+    // process the table
+    AMQP::FieldView::table(data, callback);
+}
+
+/**
+ *  Build encoded data
+ *  @param  data        the data
+ *  @param  size        size of the data
+ *  @return std::string
+ */
+static std::string bytes(const char *data, size_t size)
+{
+    return std::string(data, size);
+}
+
+/**
+ *  Test a table with all field types
+ */
+static void testTypes()
+{
+    // a table that is nested in an array
+    AMQP::Table inner;
+    inner.set("k", "v");
+
+    // an array with different types
+    AMQP::Array array;
+    array.push_back(AMQP::LongString("x"));
+    array.push_back(AMQP::Long(7));
+    array.push_back(inner);
+
+    // a nested table that holds an array
+    AMQP::Array numbers;
+    numbers.push_back(AMQP::UOctet(1));
+    numbers.push_back(AMQP::UOctet(2));
+    AMQP::Table nested;
+    nested.set("n", AMQP::Long(1));
+    nested.set("numbers", numbers);
+
+    // a table with all field types
+    AMQP::Table table;
+    table.set("t", AMQP::BooleanSet(true));
+    table.set("b", AMQP::Octet(-5));
+    table.set("B", AMQP::UOctet(200));
+    table.set("U", AMQP::Short(-1000));
+    table.set("u", AMQP::UShort(60000));
+    table.set("I", AMQP::Long(-100000));
+    table.set("i", AMQP::ULong(4000000000u));
+    table.set("L", AMQP::LongLong(-5000000000000ll));
+    table.set("l", AMQP::ULongLong(1ull << 40));
+    table.set("f", AMQP::Float(1.5f));
+    table.set("d", AMQP::Double(-2.25));
+    table.set("D", AMQP::DecimalField(2, 12345));
+    table.set("s", AMQP::ShortString("short"));
+    table.set("S", AMQP::LongString("long"));
+    table.set("T", AMQP::Timestamp(1600000000));
+    table.set("A", array);
+    table.set("F", nested);
+
+    // encode the table
+    AMQP::TableEncoder encoder(table);
+    AMQP::StringView data(encoder.data());
+
+    // the encoded table should be well-formed
+    check(!throws([&data]() { AMQP::FieldView::validate(data); }), "a valid table passes validation");
+
+    // the names of the fields that were seen
+    std::set<std::string> names;
+
+    // process the fields
+    AMQP::FieldView::table(data, [&names](const AMQP::StringView &name, const AMQP::FieldView &value) {
+
+        // the name of the field
+        std::string key(name.data(), name.size());
+
+        // remember the name
+        names.insert(key);
+
+        // the type id should be the same as the name that we used
+        check(key.size() == 1 && value.typeID() == key[0], "type of field " + key);
+
+        // check the values
+        switch (value.typeID()) {
+        case 't':   check(value.integer() == 1, "value of t"); break;
+        case 'b':   check(value.integer() == -5, "value of b"); break;
+        case 'B':   check(value.integer() == 200, "value of B"); break;
+        case 'U':   check(value.integer() == -1000, "value of U"); break;
+        case 'u':   check(value.integer() == 60000, "value of u"); break;
+        case 'I':   check(value.integer() == -100000, "value of I"); break;
+        case 'i':   check(value.integer() == 4000000000ll, "value of i"); break;
+        case 'L':   check(value.integer() == -5000000000000ll, "value of L"); break;
+        case 'l':   check(value.integer() == (1ll << 40), "value of l"); break;
+        case 'f':   check(value.isDecimal() && value.number() == 1.5, "value of f"); break;
+        case 'd':   check(value.isDecimal() && value.number() == -2.25, "value of d"); break;
+        case 'D':   check(value.raw() == AMQP::StringView(bytes("\x02\x00\x00\x30\x39", 5)), "value of D"); break;
+        case 's':   check(value.isString() && value.string() == AMQP::StringView("short"), "value of s"); break;
+        case 'S':   check(value.isString() && value.string() == AMQP::StringView("long"), "value of S"); break;
+        case 'T':   check(value.integer() == 1600000000, "value of T"); break;
+        case 'A':
+        {
+            // the types of the elements
+            std::string types;
+
+            // process the array (elements have no name)
+            value.visit([&types](const AMQP::StringView &name, const AMQP::FieldView &element) {
+
+                // elements of arrays have no names
+                check(name.size() == 0, "array elements have no name");
+
+                // remember the type
+                types.push_back(element.typeID());
+
+                // check the values
+                if (element.typeID() == 'S') check(element.string() == AMQP::StringView("x"), "string in array");
+                if (element.typeID() == 'I') check(element.integer() == 7, "number in array");
+
+                // check the table in the array
+                if (element.typeID() == 'F') element.visit([](const AMQP::StringView &name, const AMQP::FieldView &field) {
+                    check(name == AMQP::StringView("k") && field.string() == AMQP::StringView("v"), "table in array");
+                });
+            });
+
+            // all elements should have been seen, in order
+            check(types == "SIF", "elements of the array");
+            break;
+        }
+        case 'F':
+        {
+            // the number of fields in the nested table
+            int count = 0;
+
+            // process the nested table
+            value.visit([&count](const AMQP::StringView &name, const AMQP::FieldView &field) {
+
+                // one more field
+                count++;
+
+                // check the fields
+                if (name == AMQP::StringView("n")) check(field.integer() == 1, "number in nested table");
+                else check(name == AMQP::StringView("numbers") && field.isArray(), "array in nested table");
+
+                // the array holds two numbers
+                int sum = 0;
+                field.visit([&sum](const AMQP::StringView &, const AMQP::FieldView &element) { sum += (int)element.integer(); });
+
+                // check the numbers
+                if (field.isArray()) check(sum == 3, "array in nested table");
+            });
+
+            // all fields should have been seen
+            check(count == 2, "fields of the nested table");
+            break;
+        }
+        }
+    });
+
+    // all fields should have been seen
+    check(names.size() == 17, "all fields are processed");
+
+    // decode the fields into a table
+    AMQP::ReceivedFrame frame(data.data(), data.size());
+    AMQP::Table decoded(frame, (uint32_t)data.size());
+
+    // the decoded table should be encoded exactly the same
+    check(AMQP::TableEncoder(decoded).data() == encoder.data(), "decoded table is encoded the same");
+}
+
+/**
+ *  Test the types of the fields that are added to a TableEncoder
+ */
+static void testEncoder()
+{
+    // an encoder with all overloads
+    AMQP::TableEncoder encoder;
+    encoder.add("a", std::string("string"))
+           .add("b", "chars")
+           .add("c", true)
+           .add("d", (int8_t)-1)
+           .add("e", (uint8_t)255)
+           .add("f", (int16_t)-2)
+           .add("g", (uint16_t)65535)
+           .add("h", (int32_t)-3)
+           .add("i", (uint32_t)4294967295u)
+           .add("j", (int64_t)-4)
+           .add("k", (uint64_t)5)
+           .add("l", 0.5f)
+           .add("m", 0.25)
+           .add("n", AMQP::Timestamp(6));
+
+    // the expected types and values
+    std::string types;
+    std::vector<double> values;
+
+    // the fields should be encoded in the order in which they were added
+    AMQP::FieldView::table(encoder.data(), [&types, &values](const AMQP::StringView &name, const AMQP::FieldView &value) {
+
+        // remember the type and the value
+        types.push_back(value.typeID());
+        values.push_back(value.number());
+
+        // the strings
+        if (name == AMQP::StringView("a")) check(value.string() == AMQP::StringView("string"), "string value");
+        if (name == AMQP::StringView("b")) check(value.string() == AMQP::StringView("chars"), "string value");
+    });
+
+    // check the types
+    check(types == "SStbBUuIiLlfdT", "types of the added fields");
+
+    // check the values
+    check(values == std::vector<double>({ 0, 0, 1, -1, 255, -2, 65535, -3, 4294967295.0, -4, 5, 0.5, 0.25, 6 }), "values of the added fields");
+
+    // the encoder can be cleared
+    encoder.clear();
+    check(encoder.empty(), "cleared encoder is empty");
+}
+
+/**
+ *  Test data that is truncated
+ */
+static void testTruncated()
+{
+    // a nested table and an array
+    AMQP::Table nested;
+    nested.set("x", AMQP::LongString("nested"));
+    AMQP::Array array;
+    array.push_back(AMQP::Long(1));
+    array.push_back(nested);
+
+    // build an encoded table
+    AMQP::TableEncoder encoder;
+    encoder.add("number", (int32_t)42).add("string", "value").add("array", array).add("table", nested);
+
+    // the encoded data
+    const std::string &data = encoder.data();
+
+    // the positions where a field ends
+    std::set<size_t> ends = { 0 };
+
+    // find the ends of the fields
+    AMQP::FieldView::table(data, [&data, &ends](const AMQP::StringView &name, const AMQP::FieldView &value) {
+        ends.insert(value.raw().data() + value.raw().size() - data.data());
+    });
+
+    // all data should have been processed
+    check(*ends.rbegin() == data.size(), "ends of the fields");
+
+    // check all truncated versions
+    for (size_t size = 0; size < data.size(); ++size)
+    {
+        // the truncated data
+        AMQP::StringView truncated(data.data(), size);
+
+        // when the data ends between two fields, it is a valid (but smaller) table
+        bool valid = ends.count(size) > 0;
+
+        // check both the validation and the processing
+        check(throws([&truncated]() { AMQP::FieldView::validate(truncated); }) != valid, "validation of truncated data of size " + std::to_string(size));
+        check(throws([&truncated]() { process(truncated); }) != valid, "processing of truncated data of size " + std::to_string(size));
+    }
+}
+
+/**
+ *  Test malformed data
+ */
+static void testMalformed()
+{
+    // an unknown type
+    std::string unknown = bytes("\x01" "a" "X", 3);
+    check(throws([&unknown]() { AMQP::FieldView::validate(unknown); }), "unknown type is rejected");
+    check(throws([&unknown]() { process(unknown); }), "unknown type is not processed");
+
+    // a name that is longer than the data
+    std::string name = bytes("\x10" "ab", 3);
+    check(throws([&name]() { AMQP::FieldView::validate(name); }), "long name is rejected");
+
+    // a nested table with a size that is too big
+    std::string size = bytes("\x01" "a" "F" "\x00\x00\x00\x64" "\x01" "b" "t" "\x01", 11);
+    check(throws([&size]() { AMQP::FieldView::validate(size); }), "nested table that is too big is rejected");
+
+    // a nested table with an unknown type (the outer table looks fine, until we descend into it)
+    std::string nested = bytes("\x01" "a" "F" "\x00\x00\x00\x03" "\x01" "b" "X", 10);
+    check(!throws([&nested]() { AMQP::FieldView::table(nested, [](const AMQP::StringView &, const AMQP::FieldView &) {}); }), "outer table of invalid nested table is processed");
+    check(throws([&nested]() { AMQP::FieldView::validate(nested); }), "invalid nested table is rejected");
+    check(throws([&nested]() { process(nested); }), "invalid nested table is not processed");
+
+    // an array with an element that is cut off
+    std::string array = bytes("\x01" "a" "A" "\x00\x00\x00\x02" "I" "\x00", 9);
+    check(throws([&array]() { AMQP::FieldView::validate(array); }), "truncated array element is rejected");
+
+    // an invalid table in a table in an array
+    std::string deep = bytes("\x01" "a" "A" "\x00\x00\x00\x0b" "F" "\x00\x00\x00\x06" "\x01" "b" "F" "\x00\x00\x00", 18);
+    check(throws([&deep]() { AMQP::FieldView::validate(deep); }), "deeply nested error is rejected");
+
+    // the same data, but valid
+    std::string valid = bytes("\x01" "a" "A" "\x00\x00\x00\x0c" "F" "\x00\x00\x00\x07" "\x01" "b" "F" "\x00\x00\x00\x00", 19);
+    check(!throws([&valid]() { AMQP::FieldView::validate(valid); }), "deeply nested table is valid");
+}
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // run the tests
+    testTypes();
+    testEncoder();
+    testTruncated();
+    testMalformed();
+
+    // report the result
+    std::cout << (failures ? "FAILED" : "OK") << std::endl;
+
+    // done
+    return failures ? 1 : 0;
+}
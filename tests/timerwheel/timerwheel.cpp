@@ -0,0 +1,290 @@
+/**
+ *  TimerWheel.cpp
+ *
+ *  Test program for the TimerWheel class: timers should expire at their
+ *  deadline (never earlier), and timers should be able to schedule, cancel
+ *  and destruct timers from within their onExpired() method.
+ *
+ *  @author Emiel Bruijntjes <emiel.bruijntjes@copernica.com>
+ *  @copyright 2020 Copernica BV
+ */
+
+/**
+ *  Dependencies
+ */
+#include <amqpcpp/timerwheel.h>
+#include <functional>
+#include <iostream>
+#include <memory>
+
+/**
+ *  Number of failed checks
+ *  @var int
+ */
+static int failures = 0;
+
+/**
+ *  Check a condition
+ *  @param  condition   the condition that should be true
+ *  @param  description description of the check
+ */
+static void check(bool condition, const std::string &description)
+{
+    // nothing to do if the check succeeded
+    if (condition) return;
+
+    // report the failure
+    std::cerr << "failed: " << description << std::endl;
+
+    // count it
+    failures++;
+}
+
+/**
+ *  Timer that counts how often it expired
+ */
+class Counter : public AMQP::TimerWheel::Timer
+{
+public:
+    /**
+     *  Number of times that the timer expired
+     *  @var int
+     */
+    int expired = 0;
+
+    /**
+     *  Optional action to run when the timer expires
+     *  @var std::function
+     */
+    std::function<void()> action;
+
+    /**
+     *  Method that is called when the timer expires
+     */
+    virtual void onExpired() override
+    {
+        // count it
+        expired++;
+
+        // run the action
+        if (action) action();
+    }
+};
+
+/**
+ *  Test that timers expire at the right time
+ */
+static void testDeadlines()
+{
+    // wheel with one second per tick
+    AMQP::TimerWheel wheel(100.0);
+    Counter a, b, c;
+
+    // a deadline on a tick, a deadline between ticks, and a deadline in the past
+    wheel.schedule(&a, 105.0);
+    wheel.schedule(&b, 105.2);
+    wheel.schedule(&c, 50.0);
+    check(wheel.size() == 3 && a.scheduled() && b.scheduled() && c.scheduled(), "timers are scheduled");
+
+    // the current tick was already processed, so nothing expires
+    wheel.advance(100.9);
+    check(c.expired == 0, "timer in the past does not expire in the current tick");
+
+    // the timer in the past expires on the next tick
+    wheel.advance(101.0);
+    check(c.expired == 1 && !c.scheduled() && wheel.size() == 2, "timer in the past expires on the next tick");
+
+    // timers do not expire early
+    wheel.advance(104.9);
+    check(a.expired == 0 && b.expired == 0, "timers do not expire early");
+
+    // the first timer expires on its tick, the second is rounded up
+    wheel.advance(105.0);
+    check(a.expired == 1 && b.expired == 0, "timer expires on its tick");
+    wheel.advance(105.9);
+    check(b.expired == 0, "deadline between ticks is rounded up");
+    wheel.advance(106.0);
+    check(b.expired == 1 && wheel.empty(), "deadline between ticks expires on the next tick");
+
+    // moving back in time does nothing
+    wheel.schedule(&a, 110.0);
+    wheel.advance(50.0);
+    check(a.expired == 1 && a.scheduled(), "moving back in time does nothing");
+
+    // a wheel with a smaller interval
+    AMQP::TimerWheel small(0.0, 0.5);
+    small.schedule(&c, 1.2);
+    small.advance(1.4);
+    check(c.expired == 1, "deadline is rounded up to half a second");
+    small.advance(1.5);
+    check(c.expired == 2, "timer expires after half a second");
+}
+
+/**
+ *  Test deadlines that are more than one revolution away
+ */
+static void testRevolutions()
+{
+    // wheel with one second per tick (the wheel has 256 slots)
+    AMQP::TimerWheel wheel(0.0);
+    Counter a, b, c;
+
+    // a timer that is in the same slot as the current tick, one that is more
+    // than a revolution away, and one that is many revolutions away
+    wheel.schedule(&a, 256.0);
+    wheel.schedule(&b, 300.0);
+    wheel.schedule(&c, 5000.0);
+
+    // passing the slots of the timers in the first revolution does not expire them
+    wheel.advance(255.0);
+    check(a.expired == 0 && b.expired == 0 && c.expired == 0, "timers do not expire in an earlier revolution");
+
+    // the timers expire in their own revolution
+    wheel.advance(256.0);
+    check(a.expired == 1 && b.expired == 0, "timer expires after one revolution");
+    wheel.advance(299.0);
+    check(b.expired == 0, "timer does not expire before its tick");
+    wheel.advance(300.0);
+    check(b.expired == 1 && c.expired == 0, "timer expires in the second revolution");
+
+    // skipping many revolutions at once
+    wheel.advance(10000.0);
+    check(c.expired == 1 && wheel.empty(), "timer expires when many revolutions are skipped");
+}
+
+/**
+ *  Test rescheduling and cancelling
+ */
+static void testCancel()
+{
+    // wheel with one second per tick
+    AMQP::TimerWheel wheel(100.0);
+    Counter a, b;
+
+    // scheduling a timer that is already scheduled moves it
+    wheel.schedule(&a, 110.0);
+    wheel.schedule(&a, 120.0);
+    check(wheel.size() == 1, "rescheduled timer is scheduled once");
+    wheel.advance(115.0);
+    check(a.expired == 0, "rescheduled timer does not expire at its old deadline");
+    wheel.advance(120.0);
+    check(a.expired == 1, "rescheduled timer expires at its new deadline");
+
+    // cancelled timers do not expire
+    wheel.schedule(&b, 130.0);
+    wheel.cancel(&b);
+    wheel.cancel(&b);
+    check(!b.scheduled() && wheel.empty(), "cancelled timer is no longer scheduled");
+    wheel.advance(140.0);
+    check(b.expired == 0, "cancelled timer does not expire");
+
+    // a timer cannot be cancelled on another wheel
+    AMQP::TimerWheel other(100.0);
+    wheel.schedule(&b, 150.0);
+    other.cancel(&b);
+    check(b.scheduled() && wheel.size() == 1 && other.empty(), "timer is not cancelled on another wheel");
+
+    // destructing a timer removes it from the wheel
+    {
+        // a timer that only exists in this scope
+        Counter c;
+        wheel.schedule(&c, 150.0);
+        check(wheel.size() == 2, "timer is added to the wheel");
+    }
+
+    // the timer is gone
+    check(wheel.size() == 1, "destructed timer is removed from the wheel");
+    wheel.advance(150.0);
+    check(b.expired == 1 && wheel.empty(), "other timer still expires");
+
+    // destructing the wheel unschedules the timers
+    {
+        // a wheel that only exists in this scope
+        AMQP::TimerWheel temporary(0.0);
+        temporary.schedule(&a, 10.0);
+        temporary.schedule(&b, 1000.0);
+    }
+
+    // the timers are no longer scheduled
+    check(!a.scheduled() && !b.scheduled(), "timers are unscheduled when the wheel is destructed");
+}
+
+/**
+ *  Test timers that change the wheel while it is being advanced
+ */
+static void testAdvance()
+{
+    // wheel with one second per tick
+    AMQP::TimerWheel wheel(100.0);
+
+    // two timers that cancel each other
+    Counter a, b;
+    a.action = [&wheel, &b]() { wheel.cancel(&b); };
+    b.action = [&wheel, &a]() { wheel.cancel(&a); };
+    wheel.schedule(&a, 110.0);
+    wheel.schedule(&b, 110.0);
+
+    // only one of them expires
+    wheel.advance(110.0);
+    check(a.expired + b.expired == 1 && wheel.empty(), "timer that is cancelled during advance does not expire");
+
+    // two timers that destruct each other
+    std::unique_ptr<Counter> c(new Counter), d(new Counter);
+    int expired = 0;
+    c->action = [&d, &expired]() { expired++; d.reset(); };
+    d->action = [&c, &expired]() { expired++; c.reset(); };
+    wheel.schedule(c.get(), 120.0);
+    wheel.schedule(d.get(), 120.0);
+
+    // only one of them expires
+    wheel.advance(120.0);
+    check(expired == 1 && wheel.empty() && (!c || !d), "timer that is destructed during advance does not expire");
+
+    // a timer that reschedules itself (even with a deadline in the past)
+    Counter e;
+    e.action = [&wheel, &e]() { wheel.schedule(&e, 0.0); };
+    wheel.schedule(&e, 130.0);
+
+    // it expires once per advance, even when many ticks are passed
+    wheel.advance(200.0);
+    check(e.expired == 1 && e.scheduled(), "timer that reschedules itself expires once");
+    wheel.advance(201.0);
+    check(e.expired == 2 && e.scheduled(), "timer that reschedules itself expires again");
+    wheel.cancel(&e);
+
+    // a timer that schedules another timer that has already expired
+    Counter f, g;
+    f.action = [&wheel, &g]() { wheel.schedule(&g, 300.0); };
+    wheel.schedule(&f, 210.0);
+    wheel.schedule(&g, 210.0);
+    wheel.advance(210.0);
+    check(f.expired == 1 && g.scheduled(), "timer that is rescheduled during advance is scheduled");
+
+    // the number of times it expired so far (it may have been notified before the other timer)
+    int before = g.expired;
+
+    // it expires at its new deadline
+    wheel.advance(299.0);
+    check(g.expired == before && g.scheduled(), "rescheduled timer does not expire early");
+    wheel.advance(300.0);
+    check(g.expired == before + 1 && wheel.empty(), "rescheduled timer expires at its new deadline");
+}
+
+/**
+ *  Main procedure
+ *  @return int
+ */
+int main()
+{
+    // run the tests
+    testDeadlines();
+    testRevolutions();
+    testCancel();
+    testAdvance();
+
+    // report the result
+    std::cout << (failures ? "FAILED" : "OK") << std::endl;
+
+    // done
+    return failures ? 1 : 0;
+}